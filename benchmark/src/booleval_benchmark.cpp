@@ -27,9 +27,15 @@
  *
  */
 
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <benchmark/benchmark.h>
 #include <booleval/evaluator.hpp>
 
+#include "allocation_counter.hpp"
+
 namespace
 {
 
@@ -53,6 +59,16 @@ namespace
         U value_2_{};
     };
 
+    /**
+     * Reports the allocations made within the benchmark loop, per iteration.
+     */
+    void count_allocations( benchmark::State & state, booleval::testing::allocation_scope const & scope )
+    {
+        auto const stats{ scope.stats() };
+        state.counters[ "allocations"     ] = benchmark::Counter( static_cast< double >( stats.allocations ), benchmark::Counter::kAvgIterations );
+        state.counters[ "allocated_bytes" ] = benchmark::Counter( static_cast< double >( stats.bytes       ), benchmark::Counter::kAvgIterations );
+    }
+
 } // namespace
 
 void BuildingExpressionTree( benchmark::State & state )
@@ -65,15 +81,45 @@ void BuildingExpressionTree( benchmark::State & state )
         }
     };
 
+    booleval::testing::allocation_scope const scope;
+
     for (auto _ : state)
     {
         [[ maybe_unused ]] auto const success{ evaluator.expression( "(field_1 foo and field_2 1) or (field_1 qux and field_2 2)" ) };
         benchmark::DoNotOptimize( evaluator );
     }
+
+    count_allocations( state, scope );
 }
 
 BENCHMARK( BuildingExpressionTree );
 
+void LoadingCompiledExpression( benchmark::State & state )
+{
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "field_1", &bar< std::string, unsigned >::value_1 ),
+            booleval::make_field( "field_2", &bar< std::string, unsigned >::value_2 )
+        }
+    };
+
+    auto const image{ booleval::compile( "(field_1 foo and field_2 1) or (field_1 qux and field_2 2)" ) };
+
+    booleval::testing::allocation_scope const scope;
+
+    for (auto _ : state)
+    {
+        auto loaded{ booleval::compiled_expression::view( image.image_data(), image.image_size() ) };
+        [[ maybe_unused ]] auto const success{ evaluator.expression( std::move( loaded.value() ) ) };
+        benchmark::DoNotOptimize( evaluator );
+    }
+
+    count_allocations( state, scope );
+}
+
+BENCHMARK( LoadingCompiledExpression );
+
 void Evaluation( benchmark::State & state )
 {
     booleval::evaluator evaluator
@@ -88,14 +134,152 @@ void Evaluation( benchmark::State & state )
 
     [[ maybe_unused ]] auto const success{ evaluator.expression( "(field_1 foo and field_2 1) or (field_1 qux and field_2 2)" ) };
 
+    booleval::testing::allocation_scope const scope;
+
     for (auto _ : state)
     {
         [[ maybe_unused ]] auto const result{ evaluator.evaluate( x ) };
         benchmark::DoNotOptimize( evaluator );
         benchmark::DoNotOptimize( x         );
     }
+
+    count_allocations( state, scope );
 }
 
 BENCHMARK( Evaluation );
 
+void FastEvaluation( benchmark::State & state )
+{
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "field_1", &bar< std::string, unsigned >::value_1 ),
+            booleval::make_field( "field_2", &bar< std::string, unsigned >::value_2 )
+        }
+    };
+
+    bar< std::string, unsigned > x{ "foo", 1 };
+
+    [[ maybe_unused ]] auto const success{ evaluator.expression( "(field_1 foo and field_2 1) or (field_1 qux and field_2 2)" ) };
+
+    booleval::testing::allocation_scope const scope;
+
+    for (auto _ : state)
+    {
+        [[ maybe_unused ]] auto const result{ evaluator.matches( x ) };
+        benchmark::DoNotOptimize( result );
+        benchmark::DoNotOptimize( x      );
+    }
+
+    count_allocations( state, scope );
+}
+
+BENCHMARK( FastEvaluation );
+
+void ParameterFrameEvaluation( benchmark::State & state )
+{
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "field_1", &bar< std::string, unsigned >::value_1 ),
+            booleval::make_field( "field_2", &bar< std::string, unsigned >::value_2 )
+        }
+    };
+
+    bar< std::string, unsigned > x{ "foo", 1 };
+
+    [[ maybe_unused ]] auto const success{ evaluator.expression( "(field_1 $1 and field_2 $2) or (field_1 $3 and field_2 $4)" ) };
+
+    // the frame of typed values, e.g. kept by each worker thread for its tenant
+    booleval::parameter const frame[]{ "foo", 1, "qux", 2 };
+
+    booleval::testing::allocation_scope const scope;
+
+    for (auto _ : state)
+    {
+        [[ maybe_unused ]] auto const result{ evaluator.matches( x, { frame, 4 } ) };
+        benchmark::DoNotOptimize( result );
+        benchmark::DoNotOptimize( x      );
+    }
+
+    count_allocations( state, scope );
+}
+
+BENCHMARK( ParameterFrameEvaluation );
+
+namespace
+{
+
+    /**
+     * Makes the evaluator and the objects shared by the selection benchmarks,
+     * where one in ten objects survives the first operand of logical and.
+     */
+    booleval::evaluator make_selection_evaluator( std::vector< bar< unsigned, unsigned > > & objects )
+    {
+        booleval::evaluator evaluator
+        {
+            {
+                booleval::make_field( "field_1", &bar< unsigned, unsigned >::value_1 ),
+                booleval::make_field( "field_2", &bar< unsigned, unsigned >::value_2 )
+            }
+        };
+
+        for ( unsigned i{ 0 }; i < 1024; ++i )
+        {
+            objects.emplace_back( i % 10U, i + 0U );
+        }
+
+        [[ maybe_unused ]] auto const success{ evaluator.expression( "field_1 == 3 and field_2 > 100 or field_2 == 5" ) };
+
+        return evaluator;
+    }
+
+} // namespace
+
+void ObjectSelection( benchmark::State & state )
+{
+    std::vector< bar< unsigned, unsigned > > objects;
+    auto const evaluator{ make_selection_evaluator( objects ) };
+
+    std::vector< std::size_t > selected( std::size( objects ) );
+
+    booleval::testing::allocation_scope const scope;
+
+    for (auto _ : state)
+    {
+        auto out{ std::begin( selected ) };
+        for ( std::size_t i{ 0 }; i < std::size( objects ); ++i )
+        {
+            if ( evaluator.matches( objects[ i ] ) ) { *out++ = i; }
+        }
+        benchmark::DoNotOptimize( out );
+    }
+
+    count_allocations( state, scope );
+    state.SetItemsProcessed( static_cast< std::int64_t >( state.iterations() * std::size( objects ) ) );
+}
+
+BENCHMARK( ObjectSelection );
+
+void BlockSelection( benchmark::State & state )
+{
+    std::vector< bar< unsigned, unsigned > > objects;
+    auto const evaluator{ make_selection_evaluator( objects ) };
+
+    std::vector< std::size_t > selected( std::size( objects ) );
+
+    booleval::testing::allocation_scope const scope;
+
+    for (auto _ : state)
+    {
+        auto out{ evaluator.select( std::cbegin( objects ), std::cend( objects ), std::begin( selected ) ) };
+        benchmark::DoNotOptimize( out );
+    }
+
+    count_allocations( state, scope );
+    state.SetItemsProcessed( static_cast< std::int64_t >( state.iterations() * std::size( objects ) ) );
+}
+
+BENCHMARK( BlockSelection );
+
 BENCHMARK_MAIN();
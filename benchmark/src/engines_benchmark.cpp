@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Benchmarks of the evaluation engines matching the same expression against
+ * the same batch of objects: the visitor of the expression tree, the visitor
+ * of the compiled expression (flat array of nodes) used by the evaluator, and
+ * the compile-time schema evaluator. With BOOLEVAL_BENCHMARK_PERF_COUNTERS
+ * enabled on Linux, hardware performance counters are reported for each of
+ * them, so that their IPC and branch misses can be compared.
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <booleval/evaluator.hpp>
+#include <booleval/schema.hpp>
+#include <booleval/schema_evaluator.hpp>
+#include <booleval/tree/tree.hpp>
+#include <booleval/tree/result_visitor.hpp>
+
+#include "perf_counters.hpp"
+
+namespace
+{
+
+    struct request
+    {
+        std::string level  {};
+        unsigned    latency{};
+        double      ratio  {};
+    };
+
+    constexpr char level  []{ "level"   };
+    constexpr char latency[]{ "latency" };
+    constexpr char ratio  []{ "ratio"   };
+
+    using request_schema = booleval::schema
+    <
+        request,
+        booleval::static_field< level  , &request::level   >,
+        booleval::static_field< latency, &request::latency >,
+        booleval::static_field< ratio  , &request::ratio   >
+    >;
+
+    constexpr std::string_view expression
+    {
+        "(level == error and latency > 500) or (level == warning and ratio < 0.1)"
+    };
+
+    constexpr std::size_t batch_size{ 1024 };
+
+    std::vector< request > make_batch()
+    {
+        std::mt19937_64 generator{ 42 };
+        std::uniform_int_distribution< unsigned > latency_distribution{ 0, 1000 };
+        std::uniform_int_distribution< int      > level_distribution  { 0, 3    };
+        std::uniform_real_distribution< double  > ratio_distribution  { 0, 1    };
+
+        constexpr char const * levels[]{ "debug", "info", "warning", "error" };
+
+        std::vector< request > batch;
+        for ( std::size_t i{ 0 }; i < batch_size; ++i )
+        {
+            batch.push_back( { levels[ level_distribution( generator ) ], latency_distribution( generator ), ratio_distribution( generator ) } );
+        }
+        return batch;
+    }
+
+    /**
+     * Matches the batch of objects by using the matching function, collecting
+     * the performance counters around the benchmark loop.
+     */
+    template< typename F >
+    void run( benchmark::State & state, F && matches )
+    {
+        auto const batch{ make_batch() };
+
+        booleval::perf::perf_counters counters;
+        counters.start();
+
+        std::size_t count{ 0 };
+        for ( auto _ : state )
+        {
+            for ( auto const & obj : batch )
+            {
+                count += matches( obj ) ? 1 : 0;
+            }
+            benchmark::DoNotOptimize( count );
+        }
+
+        counters.stop();
+        counters.report( state );
+
+        state.SetItemsProcessed( static_cast< std::int64_t >( state.iterations() * batch_size ) );
+    }
+
+} // namespace
+
+void TreeVisitor( benchmark::State & state )
+{
+    booleval::tree::result_visitor visitor;
+    visitor.fields
+    (
+        {
+            booleval::make_field( "level"  , &request::level   ),
+            booleval::make_field( "latency", &request::latency ),
+            booleval::make_field( "ratio"  , &request::ratio   )
+        }
+    );
+
+    auto const root{ booleval::tree::build( expression ) };
+
+    run( state, [ & ]( request const & obj ) { return visitor.matches( *root, obj ); } );
+}
+
+BENCHMARK( TreeVisitor );
+
+void FlatVisitor( benchmark::State & state )
+{
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "level"  , &request::level   ),
+            booleval::make_field( "latency", &request::latency ),
+            booleval::make_field( "ratio"  , &request::ratio   )
+        }
+    };
+
+    [[ maybe_unused ]] auto const success{ evaluator.expression( expression ) };
+
+    run( state, [ & ]( request const & obj ) { return evaluator.matches( obj ); } );
+}
+
+BENCHMARK( FlatVisitor );
+
+void SchemaVisitor( benchmark::State & state )
+{
+    booleval::schema_evaluator< request_schema > evaluator;
+
+    [[ maybe_unused ]] auto const success{ evaluator.expression( expression ) };
+
+    run( state, [ & ]( request const & obj ) { return evaluator.matches( obj ); } );
+}
+
+BENCHMARK( SchemaVisitor );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Parameterized benchmarks of the evaluator, sweeping:
+ *
+ *  - expression shape: nesting depth and number of relational operations (width),
+ *  - number of registered fields, from 1 up to 256, and their types,
+ *  - selectivity of the expression over a batch of objects,
+ *  - ordering of the operands: short-circuit friendly or hostile,
+ *  - memoization of the expensive fields referenced several times,
+ *
+ * each measured separately for setting the expression (parsing, compiling and
+ * binding it), evaluation with the result message and the plain matching.
+ * The allocations made per iteration are reported as counters. Results can be
+ * exported as JSON by the benchmark_json target, or by running a benchmark
+ * binary with --benchmark_out=<file> --benchmark_out_format=json.
+ */
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <benchmark/benchmark.h>
+#include <booleval/evaluator.hpp>
+
+#include "allocation_counter.hpp"
+
+namespace
+{
+
+    constexpr std::size_t max_fields{ 256 };
+
+    /**
+     * Object with the same number of fields of each type.
+     */
+    struct record
+    {
+        explicit record( std::size_t const fields )
+            : ints   ( fields )
+            , doubles( fields )
+            , strings( fields )
+            , bools  ( fields )
+        {}
+
+        std::vector< int         > ints;
+        std::vector< double      > doubles;
+        std::vector< std::string > strings;
+        std::vector< bool        > bools;
+    };
+
+    template< typename T, typename R >
+    auto & values( R & obj ) noexcept
+    {
+        if constexpr ( std::is_same_v< T, int         > ) { return obj.ints;    }
+        if constexpr ( std::is_same_v< T, double      > ) { return obj.doubles; }
+        if constexpr ( std::is_same_v< T, std::string > ) { return obj.strings; }
+        if constexpr ( std::is_same_v< T, bool        > ) { return obj.bools;   }
+    }
+
+    // field values are read by reference, except for the packed booleans
+    template< typename T >
+    using field_type = std::conditional_t< std::is_same_v< T, bool >, bool, T const & >;
+
+    template< typename T, std::size_t I >
+    field_type< T > get( record const & obj ) noexcept
+    {
+        return values< T >( obj )[ I ];
+    }
+
+    template< typename T >
+    struct traits;
+
+    // name prefix of the fields, constant used in the relational operations and the value satisfying them
+    template<> struct traits< int         > { static constexpr std::string_view prefix{ "int"    }, constant{ "1"   }; static int         value() { return 1;     } };
+    template<> struct traits< double      > { static constexpr std::string_view prefix{ "double" }, constant{ "1.5" }; static double      value() { return 1.5;   } };
+    template<> struct traits< std::string > { static constexpr std::string_view prefix{ "string" }, constant{ "foo" }; static std::string value() { return "foo"; } };
+    template<> struct traits< bool        > { static constexpr std::string_view prefix{ "bool"   }, constant{ "1"   }; static bool        value() { return true;  } };
+
+    template< typename T >
+    std::array< std::string, max_fields > const & field_names()
+    {
+        static auto const names
+        {
+            []
+            {
+                std::array< std::string, max_fields > result;
+                for ( std::size_t i{ 0 }; i < max_fields; ++i )
+                {
+                    result[ i ] = std::string{ traits< T >::prefix } + "_" + std::to_string( i );
+                }
+                return result;
+            }()
+        };
+        return names;
+    }
+
+    template< typename T, std::size_t... I >
+    booleval::evaluator make_evaluator( std::index_sequence< I... > )
+    {
+        return booleval::evaluator{ { booleval::make_field( field_names< T >()[ I ], &get< T, I > )... } };
+    }
+
+    /**
+     * Makes the evaluator of the objects with N fields of type T.
+     */
+    template< typename T, std::size_t N = max_fields >
+    booleval::evaluator make_evaluator()
+    {
+        return make_evaluator< T >( std::make_index_sequence< N >{} );
+    }
+
+    /**
+     * Makes the object with N fields of type T, all of them satisfying the relational operations.
+     */
+    template< typename T >
+    record make_record( std::size_t const fields = max_fields )
+    {
+        record obj{ fields };
+        auto & fields_values{ values< T >( obj ) };
+        std::fill( std::begin( fields_values ), std::end( fields_values ), traits< T >::value() );
+        return obj;
+    }
+
+    template< typename T >
+    std::string relation( std::size_t const field )
+    {
+        return field_names< T >()[ field % max_fields ] + " == " + std::string{ traits< T >::constant };
+    }
+
+    /**
+     * Makes the expression of nested logical operations, i.e. "a and (b and (c and ...))".
+     */
+    std::string nested_expression( std::size_t const depth )
+    {
+        std::string expression{ relation< int >( depth ) };
+        for ( std::size_t i{ depth }; i > 0; --i )
+        {
+            expression = relation< int >( i - 1 ) + " and (" + expression + ")";
+        }
+        return expression;
+    }
+
+    /**
+     * Makes the balanced expression of the specified number of relational operations.
+     */
+    std::string balanced_expression( std::size_t const first, std::size_t const width )
+    {
+        if ( width == 1 ) { return relation< int >( first ); }
+
+        auto const half{ width / 2 };
+        return "(" + balanced_expression( first, half ) + ") and (" + balanced_expression( first + half, width - half ) + ")";
+    }
+
+    template< typename T, std::size_t N >
+    std::string fields_expression()
+    {
+        // the first and the last registered field
+        return relation< T >( N - 1 ) + " and " + relation< T >( 0 );
+    }
+
+    /**
+     * Reports the allocations made within the benchmark loop, per iteration.
+     */
+    void count_allocations( benchmark::State & state, booleval::testing::allocation_scope const & scope )
+    {
+        auto const stats{ scope.stats() };
+        state.counters[ "allocations"     ] = benchmark::Counter( static_cast< double >( stats.allocations ), benchmark::Counter::kAvgIterations );
+        state.counters[ "allocated_bytes" ] = benchmark::Counter( static_cast< double >( stats.bytes       ), benchmark::Counter::kAvgIterations );
+    }
+
+    enum class phase
+    {
+        parse,
+        evaluate,
+        match
+    };
+
+    /**
+     * Runs the benchmark of the phase for the expression.
+     */
+    void run( benchmark::State & state, booleval::evaluator & evaluator, std::string const & expression, record const & obj, phase const p )
+    {
+        if ( !evaluator.expression( expression ) )
+        {
+            state.SkipWithError( "Invalid expression" );
+            return;
+        }
+
+        booleval::testing::allocation_scope const scope;
+
+        switch ( p )
+        {
+            case phase::parse:
+                for ( auto _ : state )
+                {
+                    [[ maybe_unused ]] auto const success{ evaluator.expression( expression ) };
+                    benchmark::DoNotOptimize( evaluator );
+                }
+                break;
+
+            case phase::evaluate:
+                for ( auto _ : state )
+                {
+                    auto const result{ evaluator.evaluate( obj ) };
+                    benchmark::DoNotOptimize( result );
+                }
+                break;
+
+            case phase::match:
+                for ( auto _ : state )
+                {
+                    auto const result{ evaluator.matches( obj ) };
+                    benchmark::DoNotOptimize( result );
+                }
+                break;
+        }
+
+        count_allocations( state, scope );
+        state.counters[ "expression_bytes" ] = static_cast< double >( std::size( expression ) );
+    }
+
+} // namespace
+
+// Expression shape
+
+template< phase P >
+void Depth( benchmark::State & state )
+{
+    static auto       evaluator{ make_evaluator< int >() };
+    static auto const obj      { make_record< int >() };
+
+    auto const depth{ static_cast< std::size_t >( state.range( 0 ) ) };
+    run( state, evaluator, nested_expression( depth ), obj, P );
+
+    state.counters[ "depth" ] = static_cast< double >( depth );
+}
+
+template< phase P >
+void Width( benchmark::State & state )
+{
+    static auto       evaluator{ make_evaluator< int >() };
+    static auto const obj      { make_record< int >() };
+
+    auto const width{ static_cast< std::size_t >( state.range( 0 ) ) };
+    run( state, evaluator, balanced_expression( 0, width ), obj, P );
+
+    state.counters[ "width" ] = static_cast< double >( width );
+}
+
+BENCHMARK_TEMPLATE( Depth, phase::parse    )->DenseRange( 0, 32, 8 );
+BENCHMARK_TEMPLATE( Depth, phase::evaluate )->DenseRange( 0, 32, 8 );
+BENCHMARK_TEMPLATE( Depth, phase::match    )->DenseRange( 0, 32, 8 );
+BENCHMARK_TEMPLATE( Width, phase::parse    )->RangeMultiplier( 4 )->Range( 1, 256 );
+BENCHMARK_TEMPLATE( Width, phase::evaluate )->RangeMultiplier( 4 )->Range( 1, 256 );
+BENCHMARK_TEMPLATE( Width, phase::match    )->RangeMultiplier( 4 )->Range( 1, 256 );
+
+// Number and types of registered fields
+
+template< phase P, typename T, std::size_t N >
+void Fields( benchmark::State & state )
+{
+    auto       evaluator{ make_evaluator< T, N >() };
+    auto const obj      { make_record< T >( N ) };
+
+    run( state, evaluator, fields_expression< T, N >(), obj, P );
+
+    state.counters[ "fields" ] = static_cast< double >( N );
+}
+
+#define BOOLEVAL_FIELDS_BENCHMARK( P, T )             \
+    BENCHMARK_TEMPLATE( Fields, P, T, 1   );         \
+    BENCHMARK_TEMPLATE( Fields, P, T, 4   );         \
+    BENCHMARK_TEMPLATE( Fields, P, T, 16  );         \
+    BENCHMARK_TEMPLATE( Fields, P, T, 64  );         \
+    BENCHMARK_TEMPLATE( Fields, P, T, 256 )
+
+BOOLEVAL_FIELDS_BENCHMARK( phase::parse   , int         );
+BOOLEVAL_FIELDS_BENCHMARK( phase::parse   , std::string );
+BOOLEVAL_FIELDS_BENCHMARK( phase::match   , int         );
+BOOLEVAL_FIELDS_BENCHMARK( phase::match   , double      );
+BOOLEVAL_FIELDS_BENCHMARK( phase::match   , std::string );
+BOOLEVAL_FIELDS_BENCHMARK( phase::match   , bool        );
+BOOLEVAL_FIELDS_BENCHMARK( phase::evaluate, int         );
+BOOLEVAL_FIELDS_BENCHMARK( phase::evaluate, double      );
+BOOLEVAL_FIELDS_BENCHMARK( phase::evaluate, std::string );
+BOOLEVAL_FIELDS_BENCHMARK( phase::evaluate, bool        );
+
+#undef BOOLEVAL_FIELDS_BENCHMARK
+
+// Selectivity and ordering of the operands over a batch of objects
+
+namespace
+{
+
+    constexpr std::size_t batch_size{ 1000 };
+
+    /**
+     * Makes the batch of objects whose first field takes the values from 0 to 99
+     * in turn, while all the other fields satisfy the relational operations.
+     */
+    std::vector< record > make_batch()
+    {
+        std::vector< record > batch;
+        for ( std::size_t i{ 0 }; i < batch_size; ++i )
+        {
+            auto & obj{ batch.emplace_back( make_record< int >( 8 ) ) };
+            obj.ints[ 0 ] = static_cast< int >( i % 100 );
+        }
+        return batch;
+    }
+
+    void run_batch( benchmark::State & state, std::string const & expression )
+    {
+        auto       evaluator{ make_evaluator< int, 8 >() };
+        auto const batch    { make_batch() };
+
+        if ( !evaluator.expression( expression ) )
+        {
+            state.SkipWithError( "Invalid expression" );
+            return;
+        }
+
+        booleval::testing::allocation_scope const scope;
+
+        std::size_t matches{ 0 };
+        for ( auto _ : state )
+        {
+            for ( auto const & obj : batch )
+            {
+                matches += evaluator.matches( obj ) ? 1 : 0;
+            }
+            benchmark::DoNotOptimize( matches );
+        }
+
+        count_allocations( state, scope );
+        state.SetItemsProcessed( static_cast< std::int64_t >( state.iterations() * batch_size ) );
+        state.counters[ "selectivity" ] = static_cast< double >( matches ) / static_cast< double >( state.iterations() * batch_size );
+    }
+
+} // namespace
+
+void Selectivity( benchmark::State & state )
+{
+    // percentage of the objects satisfying the expression
+    run_batch( state, "int_0 < " + std::to_string( state.range( 0 ) ) );
+}
+
+BENCHMARK( Selectivity )->Arg( 0 )->Arg( 1 )->Arg( 10 )->Arg( 50 )->Arg( 90 )->Arg( 100 );
+
+void ShortCircuit( benchmark::State & state )
+{
+    auto const hostile{ state.range( 0 ) != 0 };
+
+    // the rarely satisfied operation first lets the rest of them be skipped most of the time
+    std::string expression{ hostile ? "" : "int_0 == 0 and " };
+    for ( std::size_t i{ 1 }; i < 8; ++i )
+    {
+        expression += relation< int >( i ) + ( i + 1 < 8 ? " and " : "" );
+    }
+    expression += hostile ? " and int_0 == 0" : "";
+
+    run_batch( state, expression );
+
+    state.SetLabel( hostile ? "hostile" : "friendly" );
+}
+
+BENCHMARK( ShortCircuit )->Arg( 0 )->Arg( 1 );
+
+// Memoization of the expensive fields
+
+namespace
+{
+
+    /**
+     * Gets the checksum of the first string field, i.e. the value of a getter
+     * decoding the object, far more expensive than a data member read.
+     */
+    std::uint64_t checksum( record const & obj ) noexcept
+    {
+        std::uint64_t hash{ 14695981039346656037ULL };
+        for ( auto const c : obj.strings[ 0 ] )
+        {
+            hash = ( hash ^ static_cast< unsigned char >( c ) ) * 1099511628211ULL;
+        }
+        return hash % 1000;
+    }
+
+} // namespace
+
+void Memoization( benchmark::State & state )
+{
+    auto const cacheable{ state.range( 0 ) != 0 };
+
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "checksum", &checksum, { 100, cacheable } ) }
+    };
+
+    record obj{ 1 };
+    obj.strings[ 0 ].assign( 256, 'x' );
+
+    // none of the operations short-circuits, so the field is referenced four times
+    run( state, evaluator, "checksum > 1 and checksum < 999 and checksum != 2 and checksum != 3", obj, phase::match );
+
+    state.SetLabel( cacheable ? "memoized" : "fetched every time" );
+}
+
+BENCHMARK( Memoization )->Arg( 0 )->Arg( 1 );
+
+BENCHMARK_MAIN();
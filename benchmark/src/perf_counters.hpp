@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_PERF_COUNTERS_HPP
+#define BOOLEVAL_PERF_COUNTERS_HPP
+
+#include <array>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+#include <benchmark/benchmark.h>
+
+#ifndef BOOLEVAL_PERF_COUNTERS
+#   define BOOLEVAL_PERF_COUNTERS 0
+#endif
+
+#if BOOLEVAL_PERF_COUNTERS && defined( __linux__ )
+#   include <cstring>
+#   include <unistd.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <linux/perf_event.h>
+#   define BOOLEVAL_HAS_PERF_EVENTS 1
+#else
+#   define BOOLEVAL_HAS_PERF_EVENTS 0
+#endif
+
+namespace booleval::perf
+{
+
+/**
+ * @class perf_counters
+ *
+ * Represents the group of hardware performance counters (cycles, instructions,
+ * branch misses, L1 data cache and last level cache misses) collected around
+ * the benchmark loop via perf_event_open and reported as benchmark counters,
+ * per iteration. Only user space is counted, so no special privileges are
+ * needed with the default perf_event_paranoid setting.
+ *
+ * The counters are collected on Linux only, if enabled by the
+ * BOOLEVAL_BENCHMARK_PERF_COUNTERS option. Otherwise, or if the events are
+ * not supported, e.g. within a virtual machine, nothing is reported.
+ */
+class perf_counters
+{
+public:
+    static constexpr std::array< std::string_view, 5 > names
+    {
+        "cycles",
+        "instructions",
+        "branch_misses",
+        "l1d_misses",
+        "llc_misses"
+    };
+
+    perf_counters() noexcept
+    {
+#if BOOLEVAL_HAS_PERF_EVENTS
+        constexpr auto l1d_read_miss
+        {
+            PERF_COUNT_HW_CACHE_L1D | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 )
+        };
+
+        constexpr std::array< std::pair< std::uint32_t, std::uint64_t >, std::size( names ) > events
+        {{
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES    },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS  },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+            { PERF_TYPE_HW_CACHE, l1d_read_miss               },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES  }
+        }};
+
+        for ( std::size_t i{ 0 }; i < std::size( events ); ++i )
+        {
+            perf_event_attr attr;
+            std::memset( &attr, 0, sizeof( attr ) );
+            attr.size           = sizeof( attr );
+            attr.type           = events[ i ].first;
+            attr.config         = events[ i ].second;
+            attr.disabled       = leader_ < 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            auto const fd{ static_cast< int >( ::syscall( SYS_perf_event_open, &attr, 0, -1, leader_, 0 ) ) };
+            if ( fd < 0 ) { continue; }
+
+            // unsupported events are left out of the group
+            if ( leader_ < 0 ) { leader_ = fd; }
+            fds_[ i ] = fd;
+            ::ioctl( fd, PERF_EVENT_IOC_ID, &ids_[ i ] );
+        }
+#endif
+    }
+
+    perf_counters( perf_counters       && rhs ) = delete;
+    perf_counters( perf_counters const  & rhs ) = delete;
+
+    perf_counters & operator=( perf_counters       && rhs ) = delete;
+    perf_counters & operator=( perf_counters const  & rhs ) = delete;
+
+    ~perf_counters() noexcept
+    {
+#if BOOLEVAL_HAS_PERF_EVENTS
+        for ( auto const fd : fds_ )
+        {
+            if ( fd >= 0 ) { ::close( fd ); }
+        }
+#endif
+    }
+
+    /**
+     * Checks whether any of the counters is collected.
+     *
+     * @return True if the counters are available, otherwise false
+     */
+    [[ nodiscard ]] bool is_available() const noexcept
+    {
+        return leader_ >= 0;
+    }
+
+    /**
+     * Resets and starts the counters.
+     */
+    void start() noexcept
+    {
+#if BOOLEVAL_HAS_PERF_EVENTS
+        if ( !is_available() ) { return; }
+        ::ioctl( leader_, PERF_EVENT_IOC_RESET , PERF_IOC_FLAG_GROUP );
+        ::ioctl( leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+#endif
+    }
+
+    /**
+     * Stops the counters and reads their values, scaled up if the counters
+     * were multiplexed, i.e. not running all the time they were enabled.
+     */
+    void stop() noexcept
+    {
+#if BOOLEVAL_HAS_PERF_EVENTS
+        if ( !is_available() ) { return; }
+        ::ioctl( leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP );
+
+        // nr, time enabled, time running, { value, id } for each event
+        std::array< std::uint64_t, 3 + 2 * std::size( names ) > buffer{};
+        if ( ::read( leader_, std::data( buffer ), sizeof( buffer ) ) <= 0 ) { return; }
+
+        auto const count  { std::min< std::uint64_t >( buffer[ 0 ], std::size( names ) ) };
+        auto const enabled{ static_cast< double >( buffer[ 1 ] ) };
+        auto const running{ static_cast< double >( buffer[ 2 ] ) };
+        auto const scale  { running > 0 ? enabled / running : 0.0 };
+
+        for ( std::size_t i{ 0 }; i < count; ++i )
+        {
+            auto const value{ buffer[ 3 + 2 * i     ] };
+            auto const id   { buffer[ 3 + 2 * i + 1 ] };
+            for ( std::size_t j{ 0 }; j < std::size( names ); ++j )
+            {
+                if ( fds_[ j ] >= 0 && ids_[ j ] == id ) { values_[ j ] = static_cast< double >( value ) * scale; }
+            }
+        }
+#endif
+    }
+
+    /**
+     * Reports the collected counters, per iteration, together with the number
+     * of instructions per cycle.
+     *
+     * @param state Benchmark state
+     */
+    void report( benchmark::State & state ) const
+    {
+        if ( !is_available() ) { return; }
+
+        for ( std::size_t i{ 0 }; i < std::size( names ); ++i )
+        {
+            if ( fds_[ i ] < 0 ) { continue; }
+            state.counters[ std::string{ names[ i ] } ] = benchmark::Counter( values_[ i ], benchmark::Counter::kAvgIterations );
+        }
+
+        if ( fds_[ 0 ] >= 0 && fds_[ 1 ] >= 0 && values_[ 0 ] > 0 )
+        {
+            state.counters[ "ipc" ] = values_[ 1 ] / values_[ 0 ];
+        }
+    }
+
+private:
+    int                                             leader_{ -1 };
+    std::array< int          , std::size( names ) > fds_   { -1, -1, -1, -1, -1 };
+    std::array< double       , std::size( names ) > values_{};
+#if BOOLEVAL_HAS_PERF_EVENTS
+    std::array< std::uint64_t, std::size( names ) > ids_   {};
+#endif
+};
+
+} // namespace booleval::perf
+
+#endif // BOOLEVAL_PERF_COUNTERS_HPP
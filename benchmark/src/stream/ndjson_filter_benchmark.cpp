@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <random>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <booleval/stream/ndjson_filter.hpp>
+
+namespace
+{
+
+    std::string make_input()
+    {
+        std::mt19937_64 generator{ 42 };
+        std::uniform_int_distribution< int > latency{ 0, 1000 };
+        std::uniform_int_distribution< int > level  { 0, 3    };
+
+        constexpr char const * levels[]{ "debug", "info", "warning", "error" };
+
+        std::string input;
+        for ( int i{ 0 }; i < 10000; ++i )
+        {
+            input += "{\"id\": " + std::to_string( i ) +
+                     ", \"host\": \"worker-" + std::to_string( i % 64 ) +
+                     "\", \"tags\": [\"a\", \"b\", {\"nested\": true}]" +
+                     ", \"level\": \"" + levels[ level( generator ) ] +
+                     "\", \"latency\": " + std::to_string( latency( generator ) ) +
+                     ", \"message\": \"request served \\\"ok\\\"\"}\n";
+        }
+        return input;
+    }
+
+} // namespace
+
+void NdjsonFilter( benchmark::State & state )
+{
+    auto const input{ make_input() };
+
+    booleval::stream::ndjson_filter filter;
+    [[ maybe_unused ]] auto const success{ filter.expression( "level == error and latency > 500" ) };
+
+    for ( auto _ : state )
+    {
+        std::size_t matches{ 0 };
+        auto const stats{ filter.filter( input, [ &matches ]( std::string_view ) noexcept { ++matches; } ) };
+        benchmark::DoNotOptimize( stats   );
+        benchmark::DoNotOptimize( matches );
+    }
+
+    state.SetBytesProcessed( static_cast< std::int64_t >( state.iterations() * std::size( input ) ) );
+    state.SetItemsProcessed( static_cast< std::int64_t >( state.iterations() * 10000 ) );
+}
+
+BENCHMARK( NdjsonFilter );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <benchmark/benchmark.h>
+#include <booleval/utils/string_utils.hpp>
+
+namespace
+{
+
+    template< typename T >
+    std::vector< T > make_values()
+    {
+        std::mt19937_64 generator{ 42 };
+        std::uniform_real_distribution< T > distribution{ T{ -1000 }, T{ 1000 } };
+
+        std::vector< T > values( 1024 );
+        for ( auto & value : values ) { value = distribution( generator ); }
+        return values;
+    }
+
+    template< typename T >
+    std::vector< std::string > make_strings()
+    {
+        std::vector< std::string > strings;
+        for ( auto const value : make_values< T >() )
+        {
+            strings.push_back( booleval::utils::to_chars( value ) );
+        }
+        return strings;
+    }
+
+    std::size_t total_size( std::vector< std::string > const & strings )
+    {
+        std::size_t size{ 0 };
+        for ( auto const & str : strings ) { size += std::size( str ); }
+        return size;
+    }
+
+} // namespace
+
+template< typename T >
+void FromChars( benchmark::State & state )
+{
+    auto const strings{ make_strings< T >() };
+
+    for ( auto _ : state )
+    {
+        for ( auto const & str : strings )
+        {
+            benchmark::DoNotOptimize( booleval::utils::from_chars< T >( str ) );
+        }
+    }
+
+    state.SetItemsProcessed( state.iterations() * std::size( strings ) );
+    state.SetBytesProcessed( state.iterations() * total_size( strings ) );
+}
+
+template< typename T >
+void FromCharsFallback( benchmark::State & state )
+{
+    auto const strings{ make_strings< T >() };
+
+    for ( auto _ : state )
+    {
+        for ( auto const & str : strings )
+        {
+            benchmark::DoNotOptimize( booleval::utils::internal::parse_floating_point< T >( str ) );
+        }
+    }
+
+    state.SetItemsProcessed( state.iterations() * std::size( strings ) );
+    state.SetBytesProcessed( state.iterations() * total_size( strings ) );
+}
+
+template< typename T >
+void FromCharsStringStream( benchmark::State & state )
+{
+    auto const strings{ make_strings< T >() };
+
+    for ( auto _ : state )
+    {
+        for ( auto const & str : strings )
+        {
+            T value{};
+            std::stringstream ss;
+            ss << str;
+            ss >> value;
+            benchmark::DoNotOptimize( value );
+        }
+    }
+
+    state.SetItemsProcessed( state.iterations() * std::size( strings ) );
+    state.SetBytesProcessed( state.iterations() * total_size( strings ) );
+}
+
+template< typename T >
+void ToChars( benchmark::State & state )
+{
+    auto const values{ make_values< T >() };
+
+    for ( auto _ : state )
+    {
+        for ( auto const value : values )
+        {
+            benchmark::DoNotOptimize( booleval::utils::to_chars( value ) );
+        }
+    }
+
+    state.SetItemsProcessed( state.iterations() * std::size( values ) );
+}
+
+template< typename T >
+void ToCharsFallback( benchmark::State & state )
+{
+    auto const values{ make_values< T >() };
+
+    for ( auto _ : state )
+    {
+        for ( auto const value : values )
+        {
+            benchmark::DoNotOptimize( booleval::utils::internal::format_floating_point( value ) );
+        }
+    }
+
+    state.SetItemsProcessed( state.iterations() * std::size( values ) );
+}
+
+template< typename T >
+void ToCharsToString( benchmark::State & state )
+{
+    auto const values{ make_values< T >() };
+
+    for ( auto _ : state )
+    {
+        for ( auto const value : values )
+        {
+            auto result{ std::to_string( value ) };
+            result = booleval::utils::rtrim( result, '0' );
+            benchmark::DoNotOptimize( result );
+        }
+    }
+
+    state.SetItemsProcessed( state.iterations() * std::size( values ) );
+}
+
+BENCHMARK_TEMPLATE( FromChars            , double );
+BENCHMARK_TEMPLATE( FromChars            , float  );
+BENCHMARK_TEMPLATE( FromCharsFallback    , double );
+BENCHMARK_TEMPLATE( FromCharsFallback    , float  );
+BENCHMARK_TEMPLATE( FromCharsStringStream, double );
+BENCHMARK_TEMPLATE( ToChars              , double );
+BENCHMARK_TEMPLATE( ToChars              , float  );
+BENCHMARK_TEMPLATE( ToCharsFallback      , double );
+BENCHMARK_TEMPLATE( ToCharsFallback      , float  );
+BENCHMARK_TEMPLATE( ToCharsToString      , double );
+
+BENCHMARK_MAIN();
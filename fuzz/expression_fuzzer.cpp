@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+#include "differential.hpp"
+
+/**
+ * Evaluates the fuzzed expression with every engine and aborts whenever any
+ * of them disagrees with the result visitor of the expression tree.
+ */
+extern "C" int LLVMFuzzerTestOneInput( std::uint8_t const * data, std::size_t size )
+{
+    static booleval::differential::checker checker;
+    static auto const records
+    {
+        []
+        {
+            booleval::differential::generator generator{ 2021 };
+
+            std::vector< booleval::differential::record > result;
+            for ( std::size_t i{ 0 }; i < 16; ++i )
+            {
+                result.push_back( generator.make_record() );
+            }
+            return result;
+        }()
+    };
+
+    std::string_view const expression{ reinterpret_cast< char const * >( data ), size };
+
+    auto const report{ checker.check( expression, records ) };
+    for ( auto const & mismatch : report.mismatches )
+    {
+        std::cerr << mismatch << '\n';
+    }
+
+    if ( !report.mismatches.empty() ) { std::abort(); }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <filesystem>
+
+extern "C" int LLVMFuzzerTestOneInput( std::uint8_t const * data, std::size_t size );
+
+namespace
+{
+
+    void replay( std::filesystem::path const & path )
+    {
+        std::ifstream file{ path, std::ios::binary };
+        std::vector< char > const input{ std::istreambuf_iterator< char >{ file }, std::istreambuf_iterator< char >{} };
+
+        LLVMFuzzerTestOneInput( reinterpret_cast< std::uint8_t const * >( std::data( input ) ), std::size( input ) );
+    }
+
+} // namespace
+
+/**
+ * Replays the inputs of the fuzzer, i.e. the files and the directories of files
+ * passed as arguments, when it is not built with libFuzzer. The options meant
+ * for libFuzzer, like -runs=0, are ignored.
+ */
+int main( int argc, char * argv[] )
+{
+    std::size_t count{ 0 };
+
+    for ( int i{ 1 }; i < argc; ++i )
+    {
+        std::filesystem::path const path{ argv[ i ] };
+        if ( argv[ i ][ 0 ] == '-' ) { continue; }
+
+        if ( std::filesystem::is_directory( path ) )
+        {
+            for ( auto const & entry : std::filesystem::directory_iterator{ path } )
+            {
+                if ( entry.is_regular_file() ) { replay( entry.path() ); ++count; }
+            }
+        }
+        else
+        {
+            replay( path );
+            ++count;
+        }
+    }
+
+    std::cout << "Replayed " << count << " inputs\n";
+    return 0;
+}
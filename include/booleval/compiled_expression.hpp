@@ -0,0 +1,899 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_COMPILED_EXPRESSION_HPP
+#define BOOLEVAL_COMPILED_EXPRESSION_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include <booleval/limits.hpp>
+#include <booleval/result.hpp>
+#include <booleval/parameter.hpp>
+#include <booleval/memory_usage.hpp>
+#include <booleval/tree/node.hpp>
+#include <booleval/tree/flat_node.hpp>
+#include <booleval/tree/tree.hpp>
+
+namespace booleval
+{
+
+/**
+ * @class compiled_expression
+ *
+ * Represents the expression tree flattened into a contiguous array of compact
+ * nodes stored in pre-order, i.e. the root node is the first one. Fields and
+ * constants referenced by relational operations are kept in separate tables.
+ * Each distinct field appears in the table only once and is bound to the slot
+ * of the field provider (e.g. registered fields or schema) used for evaluation.
+ * Field names and constants are interned into the string pool owned by the
+ * compiled expression, so it does not depend on the source expression string.
+ *
+ * Nodes, tables and string pool live in a single binary image with the layout:
+ *
+ *     header | nodes | field table | constant table | string pool
+ *
+ * The image contains no pointers, so it can be stored as is and later used
+ * in place, e.g. directly from a memory-mapped file. Bindings are not part
+ * of the image as they depend on the field provider of the loading process.
+ *
+ * Fields may also be compared against parameter placeholders, e.g. field > $1,
+ * instead of constants. The values of the parameters are bound separately, so
+ * that changing them requires neither parsing nor flattening the expression.
+ */
+class compiled_expression
+{
+public:
+    static constexpr std::uint32_t npos          { tree::flat_node::npos };
+    static constexpr std::uint32_t parameter_flag{ tree::flat_node::parameter_flag };
+    static constexpr std::uint16_t format_version{ 1 };
+
+    compiled_expression() = default;
+
+    compiled_expression( compiled_expression && rhs ) noexcept
+    {
+        *this = std::move( rhs );
+    }
+
+    compiled_expression( compiled_expression const & rhs )
+    {
+        *this = rhs;
+    }
+
+    explicit compiled_expression( tree::node const & root )
+    {
+        std::unordered_map< std::string_view, std::uint32_t > field_indices;
+        std::vector< tree::flat_node  > nodes;
+        std::vector< std::string_view > field_names;
+        std::vector< std::string_view > constant_values;
+
+        flatten( root, field_indices, nodes, field_names, constant_values );
+        assemble( nodes, field_names, constant_values );
+    }
+
+    compiled_expression & operator=( compiled_expression && rhs ) noexcept
+    {
+        if ( this != &rhs )
+        {
+            storage_    = std::move( rhs.storage_    );
+            slots_      = std::move( rhs.slots_      );
+            swapped_    = std::move( rhs.swapped_    );
+            parameters_ = std::move( rhs.parameters_ );
+            frame_      = std::move( rhs.frame_      );
+            attach( rhs.image_, rhs.image_size_ );
+            rhs.storage_   .clear();
+            rhs.slots_     .clear();
+            rhs.swapped_   .clear();
+            rhs.parameters_.clear();
+            rhs.frame_     .clear();
+            rhs.attach( nullptr, 0 );
+        }
+        return *this;
+    }
+
+    compiled_expression & operator=( compiled_expression const & rhs )
+    {
+        if ( this != &rhs )
+        {
+            storage_    = rhs.storage_;
+            slots_      = rhs.slots_;
+            swapped_    = rhs.swapped_;
+            parameters_ = rhs.parameters_;
+            frame_      = { std::cbegin( parameters_ ), std::cend( parameters_ ) };
+            attach( storage_.empty() ? rhs.image_ : std::data( storage_ ), rhs.image_size_ );
+        }
+        return *this;
+    }
+
+    ~compiled_expression() = default;
+
+    /**
+     * Checks whether the bytes contain a valid image of the compiled expression,
+     * i.e. whether the format and version are supported, all the nodes, tables
+     * and strings are within the image, and the nodes form a tree within the
+     * limits, so that visiting it takes neither exponential time nor unbounded
+     * stack. Images coming from outside of the process are always checked
+     * before being used.
+     *
+     * @param data   Image bytes
+     * @param size   Number of image bytes
+     * @param limits Limits of the number of nodes and of their nesting
+     *
+     * @return Result containing the message of the first error found
+     */
+    [[ nodiscard ]] static result check( void const * data, std::size_t size, limits const & limits = {} ) noexcept;
+
+    /**
+     * Loads the compiled expression from the image by copying it.
+     *
+     * @param data   Image bytes
+     * @param size   Number of image bytes
+     * @param limits Limits of the number of nodes and of their nesting
+     *
+     * @return Compiled expression if the image is valid, otherwise std::nullopt
+     */
+    [[ nodiscard ]] static std::optional< compiled_expression > load( void const * data, std::size_t size, limits const & limits = {} )
+    {
+        if ( !check( data, size, limits ).success ) { return std::nullopt; }
+
+        auto const * bytes{ static_cast< std::byte const * >( data ) };
+
+        compiled_expression expression;
+        expression.storage_.assign( bytes, bytes + size );
+        expression.attach( std::data( expression.storage_ ), size );
+        expression.slots_  .assign( expression.field_count_, npos );
+        expression.swapped_.assign( expression.node_count_ , 0    );
+        return expression;
+    }
+
+    /**
+     * Uses the image in place, without copying it. The image has to outlive
+     * the compiled expression and its copies. This is meant for the images
+     * residing in memory-mapped files.
+     *
+     * @param data   Image bytes, aligned to 4 bytes
+     * @param size   Number of image bytes
+     * @param limits Limits of the number of nodes and of their nesting
+     *
+     * @return Compiled expression if the image is valid, otherwise std::nullopt
+     */
+    [[ nodiscard ]] static std::optional< compiled_expression > view( void const * data, std::size_t size, limits const & limits = {} )
+    {
+        if ( !check( data, size, limits ).success ) { return std::nullopt; }
+
+        compiled_expression expression;
+        expression.attach( static_cast< std::byte const * >( data ), size );
+        expression.slots_  .assign( expression.field_count_, npos );
+        expression.swapped_.assign( expression.node_count_ , 0    );
+        return expression;
+    }
+
+    /**
+     * Gets the binary image of the compiled expression. It can be stored and
+     * later passed to load or view.
+     *
+     * @return Pointer to the image bytes
+     */
+    [[ nodiscard ]] std::byte const * image_data() const noexcept
+    {
+        return image_;
+    }
+
+    /**
+     * Gets the size of the binary image of the compiled expression.
+     *
+     * @return Number of image bytes
+     */
+    [[ nodiscard ]] std::size_t image_size() const noexcept
+    {
+        return image_size_;
+    }
+
+    /**
+     * Checks whether the expression is empty, i.e. has no nodes.
+     *
+     * @return True if the expression is empty, otherwise false
+     */
+    [[ nodiscard ]] bool empty() const noexcept
+    {
+        return node_count_ == 0;
+    }
+
+    /**
+     * Gets the number of nodes.
+     *
+     * @return Number of nodes
+     */
+    [[ nodiscard ]] std::size_t size() const noexcept
+    {
+        return node_count_;
+    }
+
+    /**
+     * Gets the node at the specified index.
+     *
+     * @param index Node index
+     *
+     * @return Node
+     */
+    [[ nodiscard ]] tree::flat_node const & node( std::uint32_t const index ) const noexcept
+    {
+        return nodes_[ index ];
+    }
+
+    /**
+     * Gets the number of distinct fields referenced by the expression.
+     *
+     * @return Number of fields
+     */
+    [[ nodiscard ]] std::size_t field_count() const noexcept
+    {
+        return field_count_;
+    }
+
+    /**
+     * Gets the name of the field at the specified index.
+     *
+     * @param index Field index
+     *
+     * @return Field name
+     */
+    [[ nodiscard ]] std::string_view field( std::uint32_t const index ) const noexcept
+    {
+        return view( fields_[ index ] );
+    }
+
+    /**
+     * Gets the number of constants.
+     *
+     * @return Number of constants
+     */
+    [[ nodiscard ]] std::size_t constant_count() const noexcept
+    {
+        return constant_count_;
+    }
+
+    /**
+     * Gets the constant at the specified index.
+     *
+     * @param index Constant index
+     *
+     * @return Constant
+     */
+    [[ nodiscard ]] std::string_view constant( std::uint32_t const index ) const noexcept
+    {
+        return view( constants_[ index ] );
+    }
+
+    /**
+     * Checks whether the right operand of the relational operation
+     * is the parameter placeholder rather than the constant.
+     *
+     * @param index Right operand of the relational operation
+     *
+     * @return True if the operand is the parameter, otherwise false
+     */
+    [[ nodiscard ]] static constexpr bool is_parameter( std::uint32_t const index ) noexcept
+    {
+        return ( index & parameter_flag ) != 0;
+    }
+
+    /**
+     * Gets the 0-based index of the parameter, e.g. 0 for $1.
+     *
+     * @param index Right operand of the relational operation
+     *
+     * @return Index of the parameter
+     */
+    [[ nodiscard ]] static constexpr std::uint32_t parameter_index( std::uint32_t const index ) noexcept
+    {
+        return index & ~parameter_flag;
+    }
+
+    /**
+     * Gets the number of parameters, i.e. the highest index of the parameter
+     * placeholders referenced by the expression.
+     *
+     * @return Number of parameters
+     */
+    [[ nodiscard ]] std::size_t parameter_count() const noexcept
+    {
+        return parameter_count_;
+    }
+
+    /**
+     * Binds the values of the parameters, the first one to $1, the second one
+     * to $2 and so on. The values are owned by the compiled expression, whose
+     * frame of them is allocated here, so it may throw std::bad_alloc. The
+     * evaluations supplied with their own frame do not allocate.
+     *
+     * @param values Parameter values
+     */
+    void bind_parameters( std::vector< std::string > values )
+    {
+        parameters_ = std::move( values );
+        frame_      = { std::cbegin( parameters_ ), std::cend( parameters_ ) };
+    }
+
+    /**
+     * Gets the frame of the parameter values bound to the compiled expression,
+     * used whenever the evaluation is not supplied with its own frame.
+     *
+     * @return Frame of the bound parameter values
+     */
+    [[ nodiscard ]] parameter_frame parameters() const noexcept
+    {
+        return frame_;
+    }
+
+    /**
+     * Gets the value the relational operation compares the field against,
+     * i.e. the constant or the value of the parameter.
+     *
+     * @param index Index of the constant or the flagged index of the parameter
+     *
+     * @return Value or std::nullopt if the parameter is not bound
+     */
+    [[ nodiscard ]] std::optional< std::string_view > operand( std::uint32_t const index ) const noexcept
+    {
+        if ( !is_parameter( index ) ) { return constant( index ); }
+
+        auto const position{ parameter_index( index ) };
+        if ( position >= std::size( parameters_ ) ) { return std::nullopt; }
+
+        return parameters_[ position ];
+    }
+
+    /**
+     * Checks whether any field is referenced by more than one relational
+     * operation, i.e. whether its value is worth memoizing per object.
+     *
+     * @return True if any field is referenced more than once, otherwise false
+     */
+    [[ nodiscard ]] bool has_repeated_fields() const noexcept
+    {
+        // every logical operation has two operands, so the relational ones are the other half plus one
+        return ( node_count_ + 1 ) / 2 > field_count_;
+    }
+
+    /**
+     * Binds the fields to the slots of the field provider.
+     *
+     * @param resolve Function mapping field name to the optional slot
+     */
+    template< typename F >
+    void bind( F && resolve ) noexcept
+    {
+        for ( std::uint32_t i{ 0 }; i < field_count_; ++i )
+        {
+            std::optional< std::size_t > const slot{ resolve( field( i ) ) };
+            slots_[ i ] = slot ? static_cast< std::uint32_t >( slot.value() ) : npos;
+        }
+    }
+
+    /**
+     * Gets the slot the field at the specified index is bound to.
+     *
+     * @param index Field index
+     *
+     * @return Slot or npos if the field is not bound
+     */
+    [[ nodiscard ]] std::uint32_t slot( std::uint32_t const index ) const noexcept
+    {
+        return slots_[ index ];
+    }
+
+    /**
+     * Schedules the operands of the logical operations by their estimated cost,
+     * so that the cheaper operand is evaluated first and the more expensive one
+     * is skipped whenever the cheaper one decides the operation. The cost of
+     * a relational operation is the cost of fetching its field, while the cost
+     * of a logical operation assumes its second operand is needed half of the time.
+     * Operands of the same cost keep their order. Like binding, it has to be done
+     * again whenever the fields change. The order is kept in the table allocated
+     * along with the nodes, so scheduling does not allocate.
+     *
+     * @param cost Function mapping field index to the cost of fetching its value
+     */
+    template< typename F >
+    void schedule( F && cost ) noexcept
+    {
+        if ( node_count_ != 0 ) { static_cast< void >( schedule_subtree( 0, cost ) ); }
+    }
+
+    /**
+     * Gets the operand of the logical operation to be evaluated first.
+     *
+     * @param index Index of the logical operation node
+     *
+     * @return Index of the operand node
+     */
+    [[ nodiscard ]] std::uint32_t first_operand( std::uint32_t const index ) const noexcept
+    {
+        auto const & n{ node( index ) };
+        return is_swapped( index ) ? n.right : n.left;
+    }
+
+    /**
+     * Gets the operand of the logical operation to be evaluated second.
+     *
+     * @param index Index of the logical operation node
+     *
+     * @return Index of the operand node
+     */
+    [[ nodiscard ]] std::uint32_t second_operand( std::uint32_t const index ) const noexcept
+    {
+        auto const & n{ node( index ) };
+        return is_swapped( index ) ? n.left : n.right;
+    }
+
+    /**
+     * Gets the number of bytes dynamically allocated by the expression.
+     * The image used in place is not owned, hence not accounted for.
+     *
+     * @return Memory usage
+     */
+    [[ nodiscard ]] booleval::memory_usage memory_usage() const noexcept
+    {
+        booleval::memory_usage usage{};
+        usage.bindings  = slots_.capacity() * sizeof( std::uint32_t ) + swapped_.capacity();
+        usage.constants = parameters_.capacity() * sizeof( std::string ) + frame_.capacity() * sizeof( parameter );
+
+        for ( auto const & value : parameters_ )
+        {
+            // the short strings are stored within std::string itself
+            if ( value.capacity() > std::string{}.capacity() ) { usage.strings += value.capacity() + 1; }
+        }
+
+        if ( !storage_.empty() )
+        {
+            usage.header   = sizeof( header );
+            usage.nodes    = node_count_ * sizeof( tree::flat_node );
+            usage.tables   = ( field_count_ + constant_count_ ) * sizeof( string_ref );
+            usage.strings += pool_size_;
+        }
+
+        return usage;
+    }
+
+private:
+    /**
+     * struct header
+     *
+     * Represents the header of the binary image.
+     */
+    struct header
+    {
+        static constexpr std::uint32_t expected_magic     { 0x50584542 }; // "BEXP"
+        static constexpr std::uint16_t expected_byte_order{ 0x0102     };
+
+        std::uint32_t magic          { expected_magic      };
+        std::uint16_t version        { format_version      };
+        std::uint16_t byte_order     { expected_byte_order };
+        std::uint32_t size           { 0 };
+        std::uint32_t node_count     { 0 };
+        std::uint32_t field_count    { 0 };
+        std::uint32_t constant_count { 0 };
+        std::uint32_t pool_size      { 0 };
+        std::uint32_t parameter_count{ 0 };
+    };
+
+    /**
+     * struct string_ref
+     *
+     * Represents the reference to the string interned into the string pool.
+     */
+    struct string_ref
+    {
+        std::uint32_t offset{ 0 };
+        std::uint32_t length{ 0 };
+    };
+
+    static_assert( std::is_trivially_copyable_v< tree::flat_node > && std::is_standard_layout_v< tree::flat_node > );
+    static_assert( sizeof( tree::flat_node ) == 12 && offsetof( tree::flat_node, left ) == 4 && offsetof( tree::flat_node, right ) == 8 );
+    static_assert( sizeof( header ) == 32 && sizeof( string_ref ) == 8 );
+
+    /**
+     * Gets the total size of the image.
+     *
+     * @param node_count     Number of nodes
+     * @param field_count    Number of fields
+     * @param constant_count Number of constants
+     * @param pool_size      Size of the string pool
+     *
+     * @return Size of the image in bytes
+     */
+    [[ nodiscard ]] static constexpr std::uint64_t image_size
+    (
+        std::uint64_t const node_count,
+        std::uint64_t const field_count,
+        std::uint64_t const constant_count,
+        std::uint64_t const pool_size
+    ) noexcept
+    {
+        return sizeof( header ) +
+               node_count * sizeof( tree::flat_node ) +
+               ( field_count + constant_count ) * sizeof( string_ref ) +
+               pool_size;
+    }
+
+    /**
+     * Checks whether the operands of the logical operation are scheduled
+     * in the reverse order.
+     *
+     * @param index Index of the logical operation node
+     *
+     * @return True if the second operand is evaluated first, otherwise false
+     */
+    [[ nodiscard ]] bool is_swapped( std::uint32_t const index ) const noexcept
+    {
+        return !swapped_.empty() && swapped_[ index ] != 0;
+    }
+
+    /**
+     * Schedules the operands of the logical operations of the subtree.
+     * The recursion is bounded by the nesting limit the image is checked against.
+     *
+     * @param index Index of the subtree root node
+     * @param cost  Function mapping field index to the cost of fetching its value
+     *
+     * @return Estimated cost of the subtree
+     */
+    template< typename F >
+    [[ nodiscard ]] std::uint64_t schedule_subtree( std::uint32_t const index, F & cost ) noexcept
+    {
+        auto const & node{ nodes_[ index ] };
+        auto const is_logical{ node.type == token::token_type::logical_and || node.type == token::token_type::logical_or };
+
+        swapped_[ index ] = 0;
+
+        if ( is_logical && node.has_operands() )
+        {
+            auto first { schedule_subtree( node.left , cost ) };
+            auto second{ schedule_subtree( node.right, cost ) };
+            if ( second < first )
+            {
+                std::swap( first, second );
+                swapped_[ index ] = 1;
+            }
+            return first + second / 2;
+        }
+
+        if ( !is_logical && node.left < field_count_ )
+        {
+            return static_cast< std::uint64_t >( cost( node.left ) );
+        }
+
+        return 0;
+    }
+
+    /**
+     * Points the tables to the image.
+     *
+     * @param image      Image bytes
+     * @param image_size Number of image bytes
+     */
+    void attach( std::byte const * image, std::size_t const image_size ) noexcept
+    {
+        image_      = image;
+        image_size_ = image_size;
+
+        if ( image == nullptr )
+        {
+            nodes_     = nullptr;
+            fields_    = nullptr;
+            constants_ = nullptr;
+            pool_      = nullptr;
+            node_count_ = field_count_ = constant_count_ = pool_size_ = parameter_count_ = 0;
+            return;
+        }
+
+        header h{};
+        std::memcpy( &h, image, sizeof( h ) );
+
+        node_count_     = h.node_count;
+        field_count_    = h.field_count;
+        constant_count_ = h.constant_count;
+        pool_size_      = h.pool_size;
+        parameter_count_ = h.parameter_count;
+
+        auto const * position{ image + sizeof( header ) };
+        nodes_     = reinterpret_cast< tree::flat_node const * >( position ); position += node_count_  * sizeof( tree::flat_node );
+        fields_    = reinterpret_cast< string_ref      const * >( position ); position += field_count_ * sizeof( string_ref      );
+        constants_ = reinterpret_cast< string_ref      const * >( position ); position += constant_count_ * sizeof( string_ref   );
+        pool_      = reinterpret_cast< char            const * >( position );
+    }
+
+    [[ nodiscard ]] std::string_view view( string_ref const ref ) const noexcept
+    {
+        return { pool_ + ref.offset, ref.length };
+    }
+
+    static std::uint32_t flatten
+    (
+        tree::node const & node,
+        std::unordered_map< std::string_view, std::uint32_t > & field_indices,
+        std::vector< tree::flat_node  > & nodes,
+        std::vector< std::string_view > & field_names,
+        std::vector< std::string_view > & constant_values
+    )
+    {
+        auto const index{ static_cast< std::uint32_t >( std::size( nodes ) ) };
+        nodes.emplace_back();
+
+        tree::flat_node flat{ node.token.type() };
+
+        if ( node.left != nullptr && node.right != nullptr )
+        {
+            if ( node.token.is_one_of( token::token_type::logical_and, token::token_type::logical_or ) )
+            {
+                flat.left  = flatten( *node.left , field_indices, nodes, field_names, constant_values );
+                flat.right = flatten( *node.right, field_indices, nodes, field_names, constant_values );
+            }
+            else
+            {
+                auto const name{ node.left->token.value() };
+                auto const [ it, is_inserted ]
+                {
+                    field_indices.try_emplace( name, static_cast< std::uint32_t >( std::size( field_names ) ) )
+                };
+                if ( is_inserted ) { field_names.push_back( name ); }
+
+                flat.left = it->second;
+                if ( node.right->token.is( token::token_type::parameter ) )
+                {
+                    flat.right = parameter_flag | token::to_parameter_index( node.right->token.value() );
+                }
+                else
+                {
+                    flat.right = static_cast< std::uint32_t >( std::size( constant_values ) );
+                    constant_values.push_back( node.right->token.value() );
+                }
+            }
+        }
+
+        nodes[ index ] = flat;
+        return index;
+    }
+
+    /**
+     * Writes the nodes, tables and the distinct field names and constants
+     * into the image which is allocated only once.
+     *
+     * @param nodes           Flattened nodes
+     * @param field_names     Field names referenced by the expression
+     * @param constant_values Constants referenced by the expression
+     */
+    void assemble
+    (
+        std::vector< tree::flat_node  > const & nodes,
+        std::vector< std::string_view > const & field_names,
+        std::vector< std::string_view > const & constant_values
+    )
+    {
+        std::unordered_map< std::string_view, string_ref > refs;
+        std::size_t                                        pool_size{ 0 };
+
+        for ( auto const & strings : { &field_names, &constant_values } )
+        {
+            for ( auto const string : *strings )
+            {
+                auto const [ it, is_inserted ]{ refs.try_emplace( string ) };
+                if ( is_inserted )
+                {
+                    it->second = { static_cast< std::uint32_t >( pool_size ), static_cast< std::uint32_t >( std::size( string ) ) };
+                    pool_size += std::size( string );
+                }
+            }
+        }
+
+        header h{};
+        h.node_count     = static_cast< std::uint32_t >( std::size( nodes           ) );
+        h.field_count    = static_cast< std::uint32_t >( std::size( field_names     ) );
+        h.constant_count = static_cast< std::uint32_t >( std::size( constant_values ) );
+        h.pool_size      = static_cast< std::uint32_t >( pool_size );
+
+        for ( auto const & node : nodes )
+        {
+            auto const is_logical{ node.type == token::token_type::logical_and || node.type == token::token_type::logical_or };
+            if ( !is_logical && is_parameter( node.right ) )
+            {
+                h.parameter_count = std::max( h.parameter_count, parameter_index( node.right ) + 1 );
+            }
+        }
+        h.size           = static_cast< std::uint32_t >( image_size( h.node_count, h.field_count, h.constant_count, h.pool_size ) );
+
+        storage_.assign( h.size, std::byte{ 0 } );
+
+        auto * position{ std::data( storage_ ) };
+        auto const write = [ &position ]( auto const & value ) noexcept
+        {
+            std::memcpy( position, &value, sizeof( value ) );
+            position += sizeof( value );
+        };
+
+        write( h );
+        for ( auto const & node : nodes )
+        {
+            // written member-wise, so that the padding is always zeroed
+            std::memcpy( position + offsetof( tree::flat_node, type  ), &node.type , sizeof( node.type  ) );
+            std::memcpy( position + offsetof( tree::flat_node, left  ), &node.left , sizeof( node.left  ) );
+            std::memcpy( position + offsetof( tree::flat_node, right ), &node.right, sizeof( node.right ) );
+            position += sizeof( tree::flat_node );
+        }
+        for ( auto const name     : field_names     ) { write( refs[ name     ] ); }
+        for ( auto const constant : constant_values ) { write( refs[ constant ] ); }
+        for ( auto const & [ string, ref ] : refs )
+        {
+            std::memcpy( position + ref.offset, std::data( string ), std::size( string ) );
+        }
+
+        attach( std::data( storage_ ), std::size( storage_ ) );
+        slots_  .assign( field_count_, npos );
+        swapped_.assign( node_count_ , 0    );
+    }
+
+private:
+    std::vector< std::byte     > storage_;
+    std::vector< std::uint32_t > slots_;
+    std::vector< std::uint8_t  > swapped_;
+    std::vector< std::string   > parameters_;
+    std::vector< parameter     > frame_;
+
+    std::byte       const * image_          { nullptr };
+    std::size_t             image_size_     { 0 };
+    tree::flat_node const * nodes_          { nullptr };
+    string_ref      const * fields_         { nullptr };
+    string_ref      const * constants_      { nullptr };
+    char            const * pool_           { nullptr };
+    std::uint32_t           node_count_     { 0 };
+    std::uint32_t           field_count_    { 0 };
+    std::uint32_t           constant_count_ { 0 };
+    std::uint32_t           pool_size_      { 0 };
+    std::uint32_t           parameter_count_{ 0 };
+};
+
+inline result compiled_expression::check( void const * data, std::size_t const size, limits const & limits ) noexcept
+{
+    if ( data == nullptr || size < sizeof( header ) )
+    {
+        return { false, "Truncated image" };
+    }
+
+    if ( reinterpret_cast< std::uintptr_t >( data ) % alignof( tree::flat_node ) != 0 )
+    {
+        return { false, "Misaligned image" };
+    }
+
+    auto const * image{ static_cast< std::byte const * >( data ) };
+
+    header h{};
+    std::memcpy( &h, image, sizeof( h ) );
+
+    if ( h.magic      != header::expected_magic      ) { return { false, "Unknown image format"       }; }
+    if ( h.byte_order != header::expected_byte_order ) { return { false, "Unsupported byte order"     }; }
+    if ( h.version    != format_version              ) { return { false, "Unsupported image version"  }; }
+
+    if ( h.size > size || h.size != image_size( h.node_count, h.field_count, h.constant_count, h.pool_size ) )
+    {
+        return { false, "Truncated image" };
+    }
+
+    if ( h.node_count > limits.max_nodes )
+    {
+        return { false, "Too many nodes" };
+    }
+
+    // depth of each node, zero until the node is referenced by its parent
+    std::vector< std::uint32_t > depths( h.node_count, 0 );
+    if ( h.node_count > 0 ) { depths[ 0 ] = 1; }
+
+    auto const * position{ image + sizeof( header ) };
+    for ( std::uint32_t i{ 0 }; i < h.node_count; ++i, position += sizeof( tree::flat_node ) )
+    {
+        tree::flat_node node{};
+        std::memcpy( &node, position, sizeof( node ) );
+
+        // parents always precede their children, so the node is already referenced
+        if ( depths[ i ] == 0 ) { return { false, "Corrupted node" }; }
+        if ( depths[ i ] > limits.max_depth ) { return { false, "Nodes nested too deeply" }; }
+
+        if ( !node.has_operands() ) { continue; }
+
+        if ( node.type == token::token_type::logical_and || node.type == token::token_type::logical_or )
+        {
+            // children always follow their parent, which rules out cycles, and are
+            // referenced only once, which rules out shared subtrees
+            if ( node.left <= i || node.left >= h.node_count || node.right <= i || node.right >= h.node_count )
+            {
+                return { false, "Corrupted node" };
+            }
+
+            if ( node.left == node.right || depths[ node.left ] != 0 || depths[ node.right ] != 0 )
+            {
+                return { false, "Corrupted node" };
+            }
+
+            depths[ node.left  ] = depths[ i ] + 1;
+            depths[ node.right ] = depths[ i ] + 1;
+        }
+        else if ( is_parameter( node.right ) )
+        {
+            if ( node.left >= h.field_count || parameter_index( node.right ) >= h.parameter_count )
+            {
+                return { false, "Corrupted node" };
+            }
+        }
+        else if ( node.left >= h.field_count || node.right >= h.constant_count )
+        {
+            return { false, "Corrupted node" };
+        }
+    }
+
+    for ( std::uint32_t i{ 0 }; i < h.field_count + h.constant_count; ++i, position += sizeof( string_ref ) )
+    {
+        string_ref ref{};
+        std::memcpy( &ref, position, sizeof( ref ) );
+
+        if ( std::uint64_t{ ref.offset } + ref.length > h.pool_size )
+        {
+            return { false, "Corrupted string" };
+        }
+    }
+
+    return { true };
+}
+
+/**
+ * Compiles the expression by building the expression tree and flattening it.
+ *
+ * @param expression Expression to compile
+ * @param limits     Limits of the expression
+ *
+ * @return Compiled expression, empty if the expression is not valid or exceeds the limits
+ */
+inline compiled_expression compile( std::string_view const expression, limits const & limits = {} )
+{
+    auto const root{ tree::build( expression, limits ) };
+    if ( root == nullptr ) { return {}; }
+
+    return compiled_expression{ *root };
+}
+
+} // namespace booleval
+
+#endif // BOOLEVAL_COMPILED_EXPRESSION_HPP
@@ -30,8 +30,11 @@
 #ifndef BOOLEVAL_FIELD_HPP
 #define BOOLEVAL_FIELD_HPP
 
-#include <functional>
+#include <memory>
+#include <cstdint>
+#include <cstring>
 #include <string_view>
+#include <type_traits>
 #include <booleval/utils/any_value.hpp>
 
 namespace booleval
@@ -40,10 +43,55 @@ namespace booleval
 template< typename C >
 struct field;
 
+namespace internal
+{
+
+    template< typename T >
+    struct getter_traits;
+
+    template< typename F, typename R, typename C >
+    struct getter_traits< R ( F::* )( C ) const >
+    {
+        using argument_type = C;
+        using class_type    = std::remove_cv_t< std::remove_reference_t< C > >;
+        using result_type   = R;
+    };
+
+    template< typename F, typename R, typename C >
+    struct getter_traits< R ( F::* )( C ) const noexcept > : getter_traits< R ( F::* )( C ) const > {};
+
+    /**
+     * Identifies the class by the address of its tag, without RTTI.
+     */
+    template< typename C >
+    struct type_tag
+    {
+        static constexpr char id{ 0 };
+    };
+
+} // namespace internal
+
+/**
+ * struct field_options
+ *
+ * Represents the hints about the field used to schedule the evaluation.
+ */
+struct field_options
+{
+    // relative cost of fetching the field value, e.g. 0 for a data member and 100 for a lookup in a side table
+    std::uint32_t cost     { 0    };
+
+    // whether the value fetched once can be reused within the evaluation of the same object
+    bool          cacheable{ true };
+};
+
 /**
  * @class field_base
  *
- * Represents a base class for the field class.
+ * Represents a base class for the field class. The class the field belongs to
+ * and the function reading the field are resolved when the field is made, so
+ * invoking it only compares the class tag, instead of casting dynamically,
+ * and makes a single indirect call to the function typed for the accessor.
  */
 struct field_base
 {
@@ -60,60 +108,227 @@ struct field_base
     virtual ~field_base() = default;
 
     template< typename C >
-    utils::any_value invoke( C && obj ) noexcept
+    utils::any_value invoke( C && obj ) const noexcept
     {
-        auto const * f{ dynamic_cast< field< std::remove_reference_t< C > >* >( this ) };
+        using class_type = std::remove_cv_t< std::remove_reference_t< C > >;
 
-        if ( f == nullptr ) { return {}; }
+        if ( type_ != &internal::type_tag< class_type >::id ) { return {}; }
 
-        return f->get( std::move( obj ));
+        return read( std::addressof( obj ) );
+    }
+
+    std::string_view name   {};
+    field_options    options{};
+
+protected:
+    using reader = utils::any_value ( * )( field_base const &, void const * );
+
+    field_base( std::string_view const name, void const * const type, reader const r ) noexcept
+        : name   { name }
+        , type_  { type }
+        , reader_{ r    }
+    {}
+
+    [[ nodiscard ]] utils::any_value read( void const * const obj ) const noexcept
+    {
+        return reader_( *this, obj );
     }
 
-    std::string_view name{};
+private:
+    void const * type_  { nullptr };
+    reader       reader_{ nullptr };
 };
 
 /**
  * @class field
  *
- * Contains string representation of a certain class field and
- * getter class member function associated to this field.
+ * Contains string representation of a certain class field and the accessor
+ * (const getter class member function, data member or free function) associated
+ * to this field. The accessor is stored as a raw pointer together with the plain
+ * function, instantiated for its type, that reads the field through it, so no
+ * allocation or type erasure through std::function is involved.
  */
 template< typename C >
 struct field : field_base
 {
-    field() = default;
+    field() noexcept : field_base{ {}, &internal::type_tag< C >::id, &read_none } {}
 
     field( field       && rhs ) = default;
     field( field const  & rhs ) = default;
 
     template< typename R >
-    field( std::string_view const name, R ( C::*m )() ) noexcept : field_base{ name }
+    field( std::string_view const name, R ( C::*m )() const ) noexcept
+        : field_base{ name, &internal::type_tag< C >::id, &read_getter< R > }
     {
-        get = [ m ]( C && obj )
-        {
-            return ( obj.*m )();
-        };
+        store( m );
+    }
+
+    template
+    <
+        typename R,
+        typename = std::enable_if_t< !std::is_function_v< R > >
+    >
+    field( std::string_view const name, R C::*m ) noexcept
+        : field_base{ name, &internal::type_tag< C >::id, &read_member< R > }
+    {
+        store( m );
     }
 
     template< typename R >
-    field( std::string_view const name, R ( C::*m )() const ) noexcept : field_base{ name }
+    field( std::string_view const name, R ( *f )( C const & ) ) noexcept
+        : field_base{ name, &internal::type_tag< C >::id, &read_function< R, C const & > }
     {
-        get = [ m ]( C && obj )
-        {
-            return ( obj.*m )();
-        };
+        store( f );
+    }
+
+    template< typename R >
+    field( std::string_view const name, R ( *f )( C ) ) noexcept
+        : field_base{ name, &internal::type_tag< C >::id, &read_function< R, C > }
+    {
+        store( f );
     }
 
     field & operator=( field       && rhs ) = default;
     field & operator=( field const  & rhs ) = default;
 
-    std::function< utils::any_value( C && ) > get{ nullptr };
+    /**
+     * Gets the field value of the object passed in.
+     *
+     * @param obj Object to get the field value from
+     *
+     * @return Field value
+     */
+    utils::any_value get( C const & obj ) const noexcept
+    {
+        return read( std::addressof( obj ) );
+    }
+
+private:
+    // Big enough for any kind of pointer to member of C as well as for plain function pointers
+    struct storage
+    {
+        alignas( void * ) unsigned char bytes[ sizeof( void ( C::* )() ) ];
+    };
+
+    template< typename P >
+    void store( P const p ) noexcept
+    {
+        static_assert( sizeof( P ) <= sizeof( storage ), "Accessor does not fit into field storage." );
+        std::memcpy( storage_.bytes, &p, sizeof( P ) );
+    }
+
+    template< typename P >
+    [[ nodiscard ]] static P load( field_base const & f ) noexcept
+    {
+        P p;
+        std::memcpy( &p, static_cast< field const & >( f ).storage_.bytes, sizeof( P ) );
+        return p;
+    }
+
+    [[ nodiscard ]] static utils::any_value read_none( field_base const &, void const * ) noexcept
+    {
+        return {};
+    }
+
+    template< typename R >
+    [[ nodiscard ]] static utils::any_value read_getter( field_base const & f, void const * const obj ) noexcept
+    {
+        return ( static_cast< C const * >( obj )->*load< R ( C::* )() const >( f ) )();
+    }
+
+    template< typename R >
+    [[ nodiscard ]] static utils::any_value read_member( field_base const & f, void const * const obj ) noexcept
+    {
+        return static_cast< C const * >( obj )->*load< R C::* >( f );
+    }
+
+    template< typename R, typename A >
+    [[ nodiscard ]] static utils::any_value read_function( field_base const & f, void const * const obj ) noexcept
+    {
+        return load< R ( * )( A ) >( f )( *static_cast< C const * >( obj ) );
+    }
+
+    storage storage_{};
 };
 
+namespace internal
+{
+
+    template< typename C >
+    [[ nodiscard ]] field< C > * with_options( field< C > * const f, field_options const & options ) noexcept
+    {
+        f->options = options;
+        return f;
+    }
+
+} // namespace internal
+
+/**
+ * Makes a field out of a getter class member function.
+ */
+template< typename C, typename R >
+auto make_field( std::string_view const name, R( C::*m )() const, field_options const & options = {} ) noexcept
+{
+    return internal::with_options( new field< C >( name, m ), options );
+}
+
+/**
+ * Makes a field out of a data member.
+ */
+template
+<
+    typename C,
+    typename R,
+    typename = std::enable_if_t< !std::is_function_v< R > >
+>
+auto make_field( std::string_view const name, R C::*m, field_options const & options = {} ) noexcept
+{
+    return internal::with_options( new field< C >( name, m ), options );
+}
+
+/**
+ * Makes a field out of a free function accepting the object.
+ */
+template< typename C, typename R >
+auto make_field( std::string_view const name, R( *f )( C const & ), field_options const & options = {} ) noexcept
+{
+    return internal::with_options( new field< C >( name, f ), options );
+}
+
+/**
+ * Makes a field out of a free function accepting the object by value.
+ */
 template< typename C, typename R >
-auto make_field( std::string_view const name, R( C::*m )() const ) noexcept
+auto make_field( std::string_view const name, R( *f )( C ), field_options const & options = {} ) noexcept
 {
-    return new field< C >( name, m );
+    return internal::with_options( new field< C >( name, f ), options );
+}
+
+/**
+ * Makes a field out of a stateless lambda accepting the object, either
+ * by value or by const reference. Lambda gets converted to a plain function pointer.
+ */
+template
+<
+    typename F,
+    typename = std::enable_if_t< std::is_class_v< F > && std::is_empty_v< F > >
+>
+auto make_field( std::string_view const name, F const f, field_options const & options = {} ) noexcept
+{
+    using traits = internal::getter_traits< decltype( &F::operator() ) >;
+    using A      = typename traits::argument_type;
+    using C      = typename traits::class_type;
+    using R      = typename traits::result_type;
+
+    static_assert
+    (
+        std::is_same_v< A, C > || std::is_same_v< A, C const > || std::is_same_v< A, C const & >,
+        "Lambda must accept the object by value or by const reference."
+    );
+
+    using P      = std::conditional_t< std::is_reference_v< A >, C const &, C >;
+
+    return internal::with_options( new field< C >( name, static_cast< R ( * )( P ) >( f ) ), options );
 }
 
 } // namespace booleval
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_LIMITS_HPP
+#define BOOLEVAL_LIMITS_HPP
+
+#include <limits>
+#include <cstddef>
+
+namespace booleval
+{
+
+/**
+ * struct limits
+ *
+ * Represents the limits of an expression enforced while tokenizing and parsing it,
+ * and of the nodes of a compiled expression image enforced while checking it.
+ * An expression exceeding any of them is rejected as soon as the limit is reached,
+ * so that a pathological expression, e.g. deeply nested or extremely long one
+ * supplied by a user, neither exhausts the stack nor stalls the thread. The
+ * defaults leave enough room for any expression written by hand.
+ */
+struct limits
+{
+    std::size_t max_length       { 1U << 20 }; // bytes of the whole expression
+    std::size_t max_tokens       { 1U << 17 }; // tokens, including the implicit equality operators
+    std::size_t max_literal_bytes{ 1U << 16 }; // bytes of a single field name or constant
+    std::size_t max_nodes        { 1U << 17 }; // nodes of the expression tree
+    std::size_t max_depth        { 1U << 10 }; // nesting of parentheses, or of the nodes of an image
+
+    /**
+     * Gets the limits that never reject an expression.
+     *
+     * @return Limits set to the maximum values
+     */
+    [[ nodiscard ]] static constexpr limits unlimited() noexcept
+    {
+        constexpr auto max{ std::numeric_limits< std::size_t >::max() };
+        return { max, max, max, max, max };
+    }
+};
+
+} // namespace booleval
+
+#endif // BOOLEVAL_LIMITS_HPP
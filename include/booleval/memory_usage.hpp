@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_MEMORY_USAGE_HPP
+#define BOOLEVAL_MEMORY_USAGE_HPP
+
+#include <cstddef>
+
+namespace booleval
+{
+
+/**
+ * struct memory_usage
+ *
+ * Represents the number of bytes dynamically allocated by an expression,
+ * broken down by the kind of data they hold. The size of the object itself,
+ * i.e. sizeof, is not included.
+ */
+struct memory_usage
+{
+    std::size_t header   { 0 }; // header of the binary image
+    std::size_t nodes    { 0 }; // expression nodes
+    std::size_t tables   { 0 }; // tables of the field names and of the constants
+    std::size_t constants{ 0 }; // parameter values compared against
+    std::size_t strings  { 0 }; // string storage owned by the expression
+    std::size_t bindings { 0 }; // slots the fields are bound to and the schedule of the operands
+
+    /**
+     * Gets the total number of bytes.
+     *
+     * @return Total number of bytes
+     */
+    [[ nodiscard ]] constexpr std::size_t total() const noexcept
+    {
+        return header + nodes + tables + constants + strings + bindings;
+    }
+
+    constexpr memory_usage & operator+=( memory_usage const & rhs ) noexcept
+    {
+        header    += rhs.header;
+        nodes     += rhs.nodes;
+        tables    += rhs.tables;
+        constants += rhs.constants;
+        strings   += rhs.strings;
+        bindings  += rhs.bindings;
+        return *this;
+    }
+
+    [[ nodiscard ]] friend constexpr memory_usage operator+( memory_usage lhs, memory_usage const & rhs ) noexcept
+    {
+        return lhs += rhs;
+    }
+};
+
+/**
+ * Gets the memory usage of all the expressions in the range, e.g. the rule set.
+ *
+ * @param expressions Range of expressions providing memory_usage member function
+ *
+ * @return Accumulated memory usage
+ */
+template< typename Range >
+[[ nodiscard ]] memory_usage total_memory_usage( Range const & expressions ) noexcept
+{
+    memory_usage total{};
+    for ( auto const & expression : expressions )
+    {
+        total += expression.memory_usage();
+    }
+    return total;
+}
+
+} // namespace booleval
+
+#endif // BOOLEVAL_MEMORY_USAGE_HPP
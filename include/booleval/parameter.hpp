@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_PARAMETER_HPP
+#define BOOLEVAL_PARAMETER_HPP
+
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <initializer_list>
+
+#include <booleval/utils/any_value.hpp>
+#include <booleval/utils/compare_utils.hpp>
+#include <booleval/utils/string_utils.hpp>
+
+namespace booleval
+{
+
+/**
+ * @class parameter
+ *
+ * Represents the typed value of the parameter placeholder, e.g. $1, either
+ * a number or a text. It does not own the text, which has to outlive
+ * the evaluations it is used in.
+ *
+ * A text is compared against field values the same way the constant would
+ * be, except that it is parsed into a number only once, up front. A number
+ * is compared numerically, against string fields as well, which never
+ * match unless their values are numbers too.
+ */
+class parameter
+{
+public:
+    constexpr parameter() noexcept = default;
+
+    // null pointer is the unbound parameter, since it does not make a string view
+    parameter( char const * const text ) noexcept
+    : parameter{ text == nullptr ? parameter{} : parameter{ std::string_view{ text } } }
+    {}
+
+    parameter( std::string_view const text ) noexcept
+    : parameter{ text, utils::from_chars< double >( text ) }
+    {}
+
+    template
+    <
+        typename T,
+        typename = std::enable_if_t< std::is_arithmetic_v< T > >
+    >
+    constexpr parameter( T const number ) noexcept
+    : number_   { static_cast< double >( number ) }
+    , is_bound_ { true }
+    , is_number_{ true }
+    {}
+
+    /**
+     * Checks whether the parameter holds any value.
+     *
+     * @return True if the parameter holds the value, otherwise false
+     */
+    [[ nodiscard ]] constexpr bool is_bound() const noexcept
+    {
+        return is_bound_;
+    }
+
+    /**
+     * Compares the field value against the parameter.
+     *
+     * @param value Value of the field in its native type
+     * @param f     Comparison function
+     *
+     * @return True if the comparison holds, false otherwise or if the values are not comparable
+     */
+    template< typename T, typename F >
+    [[ nodiscard ]] bool compare( T const & value, F && f ) const noexcept
+    {
+        using value_type = std::decay_t< T >;
+
+        if constexpr ( std::is_same_v< value_type, double > || ( std::is_arithmetic_v< value_type > && !std::is_floating_point_v< value_type > ) )
+        {
+            // the number parsed up front is exactly the one the constant would be parsed into
+            return is_number_ && f( static_cast< double >( value ), number_ );
+        }
+        else if constexpr ( std::is_floating_point_v< value_type > )
+        {
+            if ( is_text_ ) { return utils::compare( value, text_, std::forward< F >( f ) ); }
+            return is_number_ && f( value, static_cast< value_type >( number_ ) );
+        }
+        else if ( is_text_ )
+        {
+            return utils::compare( value, text_, std::forward< F >( f ) );
+        }
+        else if constexpr ( std::is_same_v< value_type, utils::any_value > )
+        {
+            if ( value.is_float() )
+            {
+                // compared in single precision, the same way as the float field itself
+                auto const arithmetic_value{ utils::from_chars< float >( value.value() ) };
+                return is_number_ && arithmetic_value && f( arithmetic_value.value(), static_cast< float >( number_ ) );
+            }
+            return compare_number( value.value(), std::forward< F >( f ) );
+        }
+        else if constexpr ( std::is_convertible_v< T const &, std::string_view > )
+        {
+            return compare_number( std::string_view{ value }, std::forward< F >( f ) );
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+private:
+    parameter( std::string_view const text, std::optional< double > const number ) noexcept
+    : text_     { text }
+    , number_   { number.value_or( 0.0 ) }
+    , is_bound_ { true }
+    , is_number_{ number.has_value() }
+    , is_text_  { true }
+    {}
+
+    template< typename F >
+    [[ nodiscard ]] bool compare_number( std::string_view const value, F && f ) const noexcept
+    {
+        auto const arithmetic_value{ utils::from_chars< double >( value ) };
+        return is_number_ && arithmetic_value && f( arithmetic_value.value(), number_ );
+    }
+
+    std::string_view text_     {};
+    double           number_   { 0.0 };
+    bool             is_bound_ { false };
+    bool             is_number_{ false };
+    bool             is_text_  { false };
+};
+
+/**
+ * @class parameter_frame
+ *
+ * Represents the non-owning view of the parameter values, the first one bound
+ * to $1, the second one to $2 and so on. The frame is supplied along with
+ * the object to be evaluated, so that many threads can evaluate the same
+ * compiled expression, each one against its own parameters, without locking
+ * and without allocating. Parameters beyond the frame are unbound.
+ */
+class parameter_frame
+{
+public:
+    constexpr parameter_frame() noexcept = default;
+
+    constexpr parameter_frame( parameter const * const data, std::size_t const size ) noexcept
+    : data_{ data }
+    , size_{ size }
+    {}
+
+    parameter_frame( std::vector< parameter > const & parameters ) noexcept
+    : parameter_frame{ std::data( parameters ), std::size( parameters ) }
+    {}
+
+    /**
+     * Creates the frame from the braced list of values, e.g. { 10, "foo" }.
+     * The list lives until the end of the full expression it is written in,
+     * i.e. the frame can be passed to the evaluation, but not stored.
+     *
+     * @param parameters Parameter values
+     */
+    constexpr parameter_frame( std::initializer_list< parameter > const parameters ) noexcept
+    : parameter_frame{ std::data( parameters ), std::size( parameters ) }
+    {}
+
+    /**
+     * Gets the number of parameters in the frame.
+     *
+     * @return Number of parameters
+     */
+    [[ nodiscard ]] constexpr std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    /**
+     * Gets the parameter by its 0-based index, e.g. 0 for $1.
+     *
+     * @param index Index of the parameter
+     *
+     * @return Parameter or the unbound one if the index is beyond the frame
+     */
+    [[ nodiscard ]] constexpr parameter const & operator[]( std::size_t const index ) const noexcept
+    {
+        return index < size_ ? data_[ index ] : unbound_;
+    }
+
+private:
+    static constexpr parameter unbound_{};
+
+    parameter   const * data_{ nullptr };
+    std::size_t         size_{ 0 };
+};
+
+} // namespace booleval
+
+#endif // BOOLEVAL_PARAMETER_HPP
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_RULE_SET_HPP
+#define BOOLEVAL_RULE_SET_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string_view>
+
+#include <booleval/result.hpp>
+#include <booleval/memory_usage.hpp>
+#include <booleval/compiled_expression.hpp>
+#include <booleval/utils/mapped_file.hpp>
+
+namespace booleval
+{
+
+/**
+ * @class rule_set
+ *
+ * Represents the set of compiled expressions, i.e. rules. The rule set can be
+ * saved to the snapshot file with the layout:
+ *
+ *     header | index | image of rule 0 | image of rule 1 | ...
+ *
+ * The index holds the offset and size of each rule image relative to the
+ * beginning of the snapshot, so the snapshot is position independent. Once
+ * mapped into memory, the rules are used in place. Hence, all the processes
+ * mapping the same snapshot file share one physical copy of the rules, while
+ * each of them keeps only its own field bindings.
+ */
+class rule_set
+{
+public:
+    static constexpr std::uint16_t format_version{ 1 };
+
+    using iterator       = std::vector< compiled_expression >::iterator;
+    using const_iterator = std::vector< compiled_expression >::const_iterator;
+
+    /**
+     * Adds the rule to the set.
+     *
+     * @param expression Compiled expression
+     *
+     * @return Index of the rule
+     */
+    std::size_t add( compiled_expression expression )
+    {
+        rules_.push_back( std::move( expression ) );
+        return std::size( rules_ ) - 1;
+    }
+
+    /**
+     * Binds the fields of all the rules, e.g. by using the result or schema visitor.
+     *
+     * @param visitor Visitor binding the compiled expressions
+     */
+    template< typename Visitor >
+    void bind( Visitor const & visitor ) noexcept
+    {
+        for ( auto & rule : rules_ )
+        {
+            visitor.bind( rule );
+        }
+    }
+
+    [[ nodiscard ]] bool        empty() const noexcept { return rules_.empty();   }
+    [[ nodiscard ]] std::size_t size () const noexcept { return std::size( rules_ ); }
+
+    [[ nodiscard ]] compiled_expression       & operator[]( std::size_t const index )       noexcept { return rules_[ index ]; }
+    [[ nodiscard ]] compiled_expression const & operator[]( std::size_t const index ) const noexcept { return rules_[ index ]; }
+
+    [[ nodiscard ]] iterator       begin()       noexcept { return std::begin ( rules_ ); }
+    [[ nodiscard ]] iterator       end  ()       noexcept { return std::end  ( rules_ ); }
+    [[ nodiscard ]] const_iterator begin() const noexcept { return std::cbegin( rules_ ); }
+    [[ nodiscard ]] const_iterator end  () const noexcept { return std::cend  ( rules_ ); }
+
+    /**
+     * Gets the number of bytes dynamically allocated by the rules.
+     * The snapshot the rules are used from is not accounted for.
+     *
+     * @return Memory usage
+     */
+    [[ nodiscard ]] booleval::memory_usage memory_usage() const noexcept
+    {
+        return total_memory_usage( rules_ );
+    }
+
+    /**
+     * Creates the snapshot of the rule set.
+     *
+     * @return Snapshot bytes
+     */
+    [[ nodiscard ]] std::vector< std::byte > snapshot() const;
+
+    /**
+     * Saves the snapshot of the rule set to the file.
+     *
+     * @param path Path of the snapshot file
+     *
+     * @return True if the snapshot is saved, otherwise false
+     */
+    [[ nodiscard ]] bool save( std::string_view const path ) const
+    {
+        auto const bytes{ snapshot() };
+
+        std::ofstream file{ std::string{ path }, std::ios::binary | std::ios::trunc };
+        file.write( reinterpret_cast< char const * >( std::data( bytes ) ), static_cast< std::streamsize >( std::size( bytes ) ) );
+        return static_cast< bool >( file.flush() );
+    }
+
+    /**
+     * Checks whether the bytes contain a valid snapshot, including all the rule images.
+     *
+     * @param data Snapshot bytes
+     * @param size Number of snapshot bytes
+     *
+     * @return Result containing the message of the first error found
+     */
+    [[ nodiscard ]] static result check( void const * data, std::size_t size ) noexcept;
+
+    /**
+     * Uses the snapshot in place, without copying the rules. The snapshot has
+     * to outlive the rule set.
+     *
+     * @param data Snapshot bytes, aligned to 8 bytes
+     * @param size Number of snapshot bytes
+     *
+     * @return Rule set if the snapshot is valid, otherwise std::nullopt
+     */
+    [[ nodiscard ]] static std::optional< rule_set > view( void const * data, std::size_t size );
+
+    /**
+     * Maps the snapshot file into memory and uses it in place. The mapping
+     * is kept alive by the rule set and its copies.
+     *
+     * @param path Path of the snapshot file
+     *
+     * @return Rule set if the snapshot is valid, otherwise std::nullopt
+     */
+    [[ nodiscard ]] static std::optional< rule_set > map( std::string_view const path )
+    {
+        auto file{ std::make_shared< utils::mapped_file >( path ) };
+        if ( !file->is_mapped() ) { return std::nullopt; }
+
+        auto rules{ view( file->data(), file->size() ) };
+        if ( rules )
+        {
+            rules->file_ = std::move( file );
+        }
+        return rules;
+    }
+
+private:
+    /**
+     * struct header
+     *
+     * Represents the header of the snapshot.
+     */
+    struct header
+    {
+        static constexpr std::uint32_t expected_magic     { 0x54535242 }; // "BRST"
+        static constexpr std::uint16_t expected_byte_order{ 0x0102     };
+
+        std::uint32_t magic     { expected_magic      };
+        std::uint16_t version   { format_version      };
+        std::uint16_t byte_order{ expected_byte_order };
+        std::uint64_t size      { 0 };
+        std::uint64_t count     { 0 };
+    };
+
+    /**
+     * struct entry
+     *
+     * Represents the index entry of the rule image.
+     */
+    struct entry
+    {
+        std::uint64_t offset{ 0 };
+        std::uint64_t size  { 0 };
+    };
+
+    static constexpr std::size_t alignment{ 8 };
+
+    static_assert( sizeof( header ) == 24 && sizeof( entry ) == 16 );
+
+    /**
+     * Checks the snapshot header and index, but not the rule images.
+     *
+     * @param data Snapshot bytes
+     * @param size Number of snapshot bytes
+     *
+     * @return Result containing the message of the first error found
+     */
+    [[ nodiscard ]] static result check_index( void const * data, std::size_t size ) noexcept;
+
+    /**
+     * Gets the index entry of the rule.
+     *
+     * @param data  Snapshot bytes
+     * @param index Rule index
+     *
+     * @return Index entry
+     */
+    [[ nodiscard ]] static entry read_entry( void const * data, std::uint64_t const index ) noexcept
+    {
+        entry e{};
+        std::memcpy( &e, static_cast< std::byte const * >( data ) + sizeof( header ) + index * sizeof( entry ), sizeof( e ) );
+        return e;
+    }
+
+private:
+    std::vector< compiled_expression >          rules_;
+    std::shared_ptr< utils::mapped_file const > file_;
+};
+
+inline std::vector< std::byte > rule_set::snapshot() const
+{
+    auto const align = []( std::uint64_t const offset ) noexcept
+    {
+        return ( offset + alignment - 1 ) / alignment * alignment;
+    };
+
+    header h{};
+    h.count = std::size( rules_ );
+
+    std::vector< entry > index( std::size( rules_ ) );
+
+    std::uint64_t offset{ sizeof( header ) + std::size( index ) * sizeof( entry ) };
+    for ( std::size_t i{ 0 }; i < std::size( rules_ ); ++i )
+    {
+        offset = align( offset );
+        index[ i ] = { offset, rules_[ i ].image_size() };
+        offset += rules_[ i ].image_size();
+    }
+    h.size = offset;
+
+    std::vector< std::byte > bytes( static_cast< std::size_t >( h.size ), std::byte{ 0 } );
+    std::memcpy( std::data( bytes ), &h, sizeof( h ) );
+    std::memcpy( std::data( bytes ) + sizeof( h ), std::data( index ), std::size( index ) * sizeof( entry ) );
+
+    for ( std::size_t i{ 0 }; i < std::size( rules_ ); ++i )
+    {
+        if ( rules_[ i ].image_size() == 0 ) { continue; }
+        std::memcpy( std::data( bytes ) + index[ i ].offset, rules_[ i ].image_data(), rules_[ i ].image_size() );
+    }
+
+    return bytes;
+}
+
+inline result rule_set::check_index( void const * data, std::size_t const size ) noexcept
+{
+    if ( data == nullptr || size < sizeof( header ) )
+    {
+        return { false, "Truncated snapshot" };
+    }
+
+    if ( reinterpret_cast< std::uintptr_t >( data ) % alignment != 0 )
+    {
+        return { false, "Misaligned snapshot" };
+    }
+
+    header h{};
+    std::memcpy( &h, data, sizeof( h ) );
+
+    if ( h.magic      != header::expected_magic      ) { return { false, "Unknown snapshot format"      }; }
+    if ( h.byte_order != header::expected_byte_order ) { return { false, "Unsupported byte order"       }; }
+    if ( h.version    != format_version              ) { return { false, "Unsupported snapshot version" }; }
+
+    if ( h.size > size || h.count > ( h.size - sizeof( header ) ) / sizeof( entry ) )
+    {
+        return { false, "Truncated snapshot" };
+    }
+
+    auto const index_end{ sizeof( header ) + h.count * sizeof( entry ) };
+    for ( std::uint64_t i{ 0 }; i < h.count; ++i )
+    {
+        auto const e{ read_entry( data, i ) };
+        if ( e.offset < index_end || e.offset % alignment != 0 || e.offset > h.size || e.size > h.size - e.offset )
+        {
+            return { false, "Corrupted snapshot index" };
+        }
+    }
+
+    return { true };
+}
+
+inline result rule_set::check( void const * data, std::size_t const size ) noexcept
+{
+    auto const index{ check_index( data, size ) };
+    if ( !index.success ) { return index; }
+
+    header h{};
+    std::memcpy( &h, data, sizeof( h ) );
+
+    for ( std::uint64_t i{ 0 }; i < h.count; ++i )
+    {
+        auto const e{ read_entry( data, i ) };
+        if ( e.size == 0 ) { continue; }
+
+        auto const rule{ compiled_expression::check( static_cast< std::byte const * >( data ) + e.offset, e.size ) };
+        if ( !rule.success ) { return rule; }
+    }
+
+    return { true };
+}
+
+inline std::optional< rule_set > rule_set::view( void const * data, std::size_t const size )
+{
+    if ( !check_index( data, size ).success ) { return std::nullopt; }
+
+    header h{};
+    std::memcpy( &h, data, sizeof( h ) );
+
+    rule_set rules;
+    rules.rules_.reserve( h.count );
+
+    for ( std::uint64_t i{ 0 }; i < h.count; ++i )
+    {
+        auto const e{ read_entry( data, i ) };
+        if ( e.size == 0 )
+        {
+            rules.rules_.emplace_back();
+            continue;
+        }
+
+        auto rule{ compiled_expression::view( static_cast< std::byte const * >( data ) + e.offset, e.size ) };
+        if ( !rule ) { return std::nullopt; }
+
+        rules.rules_.push_back( std::move( rule.value() ) );
+    }
+
+    return rules;
+}
+
+} // namespace booleval
+
+#endif // BOOLEVAL_RULE_SET_HPP
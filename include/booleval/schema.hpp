@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_SCHEMA_HPP
+#define BOOLEVAL_SCHEMA_HPP
+
+#include <array>
+#include <tuple>
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <functional>
+#include <string_view>
+
+namespace booleval
+{
+
+namespace internal
+{
+
+    template< std::size_t N >
+    [[ nodiscard ]] constexpr bool has_unique_names( std::array< std::string_view, N > const & names ) noexcept
+    {
+        for ( std::size_t i{ 0 }; i < N; ++i )
+        {
+            for ( std::size_t j{ i + 1 }; j < N; ++j )
+            {
+                if ( names[ i ] == names[ j ] ) { return false; }
+            }
+        }
+        return true;
+    }
+
+} // namespace internal
+
+/**
+ * @struct static_field
+ *
+ * Describes a field known at compile time, i.e. its name and
+ * the class member (getter or data member) holding its value.
+ */
+template< char const * Name, auto Member >
+struct static_field
+{
+    static constexpr std::string_view name{ Name };
+
+    /**
+     * Gets the field value in its native type.
+     *
+     * @param obj Object to get the field value from
+     *
+     * @return Field value
+     */
+    template< typename C >
+    [[ nodiscard ]] static decltype( auto ) get( C const & obj ) noexcept
+    {
+        return std::invoke( Member, obj );
+    }
+};
+
+/**
+ * @class schema
+ *
+ * Represents the set of fields of a certain class known at compile time.
+ * Fields are identified by their slot, i.e. the position within the schema,
+ * so that no heap allocation or virtual dispatch is needed to access them.
+ */
+template< typename C, typename ... Fields >
+class schema
+{
+public:
+    using class_type = C;
+
+    static constexpr std::size_t size{ sizeof ... ( Fields ) };
+
+    /**
+     * Finds the slot of the field with the specified name.
+     *
+     * @param name Field name
+     *
+     * @return Slot of the field if found, otherwise std::nullopt
+     */
+    [[ nodiscard ]] static constexpr std::optional< std::size_t > index_of( std::string_view const name ) noexcept
+    {
+        for ( std::size_t i{ 0 }; i < size; ++i )
+        {
+            if ( names[ i ] == name ) { return i; }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * Invokes the function with the native value of the field in the specified slot.
+     *
+     * @param slot Field slot
+     * @param obj  Object to get the field value from
+     * @param f    Function to invoke with the field value
+     *
+     * @return Result of the function or false if the slot is out of range
+     */
+    template< typename F >
+    [[ nodiscard ]] static bool visit( std::size_t const slot, C const & obj, F && f ) noexcept
+    {
+        return visit< 0 >( slot, obj, f );
+    }
+
+private:
+    /**
+     * Invokes the function with the value of the field in the specified slot,
+     * dispatching on the block of eight slots starting at Base. The switch is
+     * compiled into a jump table, with the function inlined into each case,
+     * rather than into the chain of comparisons of the slot against each field.
+     */
+    template< std::size_t Base, typename F >
+    [[ nodiscard ]] static bool visit( std::size_t const slot, C const & obj, F & f ) noexcept
+    {
+        if constexpr ( Base >= size )
+        {
+            static_cast< void >( slot );
+            static_cast< void >( obj  );
+            static_cast< void >( f    );
+            return false;
+        }
+        else
+        {
+            switch ( slot - Base )
+            {
+                case 0 : return visit_field< Base + 0 >( obj, f );
+                case 1 : return visit_field< Base + 1 >( obj, f );
+                case 2 : return visit_field< Base + 2 >( obj, f );
+                case 3 : return visit_field< Base + 3 >( obj, f );
+                case 4 : return visit_field< Base + 4 >( obj, f );
+                case 5 : return visit_field< Base + 5 >( obj, f );
+                case 6 : return visit_field< Base + 6 >( obj, f );
+                case 7 : return visit_field< Base + 7 >( obj, f );
+                default: return visit< Base + 8 >( slot, obj, f );
+            }
+        }
+    }
+
+    template< std::size_t I, typename F >
+    [[ nodiscard ]] static bool visit_field( C const & obj, F & f ) noexcept
+    {
+        if constexpr ( I < size )
+        {
+            return f( std::tuple_element_t< I, std::tuple< Fields ... > >::get( obj ) );
+        }
+        else
+        {
+            static_cast< void >( obj );
+            static_cast< void >( f   );
+            return false;
+        }
+    }
+
+    static constexpr std::array< std::string_view, size > names{ Fields::name ... };
+
+    static_assert( internal::has_unique_names( names ), "Schema field names must be unique." );
+};
+
+} // namespace booleval
+
+#endif // BOOLEVAL_SCHEMA_HPP
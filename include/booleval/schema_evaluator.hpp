@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_SCHEMA_EVALUATOR_HPP
+#define BOOLEVAL_SCHEMA_EVALUATOR_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <string_view>
+
+#include <booleval/schema.hpp>
+#include <booleval/limits.hpp>
+#include <booleval/result.hpp>
+#include <booleval/parameter.hpp>
+#include <booleval/compiled_expression.hpp>
+#include <booleval/tree/schema_visitor.hpp>
+
+namespace booleval
+{
+
+/**
+ * @class schema_evaluator
+ *
+ * Represents a class for evaluating logical expressions in a form of a string
+ * against the objects whose fields are described by the schema known at compile time.
+ */
+template< typename Schema >
+class schema_evaluator
+{
+public:
+    using class_type = typename Schema::class_type;
+
+    schema_evaluator() noexcept = default;
+
+    schema_evaluator( schema_evaluator       && rhs ) noexcept = default;
+    schema_evaluator( schema_evaluator const  & rhs ) noexcept = delete;
+
+    schema_evaluator& operator=( schema_evaluator       && rhs ) noexcept = default;
+    schema_evaluator& operator=( schema_evaluator const  & rhs ) noexcept = delete;
+
+    ~schema_evaluator() noexcept = default;
+
+    /**
+     * Sets the limits of the expressions set from now on, e.g. the ones
+     * supplied by users, which are rejected once they exceed any of the limits.
+     *
+     * @param limits Limits of the expression
+     */
+    void limits( booleval::limits const & limits ) noexcept
+    {
+        limits_ = limits;
+    }
+
+    /**
+     * Checks whether the evaluation is activated or not, i.e.
+     * if the expression tree is successfully built.
+     *
+     * @return True if the evaluation is activated, otherwise false
+     */
+    [[ nodiscard ]] bool is_activated() const noexcept
+    {
+        return is_activated_;
+    }
+
+    /**
+     * Sets the expression to be used for evaluation.
+     *
+     * @param expression Expression to be used for evaluation
+     *
+     * @return True if the expression is valid, otherwise false
+     */
+    [[ nodiscard ]] bool expression( std::string_view const expression ) noexcept
+    {
+        is_activated_ = false;
+        validation_   = { false, "Evaluator not activated" };
+
+        if ( expression.empty() ) { return true; }
+
+        return this->expression( compile( expression, limits_ ) );
+    }
+
+    /**
+     * Sets the already compiled expression to be used for evaluation, e.g. the one
+     * loaded from its binary image. Its fields are bound to the schema here.
+     *
+     * @param expression Compiled expression to be used for evaluation
+     *
+     * @return True if the expression is not empty, otherwise false
+     */
+    [[ nodiscard ]] bool expression( compiled_expression expression ) noexcept
+    {
+        expression_   = std::move( expression );
+        is_activated_ = !expression_.empty();
+        validation_   = { false, "Evaluator not activated" };
+
+        if ( is_activated_ )
+        {
+            schema_visitor_.bind( expression_ );
+            validation_ = schema_visitor_.validate( expression_ );
+        }
+
+        return is_activated_;
+    }
+
+    /**
+     * Gets the result of validating the expression tree, i.e. the error
+     * that evaluation of any object would run into. Validation is done
+     * once, whenever the expression or the fields change.
+     *
+     * @return Result containing the message of the first error found
+     */
+    [[ nodiscard ]] result const & validation() const noexcept
+    {
+        return validation_;
+    }
+
+    /**
+     * Binds the values of the parameter placeholders of the expression set,
+     * e.g. $1 and $2 in "field_a > $1 and field_b < $2", without compiling
+     * the expression again. Objects are evaluated against the values bound
+     * until the next binding or until another expression is set.
+     *
+     * @param values Parameter values, the first one bound to $1
+     */
+    void parameters( std::vector< std::string > values )
+    {
+        expression_.bind_parameters( std::move( values ) );
+    }
+
+    /**
+     * Evaluates expression tree for the object passed in.
+     *
+     * @param obj Object to be evaluated
+     *
+     * @return True if the object's members satisfy the expression, otherwise false
+     */
+    [[ nodiscard ]] result evaluate( class_type const & obj ) const noexcept
+    {
+        if ( is_activated_ )
+        {
+            return schema_visitor_.visit( expression_, obj );
+        }
+        else
+        {
+            return { false, "Evaluator not activated" };
+        }
+    }
+
+    /**
+     * Checks whether the object satisfies the expression tree. This is the fast
+     * evaluation mode that produces the same outcome as evaluate, but without
+     * carrying the error message through the tree.
+     *
+     * @param obj Object to be evaluated
+     *
+     * @return True if the object's members satisfy the expression, otherwise false
+     */
+    [[ nodiscard ]] bool matches( class_type const & obj ) const noexcept
+    {
+        return is_activated_ && schema_visitor_.matches( expression_, obj );
+    }
+
+    /**
+     * Evaluates expression tree for the object passed in against the parameter
+     * values supplied, instead of the ones bound. Neither the evaluator nor
+     * the compiled expression is modified, so many threads can evaluate
+     * the same expression at once, each one with its own parameters.
+     *
+     * @param obj        Object to be evaluated
+     * @param parameters Parameter values, e.g. { 10, "foo" } for $1 and $2
+     *
+     * @return True if the object's members satisfy the expression, otherwise false
+     */
+    [[ nodiscard ]] result evaluate( class_type const & obj, parameter_frame const & parameters ) const noexcept
+    {
+        if ( is_activated_ )
+        {
+            return schema_visitor_.visit( expression_, obj, parameters );
+        }
+        else
+        {
+            return { false, "Evaluator not activated" };
+        }
+    }
+
+    /**
+     * Checks whether the object satisfies the expression tree against
+     * the parameter values supplied, instead of the ones bound.
+     *
+     * @param obj        Object to be evaluated
+     * @param parameters Parameter values, e.g. { 10, "foo" } for $1 and $2
+     *
+     * @return True if the object's members satisfy the expression, otherwise false
+     */
+    [[ nodiscard ]] bool matches( class_type const & obj, parameter_frame const & parameters ) const noexcept
+    {
+        return is_activated_ && schema_visitor_.matches( expression_, obj, parameters );
+    }
+
+    /**
+     * Selects the objects of the range satisfying the expression tree and writes
+     * their positions within the range to the output, e.g. a std::back_inserter.
+     * Objects are evaluated in blocks: the second operand of logical and is checked
+     * only on the objects accepted by the first one, and the second operand of
+     * logical or only on the objects not accepted yet.
+     *
+     * @param first Beginning of the range of objects, a random access iterator
+     * @param last  End of the range of objects
+     * @param out   Output iterator the positions of the objects selected are written to
+     *
+     * @return Output iterator past the last position written
+     */
+    template< typename It, typename O >
+    [[ nodiscard ]] O select( It const first, It const last, O const out ) const
+        noexcept( tree::flat_visitor::is_nothrow_output< O > )
+    {
+        return is_activated_ ? schema_visitor_.select( expression_, first, last, out ) : out;
+    }
+
+    /**
+     * Selects the objects of the range satisfying the expression tree against
+     * the parameter values supplied, instead of the ones bound.
+     *
+     * @param first      Beginning of the range of objects, a random access iterator
+     * @param last       End of the range of objects
+     * @param out        Output iterator the positions of the objects selected are written to
+     * @param parameters Parameter values, e.g. { 10, "foo" } for $1 and $2
+     *
+     * @return Output iterator past the last position written
+     */
+    template< typename It, typename O >
+    [[ nodiscard ]] O select( It const first, It const last, O const out, parameter_frame const & parameters ) const
+        noexcept( tree::flat_visitor::is_nothrow_output< O > )
+    {
+        return is_activated_ ? schema_visitor_.select( expression_, first, last, out, parameters ) : out;
+    }
+
+private:
+    bool                           is_activated_  { false   };
+    result                         validation_    { false, "Evaluator not activated" };
+    booleval::limits               limits_        {};
+    compiled_expression            expression_    {};
+    tree::schema_visitor< Schema > schema_visitor_{};
+};
+
+} // namespace booleval
+
+#endif // BOOLEVAL_SCHEMA_EVALUATOR_HPP
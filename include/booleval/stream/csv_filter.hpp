@@ -0,0 +1,468 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_CSV_FILTER_HPP
+#define BOOLEVAL_CSV_FILTER_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+
+#include <booleval/result.hpp>
+#include <booleval/compiled_expression.hpp>
+#include <booleval/stream/csv_record.hpp>
+#include <booleval/stream/filter_stats.hpp>
+#include <booleval/stream/parallel_filter.hpp>
+#include <booleval/tree/flat_profile.hpp>
+#include <booleval/tree/flat_visitor.hpp>
+
+namespace booleval::stream
+{
+
+/**
+ * @class csv_filter
+ *
+ * Represents the filter of CSV (or TSV) input. The first record of the input
+ * is the header, and expression fields refer to the columns by their names in
+ * the header. Fields are bound to column indices once, when the header is read,
+ * and only the columns needed for evaluation are parsed. Values that are decimal
+ * numbers are compared numerically, the others are compared as text. Matching
+ * records are passed on as views into the input, without the line break.
+ *
+ * The filter keeps the parsing state, so each thread needs its own copy.
+ */
+class csv_filter
+{
+public:
+    /**
+     * Creates the filter of the records with the specified delimiter.
+     *
+     * @param delimiter Column delimiter, e.g. ',' for CSV or '\t' for TSV
+     */
+    explicit csv_filter( char const delimiter = ',' ) noexcept
+        : record_( delimiter )
+        , header_( delimiter )
+    {}
+
+    /**
+     * Sets the expression used for filtering.
+     *
+     * @param expression Expression used for filtering
+     *
+     * @return True if the expression is valid, otherwise false
+     */
+    [[ nodiscard ]] bool expression( std::string_view const expression )
+    {
+        return this->expression( compile( expression ) );
+    }
+
+    /**
+     * Sets the compiled expression used for filtering. The header
+     * has to be read again afterwards.
+     *
+     * @param expression Compiled expression used for filtering
+     *
+     * @return True if the expression is not empty, otherwise false
+     */
+    [[ nodiscard ]] bool expression( compiled_expression expression ) noexcept
+    {
+        expression_ = std::move( expression );
+        is_bound_   = false;
+        validation_ = { false, "Header not read" };
+        return !expression_.empty();
+    }
+
+    /**
+     * Checks whether the filtering is activated, i.e. the expression is set.
+     *
+     * @return True if the filtering is activated, otherwise false
+     */
+    [[ nodiscard ]] bool is_activated() const noexcept
+    {
+        return !expression_.empty();
+    }
+
+    /**
+     * Gets the compiled expression used for filtering.
+     *
+     * @return Compiled expression
+     */
+    [[ nodiscard ]] compiled_expression const & compiled() const noexcept
+    {
+        return expression_;
+    }
+
+    /**
+     * Binds the expression fields to the columns of the header.
+     *
+     * @param header Header record
+     *
+     * @return True if all the fields are found in the header, otherwise false
+     */
+    bool header( std::string_view const header )
+    {
+        header_.reset( header );
+
+        // the columns are located up front, since the binding must not allocate;
+        // their views stay valid as the header is not reset in the meantime
+        std::vector< std::string_view > names;
+        for ( std::uint32_t i{ 0 }; auto const column = header_.column( i ); ++i )
+        {
+            names.push_back( column.value() );
+        }
+
+        expression_.bind
+        (
+            [ &names ]( std::string_view const name ) noexcept -> std::optional< std::size_t >
+            {
+                auto const it{ std::find( std::cbegin( names ), std::cend( names ), name ) };
+                if ( it == std::cend( names ) ) { return std::nullopt; }
+                return static_cast< std::size_t >( it - std::cbegin( names ) );
+            }
+        );
+
+        // only the bound columns are visited
+        std::uint32_t columns{ 0 };
+        for ( std::uint32_t i{ 0 }; i < expression_.field_count(); ++i )
+        {
+            auto const slot{ expression_.slot( i ) };
+            if ( slot != compiled_expression::npos ) { columns = std::max( columns, slot + 1 ); }
+        }
+        record_.reserve( columns );
+
+        is_bound_   = true;
+        validation_ = tree::flat_visitor::validate( expression_ );
+        return validation_.success;
+    }
+
+    /**
+     * Gets the result of validating the expression against the header, e.g.
+     * "Unknown field" if a field is not one of the header columns.
+     *
+     * @return Result containing the message of the first error found
+     */
+    [[ nodiscard ]] result const & validation() const noexcept
+    {
+        return validation_;
+    }
+
+    /**
+     * Checks whether the record satisfies the expression.
+     *
+     * @param record Record without the line break
+     *
+     * @return True if the record satisfies the expression, otherwise false
+     */
+    [[ nodiscard ]] bool matches( std::string_view const record )
+    {
+        if ( expression_.empty() ) { return false; }
+
+        record_.reset( record );
+
+        return tree::flat_visitor::matches
+        (
+            expression_,
+            0,
+            [ this ]( std::uint32_t const slot, auto && compare ) noexcept
+            {
+                return record_.visit( slot, compare );
+            }
+        );
+    }
+
+    /**
+     * Checks whether the record satisfies the expression and records
+     * the evaluation of the expression nodes.
+     *
+     * @param record  Record without the line break
+     * @param profile Profile of the expression nodes
+     *
+     * @return True if the record satisfies the expression, otherwise false
+     */
+    [[ nodiscard ]] bool matches( std::string_view const record, tree::flat_profile & profile )
+    {
+        if ( expression_.empty() ) { return false; }
+
+        record_.reset( record );
+
+        return profile.matches
+        (
+            expression_,
+            0,
+            [ this ]( std::uint32_t const slot, auto && compare ) noexcept
+            {
+                return record_.visit( slot, compare );
+            }
+        );
+    }
+
+    /**
+     * Filters the CSV input. Unless the header is already read, the first
+     * record is the header. Empty records are skipped.
+     *
+     * @param input    Input, e.g. the contents of a memory-mapped file
+     * @param on_match Function called with each matching record, as a view into the input
+     *
+     * @return Filtering statistics
+     */
+    template< typename F >
+    filter_stats filter( std::string_view const input, F && on_match )
+    {
+        std::size_t consumed{ 0 };
+        return filter_records( input, on_match, matcher(), true, consumed );
+    }
+
+    /**
+     * Filters the CSV input in parallel. The input after the header is split
+     * into chunks at record boundaries and each chunk is filtered by its own
+     * thread. Matching records are passed on in the input order.
+     *
+     * @param input    Input, e.g. the contents of a memory-mapped file
+     * @param on_match Function called with each matching record, as a view into the input
+     * @param threads  Number of threads
+     *
+     * @return Filtering statistics
+     */
+    template< typename F >
+    filter_stats filter( std::string_view input, F && on_match, std::size_t const threads )
+    {
+        filter_stats stats{};
+
+        if ( !is_bound_ )
+        {
+            auto const end{ csv_record::record_end( input, 0 ) };
+            auto       record{ input.substr( 0, end ) };
+            if ( !record.empty() && record.back() == '\r' ) { record.remove_suffix( 1 ); }
+
+            header( record );
+
+            stats.bytes += std::min( end + 1, std::size( input ) );
+            input.remove_prefix( std::min( end + 1, std::size( input ) ) );
+        }
+
+        if ( threads <= 1 )
+        {
+            stats += filter( input, on_match );
+        }
+        else
+        {
+            stats += parallel_filter( *this, split( input, threads ), on_match );
+        }
+
+        return stats;
+    }
+
+    /**
+     * Filters the CSV input stream chunk by chunk. The matching records are
+     * views into the chunk buffer, valid only during the call of the function.
+     *
+     * @param input      Input stream
+     * @param on_match   Function called with each matching record
+     * @param chunk_size Number of bytes read at once
+     *
+     * @return Filtering statistics
+     */
+    template< typename F >
+    filter_stats filter( std::istream & input, F && on_match, std::size_t const chunk_size = 1 << 20 )
+    {
+        filter_stats stats{};
+        std::string  buffer;
+        std::size_t  used{ 0 };
+
+        while ( input )
+        {
+            buffer.resize( used + chunk_size );
+            input.read( std::data( buffer ) + used, static_cast< std::streamsize >( chunk_size ) );
+            used += static_cast< std::size_t >( input.gcount() );
+
+            // only complete records are filtered, unless the input is exhausted
+            std::size_t consumed{ 0 };
+            stats += filter_records( std::string_view{ std::data( buffer ), used }, on_match, matcher(), !input, consumed );
+
+            buffer.erase( 0, consumed );
+            used -= consumed;
+        }
+
+        return stats;
+    }
+
+    /**
+     * Profiles the evaluation of the expression over the CSV input, i.e. filters
+     * it while recording the evaluation of the expression nodes. Unless the header
+     * is already read, the first record is the header.
+     *
+     * @param input   Input, e.g. the contents of a memory-mapped file
+     * @param profile Profile of the expression nodes
+     *
+     * @return Filtering statistics
+     */
+    filter_stats profile( std::string_view const input, tree::flat_profile & profile )
+    {
+        std::size_t consumed{ 0 };
+        return filter_records
+        (
+            input,
+            []( std::string_view ) noexcept {},
+            [ this, &profile ]( std::string_view const record ) { return matches( record, profile ); },
+            true,
+            consumed
+        );
+    }
+
+    /**
+     * Splits the records into chunks of similar size at record boundaries,
+     * taking line breaks within quoted columns into account.
+     *
+     * @param input Records, without the header
+     * @param count Number of chunks
+     *
+     * @return Chunks, at most count of them
+     */
+    [[ nodiscard ]] static std::vector< std::string_view > split( std::string_view const input, std::size_t const count )
+    {
+        std::vector< std::string_view > chunks;
+
+        auto const size{ std::size( input ) };
+        auto const *   first{ std::data( input ) };
+
+        std::size_t begin  { 0 };
+        std::size_t scanned{ 0 };
+        bool        quoted { false };
+
+        for ( std::size_t i{ 1 }; i <= count && begin < size; ++i )
+        {
+            auto const target{ i == count ? size : std::max( begin, size / count * i ) };
+
+            // quote parity at the target tells whether it is within a quoted column
+            while ( scanned < target )
+            {
+                auto const * quote{ static_cast< char const * >( std::memchr( first + scanned, '"', target - scanned ) ) };
+                if ( quote == nullptr ) { scanned = target; break; }
+                quoted  = !quoted;
+                scanned = static_cast< std::size_t >( quote - first ) + 1;
+            }
+
+            auto position{ target };
+            if ( quoted )
+            {
+                auto const * closing{ static_cast< char const * >( std::memchr( first + target, '"', size - target ) ) };
+                position = closing == nullptr ? size : static_cast< std::size_t >( closing - first ) + 1;
+            }
+
+            auto const end{ position >= size ? size : std::min( size, csv_record::record_end( input, position ) + 1 ) };
+
+            chunks.push_back( input.substr( begin, end - begin ) );
+
+            // quotes between the target and the end of the chunk are scanned again from there
+            begin   = end;
+            scanned = end;
+            quoted  = false;
+        }
+
+        return chunks;
+    }
+
+private:
+    /**
+     * Gets the function checking whether the record satisfies the expression.
+     *
+     * @return Matching function
+     */
+    [[ nodiscard ]] auto matcher() noexcept
+    {
+        return [ this ]( std::string_view const record ) { return matches( record ); };
+    }
+
+    /**
+     * Filters the complete CSV records of the input.
+     *
+     * @param input    Input
+     * @param on_match Function called with each matching record
+     * @param match    Function checking whether the record satisfies the expression
+     * @param is_final True if the input is not followed by more data, i.e. its last record is complete
+     * @param consumed Number of bytes of the complete records filtered
+     *
+     * @return Filtering statistics
+     */
+    template< typename F, typename M >
+    filter_stats filter_records( std::string_view const input, F && on_match, M && match, bool const is_final, std::size_t & consumed )
+    {
+        filter_stats stats{};
+
+        std::size_t position{ 0 };
+        while ( position < std::size( input ) )
+        {
+            auto const end{ csv_record::record_end( input, position ) };
+            if ( end == std::size( input ) && !is_final ) { break; }
+
+            auto record{ input.substr( position, end - position ) };
+
+            stats.bytes += std::min( end + 1, std::size( input ) ) - position;
+            position     = end + 1;
+
+            if ( !record.empty() && record.back() == '\r' ) { record.remove_suffix( 1 ); }
+
+            if ( !is_bound_ )
+            {
+                header( record );
+                continue;
+            }
+
+            if ( record.empty() ) { continue; }
+
+            ++stats.records;
+            if ( match( record ) )
+            {
+                ++stats.matches;
+                on_match( record );
+            }
+        }
+
+        consumed = std::min( position, std::size( input ) );
+        return stats;
+    }
+
+private:
+    compiled_expression expression_{};
+    csv_record          record_    {};
+    csv_record          header_    {};
+    bool                is_bound_  { false };
+    result              validation_{ false, "Header not read" };
+};
+
+} // namespace booleval::stream
+
+#endif // BOOLEVAL_CSV_FILTER_HPP
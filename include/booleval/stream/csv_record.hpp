@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_CSV_RECORD_HPP
+#define BOOLEVAL_CSV_RECORD_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+
+#include <booleval/utils/string_utils.hpp>
+
+namespace booleval::stream
+{
+
+namespace internal
+{
+
+    /**
+     * Checks whether the text is a decimal number, i.e. an optional sign,
+     * digits with an optional fraction and an optional exponent.
+     *
+     * @param text Text to check
+     *
+     * @return True if the text is a decimal number, otherwise false
+     */
+    [[ nodiscard ]] constexpr bool is_decimal_number( std::string_view const text ) noexcept
+    {
+        std::size_t i{ 0 };
+        auto const digits = [ &i, text ]() noexcept
+        {
+            auto const first{ i };
+            while ( i < std::size( text ) && text[ i ] >= '0' && text[ i ] <= '9' ) { ++i; }
+            return i - first;
+        };
+
+        if ( i < std::size( text ) && ( text[ i ] == '-' || text[ i ] == '+' ) ) { ++i; }
+
+        auto count{ digits() };
+        if ( i < std::size( text ) && text[ i ] == '.' ) { ++i; count += digits(); }
+        if ( count == 0 ) { return false; }
+
+        if ( i < std::size( text ) && ( text[ i ] == 'e' || text[ i ] == 'E' ) )
+        {
+            ++i;
+            if ( i < std::size( text ) && ( text[ i ] == '-' || text[ i ] == '+' ) ) { ++i; }
+            if ( digits() == 0 ) { return false; }
+        }
+
+        return i == std::size( text );
+    }
+
+} // namespace internal
+
+/**
+ * @class csv_record
+ *
+ * Represents the on-demand parser of a single CSV (or TSV) record. Columns are
+ * located only up to the last one requested, and only when first requested.
+ * Quoted columns follow RFC 4180, i.e. they may contain delimiters, line breaks
+ * and doubled quotes. Delimiters, quotes and line breaks are searched for with
+ * memchr, which the C library implements with vector instructions.
+ *
+ * Visiting the columns does not allocate, and so does not throw, as the buffers
+ * are grown when a record is started. Only the reserved columns are visited.
+ */
+class csv_record
+{
+public:
+    /**
+     * Creates the parser of the records with the specified delimiter.
+     *
+     * @param delimiter Column delimiter, e.g. ',' for CSV or '\t' for TSV
+     */
+    explicit csv_record( char const delimiter = ',' ) noexcept
+        : delimiter_( delimiter )
+    {}
+
+    /**
+     * Reserves the specified number of columns to be visited.
+     *
+     * @param columns Number of columns
+     */
+    void reserve( std::uint32_t const columns )
+    {
+        reserved_ = columns;
+        columns_.reserve( columns );
+    }
+
+    /**
+     * Starts parsing the new record.
+     *
+     * @param record Record without the line break
+     */
+    void reset( std::string_view const record )
+    {
+        record_   = record;
+        position_ = 0;
+        columns_.clear();
+        columns_.reserve( reserved_ );
+
+        // unquoted columns are never longer than quoted ones
+        if ( std::size( scratch_ ) < std::size( record ) ) { scratch_.resize( std::size( record ) ); }
+    }
+
+    /**
+     * Gets the column with the specified index, without quotes.
+     *
+     * @param index Column index
+     *
+     * @return Column or std::nullopt if the record has fewer columns
+     */
+    [[ nodiscard ]] std::optional< std::string_view > column( std::uint32_t const index )
+    {
+        if ( columns_.capacity() <= index )
+        {
+            columns_.reserve( std::max< std::size_t >( index + 1, 2 * columns_.capacity() ) );
+        }
+
+        return reserved_column( index );
+    }
+
+    /**
+     * Visits the value of the column with the specified index.
+     *
+     * @param index Column index
+     * @param f     Function called with either double or std::string_view value
+     *
+     * @return Result of the function or false if the record has fewer columns
+     *         or the column is not reserved
+     */
+    template< typename F >
+    [[ nodiscard ]] bool visit( std::uint32_t const index, F && f )
+        noexcept( std::is_nothrow_invocable_v< F &, double > && std::is_nothrow_invocable_v< F &, std::string_view > )
+    {
+        auto const text{ reserved_column( index ) };
+        if ( !text ) { return false; }
+
+        if ( internal::is_decimal_number( text.value() ) )
+        {
+            auto const number{ utils::from_chars< double >( text.value() ) };
+            if ( number ) { return f( number.value() ); }
+        }
+
+        return f( text.value() );
+    }
+
+    /**
+     * Finds the end of the record starting at the specified position,
+     * skipping the line breaks within quoted columns.
+     *
+     * @param input    Input containing records
+     * @param position Position of the beginning of the record
+     *
+     * @return Position of the line break ending the record or size of the input
+     */
+    [[ nodiscard ]] static std::size_t record_end( std::string_view const input, std::size_t position ) noexcept
+    {
+        auto const * const first{ std::data( input ) };
+        auto const         size { std::size( input ) };
+
+        while ( position < size )
+        {
+            auto const * newline{ static_cast< char const * >( std::memchr( first + position, '\n', size - position ) ) };
+            auto const   end    { newline == nullptr ? size : static_cast< std::size_t >( newline - first ) };
+
+            auto const * quote{ static_cast< char const * >( std::memchr( first + position, '"', end - position ) ) };
+            if ( quote == nullptr ) { return end; }
+
+            // skip the quoted part, doubled quotes being two adjacent quoted parts
+            auto const * closing{ static_cast< char const * >( std::memchr( quote + 1, '"', size - static_cast< std::size_t >( quote + 1 - first ) ) ) };
+            if ( closing == nullptr ) { return size; }
+
+            position = static_cast< std::size_t >( closing + 1 - first );
+        }
+
+        return size;
+    }
+
+private:
+    struct column_ref
+    {
+        std::string_view text      {};
+        bool             is_escaped{ false };
+    };
+
+    /**
+     * Gets the column with the specified index, without quotes,
+     * locating only the columns within the reserved capacity.
+     *
+     * @param index Column index
+     *
+     * @return Column or std::nullopt if the record has fewer columns or the column is not reserved
+     */
+    [[ nodiscard ]] std::optional< std::string_view > reserved_column( std::uint32_t const index ) noexcept
+    {
+        while
+        (
+            std::size( columns_ ) <= index &&
+            std::size( columns_ ) < columns_.capacity() &&
+            position_ <= std::size( record_ )
+        )
+        {
+            scan_column();
+        }
+
+        if ( std::size( columns_ ) <= index ) { return std::nullopt; }
+
+        auto const & column{ columns_[ index ] };
+        if ( !column.is_escaped ) { return column.text; }
+
+        // the column is unquoted into the same offset of the scratch buffer,
+        // so that the views of the other columns stay valid
+        auto * const output{ std::data( scratch_ ) + ( std::data( column.text ) - std::data( record_ ) ) };
+        std::size_t  size  { 0 };
+        for ( std::size_t i{ 0 }; i < std::size( column.text ); ++i )
+        {
+            output[ size++ ] = column.text[ i ];
+            if ( column.text[ i ] == '"' ) { ++i; } // doubled quote
+        }
+        return std::string_view{ output, size };
+    }
+
+    void scan_column() noexcept
+    {
+        auto const size{ std::size( record_ ) };
+
+        if ( position_ < size && record_[ position_ ] == '"' )
+        {
+            auto const begin{ position_ + 1 };
+            auto       end  { begin };
+            bool       is_escaped{ false };
+
+            while ( true )
+            {
+                auto const quote{ record_.find( '"', end ) };
+                if ( quote == std::string_view::npos ) { end = size; break; }
+                if ( quote + 1 < size && record_[ quote + 1 ] == '"' )
+                {
+                    is_escaped = true;
+                    end = quote + 2;
+                    continue;
+                }
+                end = quote;
+                break;
+            }
+
+            columns_.push_back( { record_.substr( begin, end - begin ), is_escaped } );
+
+            // anything between the closing quote and the delimiter is ignored
+            auto const delimiter{ end < size ? record_.find( delimiter_, end ) : std::string_view::npos };
+            position_ = delimiter == std::string_view::npos ? size + 1 : delimiter + 1;
+            return;
+        }
+
+        auto const * const first    { std::data( record_ ) };
+        auto const * const delimiter
+        {
+            position_ < size
+                ? static_cast< char const * >( std::memchr( first + position_, delimiter_, size - position_ ) )
+                : nullptr
+        };
+        auto end{ delimiter == nullptr ? size : static_cast< std::size_t >( delimiter - first ) };
+
+        auto text{ record_.substr( position_, end - position_ ) };
+        if ( delimiter == nullptr && !text.empty() && text.back() == '\r' ) { text.remove_suffix( 1 ); }
+
+        columns_.push_back( { text, false } );
+        position_ = end + 1;
+    }
+
+private:
+    char                        delimiter_{ ','   };
+    std::string_view            record_   {};
+    std::size_t                 position_ { 0 };
+    std::uint32_t               reserved_ { 0 };
+    std::vector< column_ref  >  columns_  {};
+    std::string                 scratch_  {};
+};
+
+} // namespace booleval::stream
+
+#endif // BOOLEVAL_CSV_RECORD_HPP
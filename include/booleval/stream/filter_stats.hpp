@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_FILTER_STATS_HPP
+#define BOOLEVAL_FILTER_STATS_HPP
+
+#include <cstdint>
+
+namespace booleval::stream
+{
+
+/**
+ * struct filter_stats
+ *
+ * Represents the statistics of filtering the stream of records.
+ */
+struct filter_stats
+{
+    std::uint64_t records{ 0 }; // records evaluated
+    std::uint64_t matches{ 0 }; // records satisfying the expression
+    std::uint64_t bytes  { 0 }; // bytes consumed, including delimiters
+
+    /**
+     * Gets the ratio of the matching records.
+     *
+     * @return Selectivity in range [0, 1]
+     */
+    [[ nodiscard ]] constexpr double selectivity() const noexcept
+    {
+        return records == 0 ? 0.0 : static_cast< double >( matches ) / static_cast< double >( records );
+    }
+
+    constexpr filter_stats & operator+=( filter_stats const & rhs ) noexcept
+    {
+        records += rhs.records;
+        matches += rhs.matches;
+        bytes   += rhs.bytes;
+        return *this;
+    }
+};
+
+} // namespace booleval::stream
+
+#endif // BOOLEVAL_FILTER_STATS_HPP
@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_JSON_RECORD_HPP
+#define BOOLEVAL_JSON_RECORD_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <string_view>
+#include <type_traits>
+
+#include <booleval/utils/string_utils.hpp>
+
+namespace booleval::stream
+{
+
+/**
+ * @class json_record
+ *
+ * Represents the on-demand scanner of a single JSON object, e.g. one line of
+ * newline-delimited JSON input. No DOM is built. Only the top-level members
+ * whose keys are referenced are located, and only when their values are first
+ * requested. Scanning stops as soon as the requested member is found and is
+ * resumed from the same position for the next one.
+ *
+ * Numbers are provided as doubles, strings without escape sequences as views
+ * into the record, and the other values (true, false, null, objects, arrays)
+ * as their raw text. Malformed input is never read past its end; the members
+ * that could not be located are reported as missing.
+ *
+ * Visiting the members does not allocate, and so does not throw, as the buffer
+ * of the unescaped strings is grown when a record is started.
+ */
+class json_record
+{
+public:
+    json_record() = default;
+
+    /**
+     * Creates the scanner for the specified keys. The slot of each key
+     * is its index in the vector.
+     *
+     * @param keys Keys of the members to be located
+     */
+    explicit json_record( std::vector< std::string > keys )
+        : keys_  ( std::move( keys ) )
+        , values_( std::size( keys_ ) )
+    {}
+
+    /**
+     * Starts scanning the new record.
+     *
+     * @param record JSON object
+     */
+    void reset( std::string_view const record )
+    {
+        record_   = record;
+        position_ = 0;
+        finished_ = true;
+
+        // unescaped strings are never longer than escaped ones
+        if ( std::size( scratch_ ) < std::size( record ) ) { scratch_.resize( std::size( record ) ); }
+
+        for ( auto & value : values_ ) { value.state = value_state::unknown; }
+
+        skip_whitespace();
+        if ( position_ < std::size( record_ ) && record_[ position_ ] == '{' )
+        {
+            ++position_;
+            finished_ = false;
+        }
+    }
+
+    /**
+     * Visits the value of the member in the specified slot.
+     *
+     * @param slot Slot of the member key
+     * @param f    Function called with either double or std::string_view value
+     *
+     * @return Result of the function or false if the member is missing
+     */
+    template< typename F >
+    [[ nodiscard ]] bool visit( std::uint32_t const slot, F && f )
+        noexcept( std::is_nothrow_invocable_v< F &, double > && std::is_nothrow_invocable_v< F &, std::string_view > )
+    {
+        auto & value{ values_[ slot ] };
+
+        while ( value.state == value_state::unknown && !finished_ )
+        {
+            scan_member();
+        }
+
+        if ( value.state != value_state::found ) { return false; }
+
+        switch ( value.kind )
+        {
+            case value_kind::number:
+            {
+                auto const number{ utils::from_chars< double >( value.text ) };
+                return number && f( number.value() );
+            }
+
+            case value_kind::escaped_string:
+            {
+                // the string is unescaped into the same offset of the scratch buffer,
+                // so that the views of the other strings stay valid
+                auto * const output{ std::data( scratch_ ) + ( std::data( value.text ) - std::data( record_ ) ) };
+                auto const   size  { unescape( value.text, output ) };
+                return size != std::string_view::npos && f( std::string_view{ output, size } );
+            }
+
+            default:
+                return f( value.text );
+        }
+    }
+
+private:
+    enum class value_state : std::uint8_t { unknown, missing, found };
+    enum class value_kind  : std::uint8_t { string, escaped_string, number, literal };
+
+    struct value
+    {
+        value_state      state{ value_state::unknown };
+        value_kind       kind { value_kind::literal  };
+        std::string_view text {};
+    };
+
+    void skip_whitespace() noexcept
+    {
+        while
+        (
+            position_ < std::size( record_ ) &&
+            ( record_[ position_ ] == ' '  || record_[ position_ ] == '\t' ||
+              record_[ position_ ] == '\n' || record_[ position_ ] == '\r' )
+        )
+        {
+            ++position_;
+        }
+    }
+
+    /**
+     * Finds the end of the string starting at the current position,
+     * i.e. the position of the closing quote.
+     *
+     * @return Position of the closing quote or npos if there is none
+     */
+    [[ nodiscard ]] std::size_t string_end() const noexcept
+    {
+        auto const * const first{ std::data( record_ ) };
+        auto const * const last { first + std::size( record_ ) };
+
+        auto const * const begin{ first + position_ + 1 };
+
+        auto const * p{ begin };
+        while ( p < last )
+        {
+            auto const * quote{ static_cast< char const * >( std::memchr( p, '"', static_cast< std::size_t >( last - p ) ) ) };
+            if ( quote == nullptr ) { return std::string_view::npos; }
+
+            // the quote is escaped if preceded by an odd number of backslashes
+            std::ptrdiff_t backslashes{ 0 };
+            while ( quote - backslashes > begin && *( quote - backslashes - 1 ) == '\\' ) { ++backslashes; }
+
+            if ( backslashes % 2 == 0 )
+            {
+                return static_cast< std::size_t >( quote - first );
+            }
+
+            p = quote + 1;
+        }
+
+        return std::string_view::npos;
+    }
+
+    /**
+     * Finds the end of the value starting at the current position.
+     *
+     * @return Position following the value or npos if the value is malformed
+     */
+    [[ nodiscard ]] std::size_t value_end() noexcept
+    {
+        auto const size{ std::size( record_ ) };
+        auto const c   { record_[ position_ ] };
+
+        if ( c == '"' )
+        {
+            auto const end{ string_end() };
+            return end == std::string_view::npos ? end : end + 1;
+        }
+
+        if ( c == '{' || c == '[' )
+        {
+            std::size_t depth{ 0 };
+            auto const start{ position_ };
+            while ( position_ < size )
+            {
+                switch ( record_[ position_ ] )
+                {
+                    case '"':
+                    {
+                        auto const end{ string_end() };
+                        if ( end == std::string_view::npos ) { position_ = start; return end; }
+                        position_ = end;
+                        break;
+                    }
+                    case '{': case '[': ++depth; break;
+                    case '}': case ']':
+                        if ( --depth == 0 )
+                        {
+                            auto const end{ position_ + 1 };
+                            position_ = start;
+                            return end;
+                        }
+                        break;
+                    default: break;
+                }
+                ++position_;
+            }
+            position_ = start;
+            return std::string_view::npos;
+        }
+
+        auto end{ position_ };
+        while
+        (
+            end < size &&
+            record_[ end ] != ',' && record_[ end ] != '}' && record_[ end ] != ']' &&
+            record_[ end ] != ' ' && record_[ end ] != '\t' && record_[ end ] != '\n' && record_[ end ] != '\r'
+        )
+        {
+            ++end;
+        }
+        return end == position_ ? std::string_view::npos : end;
+    }
+
+    /**
+     * Scans the next member of the object and stores its value
+     * if the key is referenced.
+     */
+    void scan_member() noexcept
+    {
+        skip_whitespace();
+        if ( position_ < std::size( record_ ) && record_[ position_ ] == ',' )
+        {
+            ++position_;
+            skip_whitespace();
+        }
+
+        if ( position_ >= std::size( record_ ) || record_[ position_ ] != '"' )
+        {
+            finish();
+            return;
+        }
+
+        auto const key_end{ string_end() };
+        if ( key_end == std::string_view::npos ) { finish(); return; }
+
+        auto const key{ record_.substr( position_ + 1, key_end - position_ - 1 ) };
+        position_ = key_end + 1;
+
+        skip_whitespace();
+        if ( position_ >= std::size( record_ ) || record_[ position_ ] != ':' ) { finish(); return; }
+        ++position_;
+        skip_whitespace();
+        if ( position_ >= std::size( record_ ) ) { finish(); return; }
+
+        auto const end{ value_end() };
+        if ( end == std::string_view::npos ) { finish(); return; }
+
+        for ( std::size_t i{ 0 }; i < std::size( keys_ ); ++i )
+        {
+            if ( values_[ i ].state != value_state::unknown || keys_[ i ] != key ) { continue; }
+
+            auto & value{ values_[ i ] };
+            value.state = value_state::found;
+
+            auto const c{ record_[ position_ ] };
+            if ( c == '"' )
+            {
+                value.text = record_.substr( position_ + 1, end - position_ - 2 );
+                value.kind = value.text.find( '\\' ) == std::string_view::npos ? value_kind::string : value_kind::escaped_string;
+            }
+            else
+            {
+                value.kind = ( c == '-' || ( c >= '0' && c <= '9' ) ) ? value_kind::number : value_kind::literal;
+                value.text = record_.substr( position_, end - position_ );
+            }
+            break;
+        }
+
+        position_ = end;
+    }
+
+    void finish() noexcept
+    {
+        finished_ = true;
+        for ( auto & value : values_ )
+        {
+            if ( value.state == value_state::unknown ) { value.state = value_state::missing; }
+        }
+    }
+
+    /**
+     * Replaces the escape sequences of the JSON string.
+     *
+     * @param text   String contents without quotes
+     * @param output Buffer of the unescaped string, at least as long as the text
+     *
+     * @return Size of the unescaped string or npos if the string is invalid
+     */
+    [[ nodiscard ]] static std::size_t unescape( std::string_view const text, char * const output ) noexcept
+    {
+        std::size_t size{ 0 };
+        auto const  push_back = [ output, &size ]( char const c ) noexcept { output[ size++ ] = c; };
+
+        auto const hex = [ text ]( std::size_t const at, std::uint32_t & code ) noexcept
+        {
+            if ( at + 4 > std::size( text ) ) { return false; }
+            code = 0;
+            for ( auto const c : text.substr( at, 4 ) )
+            {
+                code <<= 4;
+                if      ( c >= '0' && c <= '9' ) { code |= static_cast< std::uint32_t >( c - '0'      ); }
+                else if ( c >= 'a' && c <= 'f' ) { code |= static_cast< std::uint32_t >( c - 'a' + 10 ); }
+                else if ( c >= 'A' && c <= 'F' ) { code |= static_cast< std::uint32_t >( c - 'A' + 10 ); }
+                else { return false; }
+            }
+            return true;
+        };
+
+        for ( std::size_t i{ 0 }; i < std::size( text ); ++i )
+        {
+            if ( text[ i ] != '\\' ) { push_back( text[ i ] ); continue; }
+            if ( ++i == std::size( text ) ) { return std::string_view::npos; }
+
+            switch ( text[ i ] )
+            {
+                case '"' : push_back( '"'  ); break;
+                case '\\': push_back( '\\' ); break;
+                case '/' : push_back( '/'  ); break;
+                case 'b' : push_back( '\b' ); break;
+                case 'f' : push_back( '\f' ); break;
+                case 'n' : push_back( '\n' ); break;
+                case 'r' : push_back( '\r' ); break;
+                case 't' : push_back( '\t' ); break;
+                case 'u' :
+                {
+                    std::uint32_t code{ 0 };
+                    if ( !hex( i + 1, code ) ) { return std::string_view::npos; }
+                    i += 4;
+
+                    // surrogate pair
+                    if ( code >= 0xD800 && code <= 0xDBFF )
+                    {
+                        std::uint32_t low{ 0 };
+                        if ( i + 2 >= std::size( text ) || text[ i + 1 ] != '\\' || text[ i + 2 ] != 'u' || !hex( i + 3, low ) ) { return std::string_view::npos; }
+                        if ( low < 0xDC00 || low > 0xDFFF ) { return std::string_view::npos; }
+                        code = 0x10000 + ( ( code - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+                        i += 6;
+                    }
+
+                    if ( code < 0x80 )
+                    {
+                        push_back( static_cast< char >( code ) );
+                    }
+                    else if ( code < 0x800 )
+                    {
+                        push_back( static_cast< char >( 0xC0 | ( code >> 6 ) ) );
+                        push_back( static_cast< char >( 0x80 | ( code & 0x3F ) ) );
+                    }
+                    else if ( code < 0x10000 )
+                    {
+                        push_back( static_cast< char >( 0xE0 | ( code >> 12 ) ) );
+                        push_back( static_cast< char >( 0x80 | ( ( code >> 6 ) & 0x3F ) ) );
+                        push_back( static_cast< char >( 0x80 | ( code & 0x3F ) ) );
+                    }
+                    else
+                    {
+                        push_back( static_cast< char >( 0xF0 | ( code >> 18 ) ) );
+                        push_back( static_cast< char >( 0x80 | ( ( code >> 12 ) & 0x3F ) ) );
+                        push_back( static_cast< char >( 0x80 | ( ( code >> 6 ) & 0x3F ) ) );
+                        push_back( static_cast< char >( 0x80 | ( code & 0x3F ) ) );
+                    }
+                    break;
+                }
+                default:
+                    return std::string_view::npos;
+            }
+        }
+
+        return size;
+    }
+
+private:
+    std::vector< std::string > keys_;
+    std::vector< value       > values_;
+    std::string                scratch_ {};
+    std::string_view           record_  {};
+    std::size_t                position_{ 0 };
+    bool                       finished_{ true };
+};
+
+} // namespace booleval::stream
+
+#endif // BOOLEVAL_JSON_RECORD_HPP
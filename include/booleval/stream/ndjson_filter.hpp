@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_NDJSON_FILTER_HPP
+#define BOOLEVAL_NDJSON_FILTER_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+
+#include <booleval/compiled_expression.hpp>
+#include <booleval/stream/json_record.hpp>
+#include <booleval/stream/filter_stats.hpp>
+#include <booleval/stream/parallel_filter.hpp>
+#include <booleval/tree/flat_profile.hpp>
+#include <booleval/tree/flat_visitor.hpp>
+
+namespace booleval::stream
+{
+
+/**
+ * @class ndjson_filter
+ *
+ * Represents the filter of newline-delimited JSON input, one object per line.
+ * Expression fields refer to the top-level members of the objects. For each
+ * line, only the members needed for evaluation are located by the on-demand
+ * scanner, and the matching lines are passed on as views into the input.
+ * A member missing from the object satisfies no relational operation.
+ *
+ * The filter keeps the scanning state, so each thread needs its own copy.
+ */
+class ndjson_filter
+{
+public:
+    /**
+     * Sets the expression used for filtering.
+     *
+     * @param expression Expression used for filtering
+     *
+     * @return True if the expression is valid, otherwise false
+     */
+    [[ nodiscard ]] bool expression( std::string_view const expression )
+    {
+        return this->expression( compile( expression ) );
+    }
+
+    /**
+     * Sets the compiled expression used for filtering.
+     *
+     * @param expression Compiled expression used for filtering
+     *
+     * @return True if the expression is not empty, otherwise false
+     */
+    [[ nodiscard ]] bool expression( compiled_expression expression )
+    {
+        expression_ = std::move( expression );
+
+        std::vector< std::string > keys;
+        for ( std::uint32_t i{ 0 }; i < expression_.field_count(); ++i )
+        {
+            keys.emplace_back( expression_.field( i ) );
+        }
+
+        // each field is bound to the slot of the scanner equal to its index
+        expression_.bind
+        (
+            [ &keys ]( std::string_view const name ) noexcept -> std::optional< std::size_t >
+            {
+                for ( std::size_t i{ 0 }; i < std::size( keys ); ++i )
+                {
+                    if ( keys[ i ] == name ) { return i; }
+                }
+                return std::nullopt;
+            }
+        );
+
+        record_ = json_record{ std::move( keys ) };
+
+        return !expression_.empty();
+    }
+
+    /**
+     * Checks whether the filtering is activated, i.e. the expression is set.
+     *
+     * @return True if the filtering is activated, otherwise false
+     */
+    [[ nodiscard ]] bool is_activated() const noexcept
+    {
+        return !expression_.empty();
+    }
+
+    /**
+     * Gets the compiled expression used for filtering.
+     *
+     * @return Compiled expression
+     */
+    [[ nodiscard ]] compiled_expression const & compiled() const noexcept
+    {
+        return expression_;
+    }
+
+    /**
+     * Checks whether the JSON object satisfies the expression.
+     *
+     * @param line JSON object
+     *
+     * @return True if the object satisfies the expression, otherwise false
+     */
+    [[ nodiscard ]] bool matches( std::string_view const line )
+    {
+        if ( expression_.empty() ) { return false; }
+
+        record_.reset( line );
+
+        return tree::flat_visitor::matches
+        (
+            expression_,
+            0,
+            [ this ]( std::uint32_t const slot, auto && compare ) noexcept
+            {
+                return record_.visit( slot, compare );
+            }
+        );
+    }
+
+    /**
+     * Checks whether the JSON object satisfies the expression and records
+     * the evaluation of the expression nodes.
+     *
+     * @param line    JSON object
+     * @param profile Profile of the expression nodes
+     *
+     * @return True if the object satisfies the expression, otherwise false
+     */
+    [[ nodiscard ]] bool matches( std::string_view const line, tree::flat_profile & profile )
+    {
+        if ( expression_.empty() ) { return false; }
+
+        record_.reset( line );
+
+        return profile.matches
+        (
+            expression_,
+            0,
+            [ this ]( std::uint32_t const slot, auto && compare ) noexcept
+            {
+                return record_.visit( slot, compare );
+            }
+        );
+    }
+
+    /**
+     * Filters the newline-delimited JSON input. Empty lines are skipped.
+     *
+     * @param input    Input, e.g. the contents of a memory-mapped file
+     * @param on_match Function called with each matching line, as a view into the input
+     *
+     * @return Filtering statistics
+     */
+    template< typename F >
+    filter_stats filter( std::string_view const input, F && on_match )
+    {
+        return filter_lines
+        (
+            input,
+            on_match,
+            [ this ]( std::string_view const line ) { return matches( line ); }
+        );
+    }
+
+    /**
+     * Filters the newline-delimited JSON input in parallel. The input is split
+     * into chunks at line boundaries and each chunk is filtered by its own thread.
+     * Matching lines are passed on in the input order.
+     *
+     * @param input    Input, e.g. the contents of a memory-mapped file
+     * @param on_match Function called with each matching line, as a view into the input
+     * @param threads  Number of threads
+     *
+     * @return Filtering statistics
+     */
+    template< typename F >
+    filter_stats filter( std::string_view const input, F && on_match, std::size_t const threads )
+    {
+        if ( threads <= 1 )
+        {
+            return filter( input, on_match );
+        }
+
+        return parallel_filter( *this, split( input, threads ), on_match );
+    }
+
+    /**
+     * Filters the newline-delimited JSON input stream chunk by chunk.
+     * The matching lines are views into the chunk buffer, valid only
+     * during the call of the function.
+     *
+     * @param input      Input stream
+     * @param on_match   Function called with each matching line
+     * @param chunk_size Number of bytes read at once
+     *
+     * @return Filtering statistics
+     */
+    template< typename F >
+    filter_stats filter( std::istream & input, F && on_match, std::size_t const chunk_size = 1 << 20 )
+    {
+        filter_stats stats{};
+        std::string  buffer;
+        std::size_t  used{ 0 };
+
+        while ( input )
+        {
+            buffer.resize( used + chunk_size );
+            input.read( std::data( buffer ) + used, static_cast< std::streamsize >( chunk_size ) );
+            used += static_cast< std::size_t >( input.gcount() );
+
+            // only complete lines are filtered, unless the input is exhausted
+            auto const chunk{ std::string_view{ std::data( buffer ), used } };
+            auto const last_newline{ chunk.rfind( '\n' ) };
+            auto const complete{ !input ? used : ( last_newline == std::string_view::npos ? 0 : last_newline + 1 ) };
+
+            stats += filter( chunk.substr( 0, complete ), on_match );
+
+            buffer.erase( 0, complete );
+            used -= complete;
+        }
+
+        return stats;
+    }
+
+    /**
+     * Profiles the evaluation of the expression over the newline-delimited
+     * JSON input, i.e. filters it while recording the evaluation of the
+     * expression nodes.
+     *
+     * @param input   Input, e.g. the contents of a memory-mapped file
+     * @param profile Profile of the expression nodes
+     *
+     * @return Filtering statistics
+     */
+    filter_stats profile( std::string_view const input, tree::flat_profile & profile )
+    {
+        return filter_lines
+        (
+            input,
+            []( std::string_view ) noexcept {},
+            [ this, &profile ]( std::string_view const line ) { return matches( line, profile ); }
+        );
+    }
+
+    /**
+     * Splits the input into chunks of similar size at line boundaries.
+     *
+     * @param input Input
+     * @param count Number of chunks
+     *
+     * @return Chunks, at most count of them
+     */
+    [[ nodiscard ]] static std::vector< std::string_view > split( std::string_view const input, std::size_t const count )
+    {
+        std::vector< std::string_view > chunks;
+
+        auto const size{ std::size( input ) };
+
+        std::size_t begin{ 0 };
+        for ( std::size_t i{ 1 }; i <= count && begin < size; ++i )
+        {
+            auto const target { i == count ? size : std::max( begin, size / count * i ) };
+            auto const newline{ target >= size ? std::string_view::npos : input.find( '\n', target ) };
+            auto const end    { newline == std::string_view::npos ? size : newline + 1 };
+
+            chunks.push_back( input.substr( begin, end - begin ) );
+            begin = end;
+        }
+
+        return chunks;
+    }
+
+private:
+    /**
+     * Filters the lines of the input by using the matching function.
+     *
+     * @param input    Input
+     * @param on_match Function called with each matching line
+     * @param match    Function checking whether the line satisfies the expression
+     *
+     * @return Filtering statistics
+     */
+    template< typename F, typename M >
+    static filter_stats filter_lines( std::string_view const input, F && on_match, M && match )
+    {
+        filter_stats stats{};
+
+        std::size_t position{ 0 };
+        while ( position < std::size( input ) )
+        {
+            auto const * const newline
+            {
+                static_cast< char const * >( std::memchr( std::data( input ) + position, '\n', std::size( input ) - position ) )
+            };
+            auto const end { newline == nullptr ? std::size( input ) : static_cast< std::size_t >( newline - std::data( input ) ) };
+            auto       line{ input.substr( position, end - position ) };
+
+            stats.bytes += end - position + ( newline == nullptr ? 0 : 1 );
+            position     = end + 1;
+
+            if ( !line.empty() && line.back() == '\r' ) { line.remove_suffix( 1 ); }
+            if (  line.empty()                        ) { continue; }
+
+            ++stats.records;
+            if ( match( line ) )
+            {
+                ++stats.matches;
+                on_match( line );
+            }
+        }
+
+        return stats;
+    }
+
+private:
+    compiled_expression expression_{};
+    json_record         record_    {};
+};
+
+} // namespace booleval::stream
+
+#endif // BOOLEVAL_NDJSON_FILTER_HPP
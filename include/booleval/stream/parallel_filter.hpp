@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_PARALLEL_FILTER_HPP
+#define BOOLEVAL_PARALLEL_FILTER_HPP
+
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <string_view>
+
+#include <booleval/stream/filter_stats.hpp>
+
+namespace booleval::stream
+{
+
+/**
+ * Filters the chunks of the input in parallel, one thread per chunk. Each thread
+ * uses its own copy of the filter. Matching records are passed on in the input
+ * order, from the calling thread, once all the chunks are filtered. Until then,
+ * the views of all the matching records are buffered, so the memory used grows
+ * with the number of matches, i.e. 16 bytes per match on the usual platforms.
+ * Inputs with many matches are better filtered a few chunks at a time.
+ *
+ * @param filter   Filter providing filter( std::string_view, on_match ) member function
+ * @param chunks   Chunks of the input, each containing complete records only
+ * @param on_match Function called with each matching record
+ *
+ * @return Filtering statistics of all the chunks
+ */
+template< typename Filter, typename F >
+filter_stats parallel_filter( Filter const & filter, std::vector< std::string_view > const & chunks, F && on_match )
+{
+    std::vector< filter_stats                    > stats  ( std::size( chunks ) );
+    std::vector< std::vector< std::string_view > > matches( std::size( chunks ) );
+
+    {
+        std::vector< std::thread > threads;
+        threads.reserve( std::size( chunks ) );
+
+        try
+        {
+            for ( std::size_t i{ 0 }; i < std::size( chunks ); ++i )
+            {
+                threads.emplace_back
+                (
+                    [ &, i ]
+                    {
+                        auto copy{ filter };
+                        stats[ i ] = copy.filter
+                        (
+                            chunks[ i ],
+                            [ &matches, i ]( std::string_view const record ) { matches[ i ].push_back( record ); }
+                        );
+                    }
+                );
+            }
+        }
+        catch ( ... )
+        {
+            // the threads already started still refer to the locals, and destroying them unjoined terminates
+            for ( auto & thread : threads ) { thread.join(); }
+            throw;
+        }
+
+        for ( auto & thread : threads ) { thread.join(); }
+    }
+
+    filter_stats total{};
+    for ( std::size_t i{ 0 }; i < std::size( chunks ); ++i )
+    {
+        total += stats[ i ];
+        for ( auto const record : matches[ i ] ) { on_match( record ); }
+    }
+
+    return total;
+}
+
+} // namespace booleval::stream
+
+#endif // BOOLEVAL_PARALLEL_FILTER_HPP
@@ -38,7 +38,9 @@ namespace booleval::token
 /**
  * enum class token_type
  *
- * Represents a token type. Supported types are logical operators, relational operators, parentheses and field.
+ * Represents a token type. Supported types are logical operators, relational operators, parentheses,
+ * field and parameter placeholder. New types are only appended, since the types are stored in
+ * the images of compiled expressions.
  */
 enum class [[ nodiscard ]] token_type : std::uint8_t
 {
@@ -76,7 +78,10 @@ enum class [[ nodiscard ]] token_type : std::uint8_t
     lp,
 
     // Right parenthesis token type
-    rp
+    rp,
+
+    // Parameter placeholder token type, e.g. $1
+    parameter
 };
 
 } // namespace booleval::token
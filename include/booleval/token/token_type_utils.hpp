@@ -32,6 +32,7 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
 #include <utility>
 #include <string_view>
 
@@ -124,6 +125,47 @@ namespace internal
     return parentheses_symbols;
 }
 
+constexpr char        parameter_symbol    { '$' };
+constexpr std::size_t max_parameter_digits{ 9   };
+
+/**
+ * Checks whether the token value is a parameter placeholder, i.e. the parameter
+ * symbol followed by the 1-based index of the parameter, e.g. $1 or $12.
+ *
+ * @param value Token value
+ *
+ * @return True if the value is a parameter placeholder, otherwise false
+ */
+[[ nodiscard ]] constexpr bool is_parameter( std::string_view const value ) noexcept
+{
+    if ( std::size( value ) < 2 || std::size( value ) > max_parameter_digits + 1 ) { return false; }
+    if ( value[ 0 ] != parameter_symbol || value[ 1 ] == '0' )                      { return false; }
+
+    for ( std::size_t i{ 1 }; i < std::size( value ); ++i )
+    {
+        if ( value[ i ] < '0' || value[ i ] > '9' ) { return false; }
+    }
+
+    return true;
+}
+
+/**
+ * Gets the 0-based index of the parameter the placeholder refers to.
+ *
+ * @param value Parameter placeholder, e.g. $1
+ *
+ * @return Parameter index
+ */
+[[ nodiscard ]] constexpr std::uint32_t to_parameter_index( std::string_view const value ) noexcept
+{
+    std::uint32_t index{ 0 };
+    for ( std::size_t i{ 1 }; i < std::size( value ); ++i )
+    {
+        index = index * 10 + static_cast< std::uint32_t >( value[ i ] - '0' );
+    }
+    return index - 1;
+}
+
 /**
  * Maps token value to token type.
  *
@@ -167,6 +209,11 @@ constexpr token_type to_token_type( std::string_view const value ) noexcept
         return symbol->second;
     }
 
+    if ( is_parameter( value ) )
+    {
+        return token_type::parameter;
+    }
+
     return token_type::field;
 }
 
@@ -34,6 +34,7 @@
 #include <iostream>
 #include <string_view>
 
+#include <booleval/limits.hpp>
 #include <booleval/token/token.hpp>
 #include <booleval/utils/string_utils.hpp>
 #include <booleval/utils/split_options.hpp>
@@ -44,12 +45,20 @@ namespace booleval::token
 
 /**
  * Tokenizes given expression, i.e. transforms given expression
- * from string to the collection of token objects.
+ * from string to the collection of token objects. Tokenizing stops
+ * as soon as the expression exceeds any of the limits.
+ *
+ * @param expression Expression to tokenize
+ * @param limits     Limits of the expression
+ *
+ * @return Tokens, empty if the expression exceeds the limits
  */
-inline std::vector< token > tokenize( std::string_view const expression ) noexcept
+inline std::vector< token > tokenize( std::string_view const expression, limits const & limits = {} ) noexcept
 {
     std::vector< token > result;
 
+    if ( std::size( expression ) > limits.max_length ) { return result; }
+
     constexpr auto parentheses_symbols{ get_parentheses_symbols() };
     constexpr auto split_options
     {
@@ -75,14 +84,18 @@ inline std::vector< token > tokenize( std::string_view const expression ) noexce
 
         auto const type{ is_quoted ? token_type::field : to_token_type( value ) };
 
-        if ( type == token_type::field )
+        if ( type == token_type::field || type == token_type::parameter )
         {
+            if ( std::size( value ) > limits.max_literal_bytes ) { return {}; }
+
             if ( !result.empty() && result.back().is( token_type::field ) )
             {
+                if ( std::size( result ) >= limits.max_tokens ) { return {}; }
                 result.emplace_back( token_type::eq, to_token_keyword( token_type::eq ) );
             }
         }
 
+        if ( std::size( result ) >= limits.max_tokens ) { return {}; }
         result.emplace_back( type, value );
     }
 
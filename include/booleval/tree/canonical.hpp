@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_CANONICAL_HPP
+#define BOOLEVAL_CANONICAL_HPP
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <string_view>
+
+#include <booleval/token/token.hpp>
+#include <booleval/token/token_type.hpp>
+#include <booleval/token/token_type_utils.hpp>
+#include <booleval/tree/node.hpp>
+#include <booleval/tree/tree.hpp>
+
+namespace booleval::tree
+{
+
+namespace internal
+{
+
+    /**
+     * Compares two subtrees structurally, by the token types and values of
+     * their nodes in pre-order. Missing nodes precede the present ones.
+     *
+     * @param lhs Root of the first subtree
+     * @param rhs Root of the second subtree
+     *
+     * @return Negative if the first subtree precedes the second one, zero if they
+     *         are equal, otherwise positive
+     */
+    [[ nodiscard ]] inline int compare( node const * const lhs, node const * const rhs ) noexcept
+    {
+        if ( lhs == nullptr || rhs == nullptr )
+        {
+            return static_cast< int >( lhs != nullptr ) - static_cast< int >( rhs != nullptr );
+        }
+
+        if ( lhs->token.type() != rhs->token.type() )
+        {
+            return lhs->token.type() < rhs->token.type() ? -1 : 1;
+        }
+
+        if ( auto const values{ lhs->token.value().compare( rhs->token.value() ) }; values != 0 )
+        {
+            return values;
+        }
+
+        if ( auto const left{ compare( lhs->left.get(), rhs->left.get() ) }; left != 0 )
+        {
+            return left;
+        }
+
+        return compare( lhs->right.get(), rhs->right.get() );
+    }
+
+    inline std::unique_ptr< node > canonical( std::unique_ptr< node > root );
+
+    /**
+     * Collects the operands of the chain of the same logical operation, regardless
+     * of how the chain is grouped, and brings each of them into the canonical form.
+     *
+     * @param type     Logical operation of the chain
+     * @param root     Root of the chain
+     * @param operands Operands collected
+     */
+    inline void collect
+    (
+        token::token_type                const   type,
+        std::unique_ptr< node >                  root,
+        std::vector< std::unique_ptr< node > > & operands
+    )
+    {
+        if ( root->token.is( type ) && root->left != nullptr && root->right != nullptr )
+        {
+            collect( type, std::move( root->left  ), operands );
+            collect( type, std::move( root->right ), operands );
+        }
+        else
+        {
+            operands.push_back( canonical( std::move( root ) ) );
+        }
+    }
+
+    /**
+     * Brings the subtree into the canonical form.
+     *
+     * @param root Root of the subtree
+     *
+     * @return Root of the canonical subtree
+     */
+    inline std::unique_ptr< node > canonical( std::unique_ptr< node > root )
+    {
+        auto const type{ root->token.type() };
+
+        if ( type == token::token_type::logical_and || type == token::token_type::logical_or )
+        {
+            if ( root->left == nullptr || root->right == nullptr ) { return root; }
+
+            std::vector< std::unique_ptr< node > > operands;
+            collect( type, std::move( root ), operands );
+
+            std::sort
+            (
+                std::begin( operands ),
+                std::end  ( operands ),
+                []( auto const & lhs, auto const & rhs ) noexcept
+                {
+                    return compare( lhs.get(), rhs.get() ) < 0;
+                }
+            );
+
+            // an operand repeated within the chain does not change its result
+            auto const last
+            {
+                std::unique
+                (
+                    std::begin( operands ),
+                    std::end  ( operands ),
+                    []( auto const & lhs, auto const & rhs ) noexcept
+                    {
+                        return compare( lhs.get(), rhs.get() ) == 0;
+                    }
+                )
+            };
+            operands.erase( last, std::end( operands ) );
+
+            return join( type, operands, 0, std::size( operands ) );
+        }
+
+        auto const keyword{ token::to_token_keyword( type ) };
+        if ( !keyword.empty() )
+        {
+            root->token = token::token{ type, keyword };
+        }
+
+        return root;
+    }
+
+    /**
+     * Feeds the bytes into the 64-bit FNV-1a hash.
+     *
+     * @param hash  Hash so far
+     * @param bytes Bytes to be hashed
+     *
+     * @return Hash of the bytes
+     */
+    [[ nodiscard ]] constexpr std::uint64_t fnv1a( std::uint64_t hash, std::string_view const bytes ) noexcept
+    {
+        for ( auto const byte : bytes )
+        {
+            hash ^= static_cast< unsigned char >( byte );
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    /**
+     * Feeds the subtree into the structural hash, in pre-order. Each node is represented by its
+     * token type, the length of its token value and the value itself, and each missing node by
+     * the marker no token type is equal to.
+     *
+     * @param hash Hash so far
+     * @param root Root of the subtree
+     *
+     * @return Hash of the subtree
+     */
+    [[ nodiscard ]] inline std::uint64_t hash( std::uint64_t hash, node const * const root ) noexcept
+    {
+        if ( root == nullptr )
+        {
+            return fnv1a( hash, std::string_view{ "\xFF", 1 } );
+        }
+
+        auto const value{ root->token.value() };
+        auto const size { static_cast< std::uint32_t >( std::size( value ) ) };
+
+        char const header[]
+        {
+            static_cast< char >( root->token.type() ),
+            static_cast< char >(   size          & 0xFF ),
+            static_cast< char >( ( size >>  8 ) & 0xFF ),
+            static_cast< char >( ( size >> 16 ) & 0xFF ),
+            static_cast< char >( ( size >> 24 ) & 0xFF )
+        };
+
+        hash = fnv1a( hash, std::string_view{ header, sizeof( header ) } );
+        hash = fnv1a( hash, value );
+        hash = internal::hash( hash, root->left.get() );
+        return internal::hash( hash, root->right.get() );
+    }
+
+} // namespace internal
+
+/**
+ * Brings the expression tree into the canonical form, so that the expressions that
+ * differ only in the way they are written result in the same tree:
+ *
+ *   - operators are spelled by their lowercase keywords, e.g. "&&" and "AND" become "and",
+ *     and "==" as well as the "eq" implicitly inserted between a field and a value become "eq"
+ *   - chains of the same logical operation are regrouped regardless of the parentheses,
+ *     their operands are sorted and the repeated ones are removed
+ *
+ * The canonical tree evaluates the same way as the original one, except that evaluation
+ * may report another error first, since the operands of logical operations are reordered.
+ * Field names and values are compared exactly as written, e.g. 1 and 1.0 are different.
+ *
+ * @param root Root of the expression tree
+ *
+ * @return Root of the canonical expression tree, nullptr if the tree is empty
+ */
+[[ nodiscard ]] inline std::unique_ptr< node > canonicalize( std::unique_ptr< node > root )
+{
+    if ( root == nullptr ) { return nullptr; }
+
+    return internal::canonical( std::move( root ) );
+}
+
+/**
+ * Checks whether the expression trees are structurally equal, i.e. have the same token types
+ * and values in the same places. It tells apart the trees whose structural hashes collide.
+ *
+ * @param lhs Root of the first expression tree
+ * @param rhs Root of the second expression tree
+ *
+ * @return True if the trees are equal, otherwise false
+ */
+[[ nodiscard ]] inline bool equal( node const & lhs, node const & rhs ) noexcept
+{
+    return internal::compare( &lhs, &rhs ) == 0;
+}
+
+/**
+ * Computes the structural hash of the expression tree, i.e. the 64-bit FNV-1a hash of
+ * its token types and values in pre-order. It does not depend on the platform, the process
+ * or the addresses of the nodes, so it can be stored and shared, e.g. as the key of the cache
+ * of compiled expressions. Trees in the canonical form have the same hash whenever their
+ * expressions differ only in the way they are written.
+ *
+ * @param root Root of the expression tree
+ *
+ * @return Structural hash
+ */
+[[ nodiscard ]] inline std::uint64_t hash( node const & root ) noexcept
+{
+    return internal::hash( 0xcbf29ce484222325ULL, &root );
+}
+
+} // namespace booleval::tree
+
+#endif // BOOLEVAL_CANONICAL_HPP
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_FIELD_MEMO_HPP
+#define BOOLEVAL_FIELD_MEMO_HPP
+
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+namespace booleval::tree
+{
+
+/**
+ * @class field_memo
+ *
+ * Represents the memo of the field values fetched while evaluating a single
+ * object, keyed by the slot the field is bound to. Each field referenced by
+ * several relational operations, e.g. x in "x > 5 and x < 10 or x == 42",
+ * is fetched at most once per object. The values are kept on the stack and
+ * constructed only when fetched, so the memo never allocates. Once the memo
+ * is full, the fields not memoized yet are fetched every time.
+ *
+ * @tparam T        Type of the field values
+ * @tparam Capacity Number of values memoized
+ */
+template< typename T, std::size_t Capacity >
+class field_memo
+{
+    static_assert( Capacity > 0, "Memo has to hold at least one value." );
+
+public:
+    field_memo() noexcept = default;
+
+    field_memo( field_memo       && rhs ) = delete;
+    field_memo( field_memo const  & rhs ) = delete;
+
+    field_memo& operator=( field_memo       && rhs ) = delete;
+    field_memo& operator=( field_memo const  & rhs ) = delete;
+
+    ~field_memo() noexcept
+    {
+        for ( std::size_t i{ 0 }; i < size_; ++i )
+        {
+            value( i ).~T();
+        }
+    }
+
+    /**
+     * Applies the comparison to the value of the field bound to the slot,
+     * fetching the value first unless it is already memoized.
+     *
+     * @param slot    Slot the field is bound to
+     * @param fetch   Function fetching the field value
+     * @param compare Comparison function applied to the field value
+     *
+     * @return Result of the comparison
+     */
+    template< typename F, typename C >
+    [[ nodiscard ]] bool apply( std::uint32_t const slot, F && fetch, C && compare ) noexcept
+    {
+        for ( std::size_t i{ 0 }; i < size_; ++i )
+        {
+            if ( slots_[ i ] == slot ) { return compare( value( i ) ); }
+        }
+
+        if ( size_ == Capacity ) { return compare( fetch() ); }
+
+        ::new ( static_cast< void * >( storage_[ size_ ] ) ) T( fetch() );
+        slots_[ size_ ] = slot;
+
+        return compare( value( size_++ ) );
+    }
+
+private:
+    [[ nodiscard ]] T & value( std::size_t const index ) noexcept
+    {
+        return *std::launder( reinterpret_cast< T * >( storage_[ index ] ) );
+    }
+
+    alignas( T ) std::byte storage_[ Capacity ][ sizeof( T ) ];
+    std::uint32_t          slots_  [ Capacity ];
+    std::size_t            size_{ 0 };
+};
+
+} // namespace booleval::tree
+
+#endif // BOOLEVAL_FIELD_MEMO_HPP
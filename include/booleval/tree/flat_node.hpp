@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_FLAT_NODE_HPP
+#define BOOLEVAL_FLAT_NODE_HPP
+
+#include <limits>
+#include <cstdint>
+
+#include <booleval/token/token_type.hpp>
+
+namespace booleval::tree
+{
+
+/**
+ * struct flat_node
+ *
+ * Represents the compact expression tree node stored in a contiguous array.
+ * Instead of pointers, it references other records by their 32-bit indices.
+ * For logical operations, left and right are the indices of the child nodes.
+ * For relational operations, left is the index of the field and right is
+ * the index of the constant the field is compared against or, if flagged by
+ * parameter_flag, the index of the parameter.
+ */
+struct flat_node
+{
+    static constexpr std::uint32_t npos          { std::numeric_limits< std::uint32_t >::max() };
+    static constexpr std::uint32_t parameter_flag{ 0x80000000 };
+
+    token::token_type type { token::token_type::unknown };
+    std::uint32_t     left { npos };
+    std::uint32_t     right{ npos };
+
+    /**
+     * Checks whether the node has both operands.
+     *
+     * @return True if the node has both operands, otherwise false
+     */
+    [[ nodiscard ]] constexpr bool has_operands() const noexcept
+    {
+        return left != npos && right != npos;
+    }
+};
+
+static_assert( sizeof( flat_node ) <= 16, "Flat node must fit into 16 bytes." );
+
+} // namespace booleval::tree
+
+#endif // BOOLEVAL_FLAT_NODE_HPP
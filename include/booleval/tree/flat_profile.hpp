@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_FLAT_PROFILE_HPP
+#define BOOLEVAL_FLAT_PROFILE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <booleval/compiled_expression.hpp>
+#include <booleval/tree/flat_visitor.hpp>
+
+namespace booleval::tree
+{
+
+/**
+ * struct node_profile
+ *
+ * Represents the profile of a single node of the compiled expression.
+ */
+struct node_profile
+{
+    std::uint64_t evaluations{ 0 }; // times the node was evaluated, i.e. not short-circuited
+    std::uint64_t matches    { 0 }; // times the node was satisfied
+
+    /**
+     * Gets the ratio of the evaluations satisfying the node.
+     *
+     * @return Selectivity in range [0, 1]
+     */
+    [[ nodiscard ]] constexpr double selectivity() const noexcept
+    {
+        return evaluations == 0 ? 0.0 : static_cast< double >( matches ) / static_cast< double >( evaluations );
+    }
+};
+
+/**
+ * @class flat_profile
+ *
+ * Represents the per-node profile of evaluating the compiled expression. It
+ * evaluates the expression the same way the flat visitor does, short-circuiting
+ * logical operations, while counting how many times each node is evaluated and
+ * satisfied. It is meant for finding out which predicates are expensive or rarely
+ * reached, not for the hot path of the evaluation.
+ */
+class flat_profile
+{
+public:
+    flat_profile() = default;
+
+    /**
+     * Creates the empty profile of the compiled expression.
+     *
+     * @param expression Compiled expression
+     */
+    explicit flat_profile( compiled_expression const & expression )
+        : nodes_( expression.size() )
+    {}
+
+    /**
+     * Checks whether the field values provided by the accessor satisfy the node
+     * of the compiled expression and records the evaluation of the visited nodes.
+     *
+     * @param expression Compiled expression the profile is created for
+     * @param index      Index of the currently visited node
+     * @param accessor   Field value accessor
+     *
+     * @return True if the field values satisfy the expression, otherwise false
+     */
+    template< typename A >
+    [[ nodiscard ]] bool matches
+    (
+        compiled_expression const & expression,
+        std::uint32_t       const   index,
+        A                        && accessor
+    ) noexcept
+    {
+        auto const & node{ expression.node( index ) };
+
+        bool satisfied{ false };
+        switch ( node.type )
+        {
+            case token::token_type::logical_and:
+                satisfied = node.has_operands() &&
+                            matches( expression, expression.first_operand( index ), accessor ) &&
+                            matches( expression, expression.second_operand( index ), accessor );
+                break;
+
+            case token::token_type::logical_or:
+                satisfied = node.has_operands() &&
+                            ( matches( expression, expression.first_operand( index ), accessor ) ||
+                              matches( expression, expression.second_operand( index ), accessor ) );
+                break;
+
+            default:
+                satisfied = flat_visitor::matches( expression, index, accessor );
+                break;
+        }
+
+        auto & profile{ nodes_[ index ] };
+        ++profile.evaluations;
+        profile.matches += satisfied ? 1 : 0;
+
+        return satisfied;
+    }
+
+    /**
+     * Gets the number of the profiled nodes.
+     *
+     * @return Number of nodes
+     */
+    [[ nodiscard ]] std::size_t size() const noexcept
+    {
+        return std::size( nodes_ );
+    }
+
+    /**
+     * Gets the profile of the node.
+     *
+     * @param index Index of the node in the compiled expression
+     *
+     * @return Node profile
+     */
+    [[ nodiscard ]] node_profile const & operator[]( std::size_t const index ) const noexcept
+    {
+        return nodes_[ index ];
+    }
+
+    /**
+     * Resets the profile of all the nodes.
+     */
+    void reset() noexcept
+    {
+        for ( auto & node : nodes_ ) { node = {}; }
+    }
+
+    /**
+     * Adds up the profiles of the same compiled expression, e.g. the ones
+     * collected by different threads.
+     */
+    flat_profile & operator+=( flat_profile const & rhs )
+    {
+        if ( std::size( nodes_ ) < std::size( rhs.nodes_ ) ) { nodes_.resize( std::size( rhs.nodes_ ) ); }
+
+        for ( std::size_t i{ 0 }; i < std::size( rhs.nodes_ ); ++i )
+        {
+            nodes_[ i ].evaluations += rhs.nodes_[ i ].evaluations;
+            nodes_[ i ].matches     += rhs.nodes_[ i ].matches;
+        }
+        return *this;
+    }
+
+private:
+    std::vector< node_profile > nodes_{};
+};
+
+} // namespace booleval::tree
+
+#endif // BOOLEVAL_FLAT_PROFILE_HPP
@@ -0,0 +1,632 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_FLAT_VISITOR_HPP
+#define BOOLEVAL_FLAT_VISITOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <string_view>
+#include <type_traits>
+
+#include <booleval/result.hpp>
+#include <booleval/parameter.hpp>
+#include <booleval/compiled_expression.hpp>
+#include <booleval/tree/flat_node.hpp>
+#include <booleval/utils/compare_utils.hpp>
+
+namespace booleval::tree
+{
+
+/**
+ * @class flat_visitor
+ *
+ * Represents a visitor for the compiled expression, i.e. the expression tree
+ * flattened into a contiguous array of nodes. Field values are obtained through
+ * the accessor which is called with the slot the field is bound to and the
+ * comparison function to be applied to the field value:
+ *
+ *     bool accessor( std::uint32_t slot, auto && compare );
+ *
+ * The visitor does not throw, so neither may the accessor, i.e. it has to be
+ * declared noexcept. Only select may throw, if the output iterator it writes to does.
+ *
+ * Parameter placeholders are resolved through the parameter frame, either
+ * the one supplied by the caller or the one bound to the compiled expression.
+ * Short-circuiting evaluation follows the schedule of the compiled expression,
+ * i.e. evaluates the cheaper operand of logical operations first.
+ *
+ * Blocks of up to 64 objects are evaluated at once by select, where the rows
+ * still to be checked are the bits set in the selection mask. Such accessor
+ * is called with the row of the block as well:
+ *
+ *     bool accessor( std::uint32_t slot, std::uint32_t row, auto && compare );
+ */
+class flat_visitor
+{
+public:
+    /**
+     * Maximum number of objects of a block evaluated at once by select,
+     * i.e. the number of bits of the selection mask.
+     */
+    static constexpr std::uint32_t block_size{ 64 };
+
+    /**
+     * Checks whether writing the positions of the objects selected to the output
+     * iterator does not throw, in which case select does not throw either.
+     */
+    template< typename O >
+    static constexpr bool is_nothrow_output
+    {
+        std::is_nothrow_copy_constructible_v< O > &&
+        noexcept( *std::declval< O & >()++ = std::size_t{} )
+    };
+
+    /**
+     * Visits the node of the compiled expression by checking its token type.
+     *
+     * @param expression Compiled expression
+     * @param index      Index of the currently visited node
+     * @param accessor   Field value accessor
+     *
+     * @return Result
+     */
+    template< typename A >
+    [[ nodiscard ]] static result visit
+    (
+        compiled_expression const & expression,
+        std::uint32_t       const   index,
+        A                        && accessor
+    ) noexcept
+    {
+        return visit( expression, index, accessor, expression.parameters() );
+    }
+
+    /**
+     * Visits the node of the compiled expression by checking its token type,
+     * resolving the parameter placeholders through the frame supplied.
+     *
+     * @param expression Compiled expression
+     * @param index      Index of the currently visited node
+     * @param accessor   Field value accessor
+     * @param parameters Parameter values
+     *
+     * @return Result
+     */
+    template< typename A >
+    [[ nodiscard ]] static result visit
+    (
+        compiled_expression const & expression,
+        std::uint32_t       const   index,
+        A                        && accessor,
+        parameter_frame     const & parameters
+    ) noexcept
+    {
+        auto const & node{ expression.node( index ) };
+        if ( !node.has_operands() )
+        {
+            return { false, "Missing operand" };
+        }
+
+        switch ( node.type )
+        {
+            case token::token_type::logical_and: return visit_logical   ( expression, node, accessor, parameters, std::logical_and<>()   );
+            case token::token_type::logical_or : return visit_logical   ( expression, node, accessor, parameters, std::logical_or<>()    );
+            case token::token_type::eq         : return visit_relational( expression, node, accessor, parameters, std::equal_to<>()      );
+            case token::token_type::neq        : return visit_relational( expression, node, accessor, parameters, std::not_equal_to<>()  );
+            case token::token_type::gt         : return visit_relational( expression, node, accessor, parameters, std::greater<>()       );
+            case token::token_type::lt         : return visit_relational( expression, node, accessor, parameters, std::less<>()          );
+            case token::token_type::geq        : return visit_relational( expression, node, accessor, parameters, std::greater_equal<>() );
+            case token::token_type::leq        : return visit_relational( expression, node, accessor, parameters, std::less_equal<>()    );
+
+            default:
+                return { false, "Unknown token type" };
+        }
+    }
+
+    /**
+     * Checks whether the field values provided by the accessor satisfy the node
+     * of the compiled expression. It short-circuits logical operations.
+     *
+     * @param expression Compiled expression
+     * @param index      Index of the currently visited node
+     * @param accessor   Field value accessor
+     *
+     * @return True if the field values satisfy the expression, otherwise false
+     */
+    template< typename A >
+    [[ nodiscard ]] static bool matches
+    (
+        compiled_expression const & expression,
+        std::uint32_t       const   index,
+        A                        && accessor
+    ) noexcept
+    {
+        return matches( expression, index, accessor, expression.parameters() );
+    }
+
+    /**
+     * Checks whether the field values provided by the accessor satisfy the node
+     * of the compiled expression, resolving the parameter placeholders through
+     * the frame supplied. It short-circuits logical operations.
+     *
+     * @param expression Compiled expression
+     * @param index      Index of the currently visited node
+     * @param accessor   Field value accessor
+     * @param parameters Parameter values
+     *
+     * @return True if the field values satisfy the expression, otherwise false
+     */
+    template< typename A >
+    [[ nodiscard ]] static bool matches
+    (
+        compiled_expression const & expression,
+        std::uint32_t       const   index,
+        A                        && accessor,
+        parameter_frame     const & parameters
+    ) noexcept
+    {
+        auto const & node{ expression.node( index ) };
+        if ( !node.has_operands() )
+        {
+            return false;
+        }
+
+        switch ( node.type )
+        {
+            case token::token_type::logical_and:
+                return matches( expression, expression.first_operand( index ), accessor, parameters ) &&
+                       matches( expression, expression.second_operand( index ), accessor, parameters );
+
+            case token::token_type::logical_or:
+                return matches( expression, expression.first_operand( index ), accessor, parameters ) ||
+                       matches( expression, expression.second_operand( index ), accessor, parameters );
+
+            case token::token_type::eq         : return matches_relational( expression, node, accessor, parameters, std::equal_to<>()      );
+            case token::token_type::neq        : return matches_relational( expression, node, accessor, parameters, std::not_equal_to<>()  );
+            case token::token_type::gt         : return matches_relational( expression, node, accessor, parameters, std::greater<>()       );
+            case token::token_type::lt         : return matches_relational( expression, node, accessor, parameters, std::less<>()          );
+            case token::token_type::geq        : return matches_relational( expression, node, accessor, parameters, std::greater_equal<>() );
+            case token::token_type::leq        : return matches_relational( expression, node, accessor, parameters, std::less_equal<>()    );
+
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * Selects the rows of the block satisfying the node of the compiled expression.
+     * The second operand of logical and is checked only on the rows accepted by
+     * the first one, while the second operand of logical or is checked only on
+     * the rows not accepted yet, so each relational operation reads the fields
+     * of the rows still undecided only.
+     *
+     * @param expression Compiled expression
+     * @param index      Index of the currently visited node
+     * @param accessor   Field value accessor of the block
+     * @param parameters Parameter values
+     * @param rows       Selection mask of the rows to be checked
+     *
+     * @return Selection mask of the rows satisfying the node
+     */
+    template< typename A >
+    [[ nodiscard ]] static std::uint64_t select
+    (
+        compiled_expression const & expression,
+        std::uint32_t       const   index,
+        A                        && accessor,
+        parameter_frame     const & parameters,
+        std::uint64_t       const   rows
+    ) noexcept
+    {
+        auto const & node{ expression.node( index ) };
+        if ( !node.has_operands() || rows == 0 )
+        {
+            return 0;
+        }
+
+        switch ( node.type )
+        {
+            case token::token_type::logical_and:
+            {
+                auto const accepted{ select( expression, expression.first_operand( index ), accessor, parameters, rows ) };
+                return select( expression, expression.second_operand( index ), accessor, parameters, accepted );
+            }
+
+            case token::token_type::logical_or:
+            {
+                auto const accepted{ select( expression, expression.first_operand( index ), accessor, parameters, rows ) };
+                return accepted | select( expression, expression.second_operand( index ), accessor, parameters, rows & ~accepted );
+            }
+
+            case token::token_type::eq         : return select_relational( expression, node, accessor, parameters, rows, std::equal_to<>()      );
+            case token::token_type::neq        : return select_relational( expression, node, accessor, parameters, rows, std::not_equal_to<>()  );
+            case token::token_type::gt         : return select_relational( expression, node, accessor, parameters, rows, std::greater<>()       );
+            case token::token_type::lt         : return select_relational( expression, node, accessor, parameters, rows, std::less<>()          );
+            case token::token_type::geq        : return select_relational( expression, node, accessor, parameters, rows, std::greater_equal<>() );
+            case token::token_type::leq        : return select_relational( expression, node, accessor, parameters, rows, std::less_equal<>()    );
+
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * Selects the objects of the range satisfying the compiled expression, block
+     * by block, and writes their positions within the range to the output.
+     * The accessor reads the field values of a single object of the range:
+     *
+     *     bool accessor( std::uint32_t slot, auto const & obj, auto && compare );
+     *
+     * @param expression Compiled expression
+     * @param first      Beginning of the range of objects, a random access iterator
+     * @param last       End of the range of objects
+     * @param out        Output iterator the positions of the objects selected are written to
+     * @param accessor   Field value accessor of an object
+     * @param parameters Parameter values
+     *
+     * @return Output iterator past the last position written
+     */
+    template< typename It, typename O, typename A >
+    [[ nodiscard ]] static O select
+    (
+        compiled_expression const & expression,
+        It                          first,
+        It                  const   last,
+        O                           out,
+        A                        && accessor,
+        parameter_frame     const & parameters
+    ) noexcept( is_nothrow_output< O > )
+    {
+        std::size_t offset{ 0 };
+        while ( first != last )
+        {
+            auto const size
+            {
+                static_cast< std::uint32_t >( std::min< std::ptrdiff_t >( block_size, std::distance( first, last ) ) )
+            };
+
+            auto const block{ first };
+            auto const block_accessor
+            {
+                [ &accessor, block ]( std::uint32_t const slot, std::uint32_t const row, auto && compare ) noexcept
+                {
+                    static_assert
+                    (
+                        std::is_nothrow_invocable_v< A &, std::uint32_t, decltype( block[ row ] ), decltype( compare ) & >,
+                        "Accessor must be noexcept."
+                    );
+                    return accessor( slot, block[ row ], compare );
+                }
+            };
+
+            auto const rows{ size == block_size ? ~std::uint64_t{ 0 } : ( std::uint64_t{ 1 } << size ) - 1 };
+            auto       selected{ select( expression, 0, block_accessor, parameters, rows ) };
+
+            for ( std::uint32_t row{ 0 }; selected != 0; ++row, selected >>= 1 )
+            {
+                if ( ( selected & 1 ) != 0 )
+                {
+                    *out++ = offset + row;
+                }
+            }
+
+            first  += size;
+            offset += size;
+        }
+
+        return out;
+    }
+
+    /**
+     * Validates the compiled expression, i.e. checks whether all the operands
+     * and token types are known and all the fields are bound.
+     *
+     * @param expression Compiled expression
+     *
+     * @return Result containing the message of the first error found
+     */
+    [[ nodiscard ]] static result validate( compiled_expression const & expression ) noexcept
+    {
+        if ( expression.empty() )
+        {
+            return { false, "Missing operand" };
+        }
+
+        return validate( expression, 0 );
+    }
+
+private:
+    [[ nodiscard ]] static result validate
+    (
+        compiled_expression const & expression,
+        std::uint32_t       const   index
+    ) noexcept
+    {
+        auto const & node{ expression.node( index ) };
+        if ( !node.has_operands() )
+        {
+            return { false, "Missing operand" };
+        }
+
+        switch ( node.type )
+        {
+            case token::token_type::logical_and:
+            case token::token_type::logical_or :
+            {
+                auto const left{ validate( expression, node.left ) };
+                if ( !left.success ) { return left; }
+                return validate( expression, node.right );
+            }
+
+            case token::token_type::eq :
+            case token::token_type::neq:
+            case token::token_type::gt :
+            case token::token_type::lt :
+            case token::token_type::geq:
+            case token::token_type::leq:
+            {
+                if ( expression.slot( node.left ) == compiled_expression::npos )
+                {
+                    return { false, "Unknown field" };
+                }
+                return { true };
+            }
+
+            default:
+                return { false, "Unknown token type" };
+        }
+    }
+
+    /**
+     * Visits the node representing one of logical operations.
+     *
+     * @param expression Compiled expression
+     * @param node       Currently visited node
+     * @param accessor   Field value accessor
+     * @param parameters Parameter values
+     * @param f          Logical operation function
+     *
+     * @return Result
+     */
+    template< typename A, typename F >
+    [[ nodiscard ]] static result visit_logical
+    (
+        compiled_expression const & expression,
+        flat_node           const & node,
+        A                         & accessor,
+        parameter_frame     const & parameters,
+        F                        && f
+    ) noexcept
+    {
+        auto const left { visit( expression, node.left , accessor, parameters ) };
+        auto const right{ visit( expression, node.right, accessor, parameters ) };
+
+        // always pick the error message closer to the beginning of the expression
+        auto const message
+        {
+            left.message.empty() ? right.message : left.message
+        };
+
+        return { f( left.success, right.success ), message };
+    }
+
+    /**
+     * Visits the node representing one of relational operations.
+     *
+     * @param expression Compiled expression
+     * @param node       Currently visited node
+     * @param accessor   Field value accessor
+     * @param parameters Parameter values
+     * @param f          Comparison function
+     *
+     * @return Result
+     */
+    template< typename A, typename F >
+    [[ nodiscard ]] static result visit_relational
+    (
+        compiled_expression const & expression,
+        flat_node           const & node,
+        A                         & accessor,
+        parameter_frame     const & parameters,
+        F                        && f
+    ) noexcept
+    {
+        if ( expression.slot( node.left ) == compiled_expression::npos )
+        {
+            return { false, "Unknown field" };
+        }
+
+        if ( compiled_expression::is_parameter( node.right ) &&
+             !parameters[ compiled_expression::parameter_index( node.right ) ].is_bound() )
+        {
+            return { false, "Unbound parameter" };
+        }
+
+        return { matches_relational( expression, node, accessor, parameters, std::forward< F >( f ) ) };
+    }
+
+    /**
+     * Checks whether the field value satisfies the relational operation.
+     *
+     * @param expression Compiled expression
+     * @param node       Currently visited node
+     * @param accessor   Field value accessor
+     * @param parameters Parameter values
+     * @param f          Comparison function
+     *
+     * @return True if the field value satisfies the relational operation, otherwise false
+     */
+    template< typename A, typename F >
+    [[ nodiscard ]] static bool matches_relational
+    (
+        compiled_expression const & expression,
+        flat_node           const & node,
+        A                         & accessor,
+        parameter_frame     const & parameters,
+        F                        && f
+    ) noexcept
+    {
+        auto const slot{ expression.slot( node.left ) };
+        if ( slot == compiled_expression::npos )
+        {
+            return false;
+        }
+
+        if ( compiled_expression::is_parameter( node.right ) )
+        {
+            auto const & parameter{ parameters[ compiled_expression::parameter_index( node.right ) ] };
+            auto const   compare
+            {
+                [ &parameter, &f ]( auto const & value ) noexcept
+                {
+                    return parameter.compare( value, f );
+                }
+            };
+
+            static_assert( std::is_nothrow_invocable_v< A &, std::uint32_t, decltype( compare ) const & >, "Accessor must be noexcept." );
+            return accessor( slot, compare );
+        }
+
+        auto const rhs{ expression.constant( node.right ) };
+        auto const compare
+        {
+            [ rhs, &f ]( auto const & value ) noexcept
+            {
+                return utils::compare( value, rhs, f );
+            }
+        };
+
+        static_assert( std::is_nothrow_invocable_v< A &, std::uint32_t, decltype( compare ) const & >, "Accessor must be noexcept." );
+        return accessor( slot, compare );
+    }
+
+    /**
+     * Selects the rows of the block whose field value satisfies the relational operation.
+     * The operand the field value is compared to is resolved once for the whole block.
+     *
+     * @param expression Compiled expression
+     * @param node       Currently visited node
+     * @param accessor   Field value accessor of the block
+     * @param parameters Parameter values
+     * @param rows       Selection mask of the rows to be checked
+     * @param f          Comparison function
+     *
+     * @return Selection mask of the rows satisfying the relational operation
+     */
+    template< typename A, typename F >
+    [[ nodiscard ]] static std::uint64_t select_relational
+    (
+        compiled_expression const & expression,
+        flat_node           const & node,
+        A                         & accessor,
+        parameter_frame     const & parameters,
+        std::uint64_t       const   rows,
+        F                        && f
+    ) noexcept
+    {
+        auto const slot{ expression.slot( node.left ) };
+        if ( slot == compiled_expression::npos )
+        {
+            return 0;
+        }
+
+        if ( compiled_expression::is_parameter( node.right ) )
+        {
+            auto const & parameter{ parameters[ compiled_expression::parameter_index( node.right ) ] };
+
+            return select_rows
+            (
+                accessor,
+                slot,
+                rows,
+                [ &parameter, &f ]( auto const & value ) noexcept
+                {
+                    return parameter.compare( value, f );
+                }
+            );
+        }
+
+        auto const rhs{ expression.constant( node.right ) };
+
+        return select_rows
+        (
+            accessor,
+            slot,
+            rows,
+            [ rhs, &f ]( auto const & value ) noexcept
+            {
+                return utils::compare( value, rhs, f );
+            }
+        );
+    }
+
+    /**
+     * Selects the rows of the block whose field value satisfies the comparison.
+     *
+     * @param accessor Field value accessor of the block
+     * @param slot     Slot the field is bound to
+     * @param rows     Selection mask of the rows to be checked
+     * @param compare  Comparison function applied to the field value
+     *
+     * @return Selection mask of the rows satisfying the comparison
+     */
+    template< typename A, typename C >
+    [[ nodiscard ]] static std::uint64_t select_rows
+    (
+        A                 & accessor,
+        std::uint32_t const slot,
+        std::uint64_t const rows,
+        C                && compare
+    ) noexcept
+    {
+        static_assert( std::is_nothrow_invocable_v< A &, std::uint32_t, std::uint32_t, C & >, "Accessor must be noexcept." );
+
+        std::uint64_t selected{ 0 };
+        std::uint64_t remaining{ rows };
+
+        for ( std::uint32_t row{ 0 }; remaining != 0; ++row, remaining >>= 1 )
+        {
+            if ( ( remaining & 1 ) != 0 && accessor( slot, row, compare ) )
+            {
+                selected |= std::uint64_t{ 1 } << row;
+            }
+        }
+
+        return selected;
+    }
+};
+
+} // namespace booleval::tree
+
+#endif // BOOLEVAL_FLAT_VISITOR_HPP
@@ -32,6 +32,7 @@
 
 #include <memory>
 
+#include <booleval/memory_usage.hpp>
 #include <booleval/token/token.hpp>
 #include <booleval/token/token_type.hpp>
 
@@ -62,9 +63,58 @@ struct node
     node & operator=( node       && rhs ) noexcept = default;
     node & operator=( node const  & rhs ) noexcept = delete;
 
-    ~node() noexcept = default;
+    /**
+     * Destroys the subtrees iteratively, by rotating each of them into the chain of
+     * right children and destroying the chain node by node. Every node is therefore
+     * destroyed without children and destroying a deep tree does not recurse.
+     */
+    ~node() noexcept
+    {
+        for ( auto * child : { &left, &right } )
+        {
+            auto root{ std::move( *child ) };
+            while ( root != nullptr )
+            {
+                if ( root->left != nullptr )
+                {
+                    auto rotated{ std::move( root->left ) };
+                    root->left     = std::move( rotated->right );
+                    rotated->right = std::move( root );
+                    root           = std::move( rotated );
+                }
+                else
+                {
+                    root = std::move( root->right );
+                }
+            }
+        }
+    }
 };
 
+/**
+ * Gets the number of bytes dynamically allocated by the expression tree,
+ * i.e. by all the nodes the root node owns, but not by the root node itself.
+ *
+ * @param root Root node of the expression tree
+ *
+ * @return Memory usage
+ */
+[[ nodiscard ]] inline booleval::memory_usage memory_usage( node const & root ) noexcept
+{
+    booleval::memory_usage usage{};
+
+    for ( auto const * child : { root.left.get(), root.right.get() } )
+    {
+        if ( child != nullptr )
+        {
+            usage += memory_usage( *child );
+            usage.nodes += sizeof( node );
+        }
+    }
+
+    return usage;
+}
+
 } // namespace booleval::tree
 
 #endif // BOOLEVAL_NODE_HPP
\ No newline at end of file
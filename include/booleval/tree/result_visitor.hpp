@@ -32,12 +32,19 @@
 
 #include <memory>
 #include <vector>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
 #include <functional>
 #include <string_view>
 
 #include <booleval/field.hpp>
 #include <booleval/result.hpp>
+#include <booleval/parameter.hpp>
+#include <booleval/compiled_expression.hpp>
 #include <booleval/tree/node.hpp>
+#include <booleval/tree/field_memo.hpp>
+#include <booleval/tree/flat_visitor.hpp>
 
 namespace booleval::tree
 {
@@ -61,6 +68,12 @@ public:
     void fields( std::initializer_list< field_base * > fields ) noexcept
     {
         fields_ = std::vector< std::unique_ptr< field_base > >{ std::begin( fields ), std::end( fields ) };
+        memoized_ = std::any_of
+        (
+            std::cbegin( fields_ ),
+            std::cend  ( fields_ ),
+            []( auto && field ) noexcept { return is_memoized( *field ); }
+        );
     }
 
     /**
@@ -74,7 +87,360 @@ public:
     template< typename T >
     [[ nodiscard ]] constexpr result visit( node const & node, T && obj ) const noexcept;
 
+    /**
+     * Checks whether the object satisfies the expression represented by the tree node.
+     * Unlike visit, it does not report any error message, only the plain result
+     * which is the same as the one reported by visit. Therefore, it is able to
+     * short-circuit logical operations.
+     *
+     * @param node Currently visited tree node
+     * @param obj  Object to be evaluated
+     *
+     * @return True if the object satisfies the expression, otherwise false
+     */
+    template< typename T >
+    [[ nodiscard ]] constexpr bool matches( node const & node, T && obj ) const noexcept;
+
+    /**
+     * Validates the tree node against the fields set, i.e. checks whether all
+     * the operands, token types and fields are known. This is meant to be done
+     * once, before the evaluation, so that the errors are reported out of the hot path.
+     *
+     * @param node Currently visited tree node
+     *
+     * @return Result containing the message of the first error found
+     */
+    [[ nodiscard ]] result validate( node const & node ) const noexcept
+    {
+        if ( nullptr == node.left || nullptr == node.right )
+        {
+            return { false, "Missing operand" };
+        }
+
+        switch ( node.token.type() )
+        {
+            case token::token_type::logical_and:
+            case token::token_type::logical_or :
+            {
+                auto const left{ validate( *node.left ) };
+                if ( !left.success ) { return left; }
+                return validate( *node.right );
+            }
+
+            case token::token_type::eq :
+            case token::token_type::neq:
+            case token::token_type::gt :
+            case token::token_type::lt :
+            case token::token_type::geq:
+            case token::token_type::leq:
+            {
+                if ( find_field( node.left->token.value() ) == nullptr )
+                {
+                    return { false, "Unknown field" };
+                }
+                return { true };
+            }
+
+            default:
+                return { false, "Unknown token type" };
+        }
+    }
+
+    /**
+     * Binds the fields of the compiled expression to the fields set and schedules
+     * the cheaper operands of logical operations first, by the cost hints of the fields.
+     * It has to be done again whenever the fields change.
+     *
+     * @param expression Compiled expression
+     */
+    void bind( compiled_expression & expression ) const noexcept
+    {
+        expression.bind
+        (
+            [ this ]( std::string_view const name ) noexcept -> std::optional< std::size_t >
+            {
+                for ( std::size_t i{ 0 }; i < std::size( fields_ ); ++i )
+                {
+                    if ( fields_[ i ]->name == name ) { return i; }
+                }
+                return std::nullopt;
+            }
+        );
+
+        expression.schedule
+        (
+            [ this, &expression ]( std::uint32_t const index ) noexcept -> std::uint32_t
+            {
+                auto const slot{ expression.slot( index ) };
+                return slot == compiled_expression::npos ? 0 : fields_[ slot ]->options.cost;
+            }
+        );
+    }
+
+    /**
+     * Visits the compiled expression bound to the fields set.
+     *
+     * @param expression Compiled expression
+     * @param obj        Object to be evaluated
+     *
+     * @return Result
+     */
+    template< typename T >
+    [[ nodiscard ]] result visit( compiled_expression const & expression, T && obj ) const noexcept
+    {
+        return visit( expression, std::forward< T >( obj ), expression.parameters() );
+    }
+
+    /**
+     * Visits the compiled expression bound to the fields set against the parameters supplied.
+     *
+     * @param expression Compiled expression
+     * @param obj        Object to be evaluated
+     * @param parameters Parameter values
+     *
+     * @return Result
+     */
+    template< typename T >
+    [[ nodiscard ]] result visit
+    (
+        compiled_expression const & expression,
+        T                        && obj,
+        parameter_frame     const & parameters
+    ) const noexcept
+    {
+        if ( expression.empty() ) { return { false, "Missing operand" }; }
+
+        if ( memoized_ && expression.has_repeated_fields() )
+        {
+            return with_memo
+            (
+                expression,
+                [ & ]( auto & memo ) noexcept
+                {
+                    return flat_visitor::visit( expression, 0, accessor( obj, memo ), parameters );
+                }
+            );
+        }
+
+        return flat_visitor::visit( expression, 0, accessor( obj ), parameters );
+    }
+
+    /**
+     * Checks whether the object satisfies the compiled expression bound to the fields set.
+     *
+     * @param expression Compiled expression
+     * @param obj        Object to be evaluated
+     *
+     * @return True if the object satisfies the expression, otherwise false
+     */
+    template< typename T >
+    [[ nodiscard ]] bool matches( compiled_expression const & expression, T && obj ) const noexcept
+    {
+        return matches( expression, std::forward< T >( obj ), expression.parameters() );
+    }
+
+    /**
+     * Checks whether the object satisfies the compiled expression bound to the fields set
+     * against the parameters supplied.
+     *
+     * @param expression Compiled expression
+     * @param obj        Object to be evaluated
+     * @param parameters Parameter values
+     *
+     * @return True if the object satisfies the expression, otherwise false
+     */
+    template< typename T >
+    [[ nodiscard ]] bool matches
+    (
+        compiled_expression const & expression,
+        T                        && obj,
+        parameter_frame     const & parameters
+    ) const noexcept
+    {
+        if ( expression.empty() ) { return false; }
+
+        if ( memoized_ && expression.has_repeated_fields() )
+        {
+            return with_memo
+            (
+                expression,
+                [ & ]( auto & memo ) noexcept
+                {
+                    return flat_visitor::matches( expression, 0, accessor( obj, memo ), parameters );
+                }
+            );
+        }
+
+        return flat_visitor::matches( expression, 0, accessor( obj ), parameters );
+    }
+
+    /**
+     * Selects the objects of the range satisfying the compiled expression bound
+     * to the fields set, evaluating them block by block.
+     *
+     * @param expression Compiled expression
+     * @param first      Beginning of the range of objects, a random access iterator
+     * @param last       End of the range of objects
+     * @param out        Output iterator the positions of the objects selected are written to
+     *
+     * @return Output iterator past the last position written
+     */
+    template< typename It, typename O >
+    [[ nodiscard ]] O select( compiled_expression const & expression, It first, It last, O out ) const
+        noexcept( flat_visitor::is_nothrow_output< O > )
+    {
+        return select( expression, first, last, out, expression.parameters() );
+    }
+
+    /**
+     * Selects the objects of the range satisfying the compiled expression bound
+     * to the fields set against the parameters supplied, evaluating them block by block.
+     *
+     * @param expression Compiled expression
+     * @param first      Beginning of the range of objects, a random access iterator
+     * @param last       End of the range of objects
+     * @param out        Output iterator the positions of the objects selected are written to
+     * @param parameters Parameter values
+     *
+     * @return Output iterator past the last position written
+     */
+    template< typename It, typename O >
+    [[ nodiscard ]] O select
+    (
+        compiled_expression const & expression,
+        It                  const   first,
+        It                  const   last,
+        O                   const   out,
+        parameter_frame     const & parameters
+    ) const noexcept( flat_visitor::is_nothrow_output< O > )
+    {
+        if ( expression.empty() ) { return out; }
+
+        return flat_visitor::select
+        (
+            expression,
+            first,
+            last,
+            out,
+            [ this ]( std::uint32_t const slot, auto const & obj, auto && compare ) noexcept
+            {
+                return compare( fields_[ slot ]->invoke( obj ) );
+            },
+            parameters
+        );
+    }
+
+    /**
+     * Validates the compiled expression bound to the fields set.
+     *
+     * @param expression Compiled expression
+     *
+     * @return Result containing the message of the first error found
+     */
+    [[ nodiscard ]] result validate( compiled_expression const & expression ) const noexcept
+    {
+        return flat_visitor::validate( expression );
+    }
+
 private:
+    /**
+     * Finds the field with the specified name.
+     *
+     * @param name Field name
+     *
+     * @return Pointer to the field if found, otherwise nullptr
+     */
+    [[ nodiscard ]] field_base const * find_field( std::string_view const name ) const noexcept
+    {
+        auto const it
+        {
+            std::find_if
+            (
+                std::cbegin( fields_ ),
+                std::cend  ( fields_ ),
+                [ name ]( auto && field ) noexcept
+                {
+                    return field->name == name;
+                }
+            )
+        };
+
+        return it == std::end( fields_ ) ? nullptr : it->get();
+    }
+
+    /**
+     * Creates the accessor reading the bound fields of the object.
+     *
+     * @param obj Object to be evaluated
+     *
+     * @return Accessor used by the flat visitor
+     */
+    template< typename T >
+    [[ nodiscard ]] auto accessor( T & obj ) const noexcept
+    {
+        return [ this, &obj ]( std::uint32_t const slot, auto && compare ) noexcept
+        {
+            return compare( fields_[ slot ]->invoke( obj ) );
+        };
+    }
+
+    /**
+     * Checks whether the field values are worth memoizing, i.e. whether the field
+     * is both expensive to read and cacheable. Reading a cheap field again costs
+     * less than looking its value up in the memo.
+     *
+     * @param field Field
+     *
+     * @return True if the field values are memoized, otherwise false
+     */
+    [[ nodiscard ]] static bool is_memoized( field_base const & field ) noexcept
+    {
+        return field.options.cost > 0 && field.options.cacheable;
+    }
+
+    /**
+     * Calls the function with the memo on the stack, sized to the number
+     * of distinct fields of the compiled expression.
+     *
+     * @param expression Compiled expression
+     * @param f          Function called with the memo
+     *
+     * @return Value returned by the function
+     */
+    template< typename F >
+    [[ nodiscard ]] static auto with_memo( compiled_expression const & expression, F && f ) noexcept
+    {
+        if ( expression.field_count() <= 4 )
+        {
+            field_memo< utils::any_value, 4 > memo;
+            return f( memo );
+        }
+
+        field_memo< utils::any_value, 16 > memo;
+        return f( memo );
+    }
+
+    /**
+     * Creates the accessor reading the bound fields of the object, each
+     * expensive and cacheable one at most once, through the memo of the evaluation.
+     *
+     * @param obj  Object to be evaluated
+     * @param memo Memo of the field values fetched
+     *
+     * @return Accessor used by the flat visitor
+     */
+    template< typename T, typename M >
+    [[ nodiscard ]] auto accessor( T & obj, M & memo ) const noexcept
+    {
+        return [ this, &obj, &memo ]( std::uint32_t const slot, auto && compare ) noexcept
+        {
+            auto const & field{ *fields_[ slot ] };
+            if ( !is_memoized( field ) ) { return compare( field.invoke( obj ) ); }
+
+            return memo.apply( slot, [ &field, &obj ]() noexcept { return field.invoke( obj ); }, compare );
+        };
+    }
+
     /**
      * Visits tree node representing one of logical operations.
      *
@@ -111,31 +477,24 @@ private:
     template< typename T, typename F >
     [[ nodiscard ]] constexpr result visit_relational( node const & node, T && obj, F && f ) const noexcept
     {
-        auto const key{ node.left->token };
+        auto const * field{ find_field( node.left->token.value() ) };
 
-        auto const it
+        if ( field == nullptr )
         {
-            std::find_if
-            (
-                std::cbegin( fields_ ),
-                std::cend  ( fields_ ),
-                [ key ]( auto && field ) noexcept
-                {
-                    return field->name == key.value();
-                }
-            )
-        };
+            return { false, "Unknown field" };
+        }
 
-        if ( it == std::end( fields_ ) )
+        // the tree is evaluated as parsed, i.e. without any parameter values bound
+        if ( node.right->token.is( token::token_type::parameter ) )
         {
-            return { false, "Unknown field" };
+            return { false, "Unbound parameter" };
         }
 
         auto const success
         {
             f
             (
-                ( *it )->invoke( std::forward< T >( obj ) ),
+                field->invoke( std::forward< T >( obj ) ),
                 node.right->token.value()
             )
         };
@@ -143,8 +502,28 @@ private:
         return { success };
     }
 
+    /**
+     * Checks whether the object satisfies the relational operation.
+     *
+     * @param node Currently visited tree node
+     * @param obj  Object to be evaluated
+     * @param f    Comparison function
+     *
+     * @return True if the object satisfies the relational operation, otherwise false
+     */
+    template< typename T, typename F >
+    [[ nodiscard ]] constexpr bool matches_relational( node const & node, T && obj, F && f ) const noexcept
+    {
+        auto const * field{ find_field( node.left->token.value() ) };
+
+        return field != nullptr &&
+               !node.right->token.is( token::token_type::parameter ) &&
+               f( field->invoke( std::forward< T >( obj ) ), node.right->token.value() );
+    }
+
 private:
     std::vector< std::unique_ptr< field_base > > fields_;
+    bool                                         memoized_{ false };
 };
 
 template< typename T >
@@ -171,6 +550,30 @@ constexpr result result_visitor::visit( node const & node, T && obj ) const noex
     }
 }
 
+template< typename T >
+constexpr bool result_visitor::matches( node const & node, T && obj ) const noexcept
+{
+    if ( nullptr == node.left || nullptr == node.right )
+    {
+        return false;
+    }
+
+    switch ( node.token.type() )
+    {
+        case token::token_type::logical_and: return matches( *node.left, obj ) && matches( *node.right, obj );
+        case token::token_type::logical_or : return matches( *node.left, obj ) || matches( *node.right, obj );
+        case token::token_type::eq         : return matches_relational( node, obj, std::equal_to<>()      );
+        case token::token_type::neq        : return matches_relational( node, obj, std::not_equal_to<>()  );
+        case token::token_type::gt         : return matches_relational( node, obj, std::greater<>()       );
+        case token::token_type::lt         : return matches_relational( node, obj, std::less<>()          );
+        case token::token_type::geq        : return matches_relational( node, obj, std::greater_equal<>() );
+        case token::token_type::leq        : return matches_relational( node, obj, std::less_equal<>()    );
+
+        default:
+            return false;
+    }
+}
+
 } // namespace booleval::tree
 
 #endif // BOOLEVAL_RESULT_VISITOR_HPP
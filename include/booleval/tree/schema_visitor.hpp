@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_SCHEMA_VISITOR_HPP
+#define BOOLEVAL_SCHEMA_VISITOR_HPP
+
+#include <cstdint>
+#include <string_view>
+
+#include <booleval/result.hpp>
+#include <booleval/parameter.hpp>
+#include <booleval/compiled_expression.hpp>
+#include <booleval/tree/flat_visitor.hpp>
+
+namespace booleval::tree
+{
+
+/**
+ * @class schema_visitor
+ *
+ * Represents a visitor for the compiled expression in order to get the
+ * final result of the expression based on the fields described by the schema.
+ * Field names are resolved to the schema slots once, when the expression is
+ * bound, and field values are read in their native type and are never copied.
+ */
+template< typename Schema >
+class schema_visitor
+{
+public:
+    using class_type = typename Schema::class_type;
+
+    /**
+     * Binds the fields of the compiled expression to the schema slots.
+     *
+     * @param expression Compiled expression
+     */
+    void bind( compiled_expression & expression ) const noexcept
+    {
+        expression.bind( []( std::string_view const name ) noexcept { return Schema::index_of( name ); } );
+    }
+
+    /**
+     * Visits the compiled expression bound to the schema.
+     *
+     * @param expression Compiled expression
+     * @param obj        Object to be evaluated
+     *
+     * @return Result
+     */
+    [[ nodiscard ]] result visit( compiled_expression const & expression, class_type const & obj ) const noexcept
+    {
+        return visit( expression, obj, expression.parameters() );
+    }
+
+    /**
+     * Visits the compiled expression bound to the schema against the parameters supplied.
+     *
+     * @param expression Compiled expression
+     * @param obj        Object to be evaluated
+     * @param parameters Parameter values
+     *
+     * @return Result
+     */
+    [[ nodiscard ]] result visit
+    (
+        compiled_expression const & expression,
+        class_type          const & obj,
+        parameter_frame     const & parameters
+    ) const noexcept
+    {
+        if ( expression.empty() ) { return { false, "Missing operand" }; }
+
+        return flat_visitor::visit( expression, 0, accessor( obj ), parameters );
+    }
+
+    /**
+     * Checks whether the object satisfies the compiled expression bound to the schema.
+     *
+     * @param expression Compiled expression
+     * @param obj        Object to be evaluated
+     *
+     * @return True if the object satisfies the expression, otherwise false
+     */
+    [[ nodiscard ]] bool matches( compiled_expression const & expression, class_type const & obj ) const noexcept
+    {
+        return matches( expression, obj, expression.parameters() );
+    }
+
+    /**
+     * Checks whether the object satisfies the compiled expression bound to the schema
+     * against the parameters supplied.
+     *
+     * @param expression Compiled expression
+     * @param obj        Object to be evaluated
+     * @param parameters Parameter values
+     *
+     * @return True if the object satisfies the expression, otherwise false
+     */
+    [[ nodiscard ]] bool matches
+    (
+        compiled_expression const & expression,
+        class_type          const & obj,
+        parameter_frame     const & parameters
+    ) const noexcept
+    {
+        return !expression.empty() && flat_visitor::matches( expression, 0, accessor( obj ), parameters );
+    }
+
+    /**
+     * Selects the objects of the range satisfying the compiled expression bound
+     * to the schema, evaluating them block by block.
+     *
+     * @param expression Compiled expression
+     * @param first      Beginning of the range of objects, a random access iterator
+     * @param last       End of the range of objects
+     * @param out        Output iterator the positions of the objects selected are written to
+     *
+     * @return Output iterator past the last position written
+     */
+    template< typename It, typename O >
+    [[ nodiscard ]] O select( compiled_expression const & expression, It first, It last, O out ) const
+        noexcept( flat_visitor::is_nothrow_output< O > )
+    {
+        return select( expression, first, last, out, expression.parameters() );
+    }
+
+    /**
+     * Selects the objects of the range satisfying the compiled expression bound
+     * to the schema against the parameters supplied, evaluating them block by block.
+     *
+     * @param expression Compiled expression
+     * @param first      Beginning of the range of objects, a random access iterator
+     * @param last       End of the range of objects
+     * @param out        Output iterator the positions of the objects selected are written to
+     * @param parameters Parameter values
+     *
+     * @return Output iterator past the last position written
+     */
+    template< typename It, typename O >
+    [[ nodiscard ]] O select
+    (
+        compiled_expression const & expression,
+        It                  const   first,
+        It                  const   last,
+        O                   const   out,
+        parameter_frame     const & parameters
+    ) const noexcept( flat_visitor::is_nothrow_output< O > )
+    {
+        if ( expression.empty() ) { return out; }
+
+        return flat_visitor::select
+        (
+            expression,
+            first,
+            last,
+            out,
+            []( std::uint32_t const slot, class_type const & obj, auto && compare ) noexcept
+            {
+                return Schema::visit( slot, obj, compare );
+            },
+            parameters
+        );
+    }
+
+    /**
+     * Validates the compiled expression bound to the schema.
+     *
+     * @param expression Compiled expression
+     *
+     * @return Result containing the message of the first error found
+     */
+    [[ nodiscard ]] result validate( compiled_expression const & expression ) const noexcept
+    {
+        return flat_visitor::validate( expression );
+    }
+
+private:
+    /**
+     * Creates the accessor reading the schema fields of the object.
+     *
+     * @param obj Object to be evaluated
+     *
+     * @return Accessor used by the flat visitor
+     */
+    [[ nodiscard ]] static auto accessor( class_type const & obj ) noexcept
+    {
+        return [ &obj ]( std::uint32_t const slot, auto && compare ) noexcept
+        {
+            return Schema::visit( slot, obj, compare );
+        };
+    }
+};
+
+} // namespace booleval::tree
+
+#endif // BOOLEVAL_SCHEMA_VISITOR_HPP
@@ -34,6 +34,7 @@
 #include <vector>
 #include <string_view>
 
+#include <booleval/limits.hpp>
 #include <booleval/tree/node.hpp>
 #include <booleval/token/tokenizer.hpp>
 
@@ -45,29 +46,134 @@ namespace internal
 
     using tokens = std::vector< token::token >;
 
+    /**
+     * struct parser
+     *
+     * Represents the state of parsing the tokens. Parsing fails as soon as the
+     * tokens turn out not to form a valid expression or any of the limits is
+     * exceeded, and every parse function returns nullptr from then on.
+     */
+    struct parser
+    {
+        tokens           const & input;
+        booleval::limits const & bounds;
+
+        std::size_t current{ 0     };
+        std::size_t depth  { 0     };
+        std::size_t nodes  { 0     };
+        bool        failed { false };
+    };
+
     // Forward declarations
 
-    std::unique_ptr< node > parse_expression          ( tokens const & tokens, std::size_t & current );
-    std::unique_ptr< node > parse_and_operation       ( tokens const & tokens, std::size_t & current );
-    std::unique_ptr< node > parse_parentheses         ( tokens const & tokens, std::size_t & current );
-    std::unique_ptr< node > parse_relational_operation( tokens const & tokens, std::size_t & current );
-    std::unique_ptr< node > parse_terminal            ( tokens const & tokens, std::size_t & current );
+    std::unique_ptr< node > parse_expression          ( parser & p );
+    std::unique_ptr< node > parse_and_operation       ( parser & p );
+    std::unique_ptr< node > parse_operand             ( parser & p );
+    std::unique_ptr< node > parse_parentheses         ( parser & p );
+    std::unique_ptr< node > parse_relational_operation( parser & p );
+    std::unique_ptr< node > parse_terminal            ( parser & p );
+    std::unique_ptr< node > parse_value               ( parser & p );
 
     // Definitions
 
-    inline bool has_unused( tokens const & tokens, std::size_t const current ) noexcept
+    inline bool has_unused( parser const & p ) noexcept
+    {
+        return p.current < std::size( p.input );
+    }
+
+    inline std::unique_ptr< node > fail( parser & p ) noexcept
+    {
+        p.failed = true;
+        return nullptr;
+    }
+
+    /**
+     * Counts the node about to be created against the limit.
+     *
+     * @param p Parser state
+     *
+     * @return True if the node can be created, otherwise false
+     */
+    inline bool add_node( parser & p ) noexcept
+    {
+        if ( ++p.nodes > p.bounds.max_nodes ) { p.failed = true; }
+        return !p.failed;
+    }
+
+    /**
+     * Joins the operands of the chain of logical operations into the balanced tree,
+     * so that the depth of the tree, and with it the recursion of building, visiting
+     * and destroying it, grows logarithmically with the length of the chain. The
+     * operands keep their order, so the evaluation order does not change.
+     *
+     * @param type     Logical operation
+     * @param operands Operands of the chain
+     * @param first    Index of the first operand joined
+     * @param last     Index following the last operand joined
+     *
+     * @return Root of the joined operands
+     */
+    inline std::unique_ptr< node > join
+    (
+        token::token_type                        const   type,
+        std::vector< std::unique_ptr< node > >         & operands,
+        std::size_t                              const   first,
+        std::size_t                              const   last
+    )
+    {
+        if ( last - first == 1 ) { return std::move( operands[ first ] ); }
+
+        auto const middle{ first + ( last - first + 1 ) / 2 };
+
+        auto operation{ std::make_unique< node >( type ) };
+        operation->left  = join( type, operands, first , middle );
+        operation->right = join( type, operands, middle, last   );
+        return operation;
+    }
+
+    /**
+     * Parses the chain of operands joined by the logical operation.
+     *
+     * @param p     Parser state
+     * @param type  Logical operation
+     * @param parse Parse function of the operands
+     *
+     * @return Root of the chain
+     */
+    template< typename F >
+    std::unique_ptr< node > parse_chain( parser & p, token::token_type const type, F && parse )
     {
-        return current < std::size( tokens );
+        auto first{ parse( p ) };
+        if ( first == nullptr ) { return nullptr; }
+
+        if ( !has_unused( p ) || p.input[ p.current ].is_not( type ) ) { return first; }
+
+        std::vector< std::unique_ptr< node > > operands;
+        operands.push_back( std::move( first ) );
+
+        while ( has_unused( p ) && p.input[ p.current ].is( type ) )
+        {
+            ++p.current;
+            if ( !add_node( p ) ) { return nullptr; }
+
+            auto operand{ parse( p ) };
+            if ( operand == nullptr ) { return nullptr; }
+
+            operands.push_back( std::move( operand ) );
+        }
+
+        return join( type, operands, 0, std::size( operands ) );
     }
 
-    inline std::unique_ptr< node > parse_expression( tokens const & tokens, std::size_t & current )
+    inline std::unique_ptr< node > parse_expression( parser & p )
     {
-        auto left{ parse_and_operation( tokens, current ) };
+        auto expression{ parse_chain( p, token::token_type::logical_or, parse_and_operation ) };
+        if ( expression == nullptr ) { return nullptr; }
 
         auto const is_relational_operator
         {
-            has_unused( tokens, current ) &&
-            tokens[ current ].is_one_of
+            has_unused( p ) &&
+            p.input[ p.current ].is_one_of
             (
                 token::token_type::eq,
                 token::token_type::neq,
@@ -80,91 +186,59 @@ namespace internal
 
         if ( is_relational_operator )
         {
-            return nullptr;
+            return fail( p );
         }
 
-        if ( has_unused( tokens, current ) && tokens[ current ].is_not( token::token_type::logical_or ) )
-        {
-            return left;
-        }
-
-        while ( has_unused( tokens, current ) && tokens[ current ].is( token::token_type::logical_or ) )
-        {
-            ++current;
-            auto logical_or{ std::make_unique< node >( token::token_type::logical_or ) };
-
-            auto right{ parse_and_operation( tokens, current ) };
-            if ( right == nullptr ) { return nullptr; }
-
-            logical_or->left  = std::move( left  );
-            logical_or->right = std::move( right );
-            left = std::move( logical_or );
-        }
+        return expression;
+    }
 
-        return left;
+    inline std::unique_ptr< node > parse_and_operation( parser & p )
+    {
+        return parse_chain( p, token::token_type::logical_and, parse_operand );
     }
 
-    inline std::unique_ptr< node > parse_and_operation( tokens const & tokens, std::size_t & current )
+    inline std::unique_ptr< node > parse_operand( parser & p )
     {
-        auto left{ parse_parentheses( tokens, current ) };
-        if ( left == nullptr )
+        if ( has_unused( p ) && p.input[ p.current ].is( token::token_type::lp ) )
         {
-            left = parse_relational_operation( tokens, current );
+            return parse_parentheses( p );
         }
 
-        if ( left == nullptr ) { return nullptr; }
+        return parse_relational_operation( p );
+    }
 
-        while ( has_unused( tokens, current ) && tokens[ current ].is( token::token_type::logical_and ) )
-        {
-            ++current;
+    inline std::unique_ptr< node > parse_parentheses( parser & p )
+    {
+        if ( !has_unused( p ) || p.input[ p.current ].is_not( token::token_type::lp ) ) { return fail( p ); }
 
-            auto logical_and{ std::make_unique< node >( token::token_type::logical_and ) };
+        ++p.current;
 
-            auto right{ parse_parentheses( tokens, current ) };
-            if ( right == nullptr )
-            {
-                right = parse_relational_operation( tokens, current );
-            }
+        // the parser recurses once per nesting level, hence the depth limit
+        if ( ++p.depth > p.bounds.max_depth ) { return fail( p ); }
 
-            if ( right == nullptr ) { return nullptr; }
+        auto expression{ parse_expression( p ) };
+        if ( expression == nullptr ) { return nullptr; }
 
-            logical_and->left  = std::move( left  );
-            logical_and->right = std::move( right );
-            left = std::move( logical_and );
-        }
+        --p.depth;
 
-        return left;
-    }
-
-    inline std::unique_ptr< node > parse_parentheses( tokens const & tokens, std::size_t & current )
-    {
-        if ( !has_unused( tokens, current ) ) { return nullptr; }
-
-        if ( tokens[ current ].is( token::token_type::lp ) )
+        if ( !has_unused( p ) || p.input[ p.current++ ].is_not( token::token_type::rp ) )
         {
-            ++current;
-            auto expression{ parse_expression( tokens, current ) };
-            if ( !has_unused( tokens, current ) ) { return nullptr; }
-
-            if ( tokens[ current++ ].is( token::token_type::rp ) )
-            {
-                return expression;
-            }
+            return fail( p );
         }
 
-        return nullptr;
+        return expression;
     }
 
-    inline std::unique_ptr< node > parse_relational_operation( tokens const & tokens, std::size_t & current )
+    inline std::unique_ptr< node > parse_relational_operation( parser & p )
     {
-        auto left{ parse_terminal( tokens, current ) };
+        auto left{ parse_terminal( p ) };
         if ( left == nullptr ) { return nullptr; }
 
-        if ( !has_unused( tokens, current ) ) { return nullptr; }
+        if ( !has_unused( p ) || !add_node( p ) ) { return fail( p ); }
 
-        auto operation{ std::make_unique< node >( tokens[ current++ ] ) };
+        auto operation{ std::make_unique< node >( p.input[ p.current++ ] ) };
 
-        auto right{ parse_terminal( tokens, current ) };
+        auto right{ parse_value( p ) };
         if ( right == nullptr ) { return nullptr; }
 
         operation->left  = std::move( left  );
@@ -173,36 +247,58 @@ namespace internal
         return operation;
     }
 
-    inline std::unique_ptr< node > parse_terminal( tokens const & tokens, std::size_t & current )
+    inline std::unique_ptr< node > parse_terminal( parser & p )
     {
-        if ( !has_unused( tokens, current ) ) { return nullptr; }
+        if ( !has_unused( p ) ) { return fail( p ); }
 
-        auto const & token{ tokens[ current++ ] };
-        if ( token.is( token::token_type::field ) )
+        auto const & token{ p.input[ p.current++ ] };
+        if ( token.is( token::token_type::field ) && add_node( p ) )
         {
             return std::make_unique< node >( token );
         }
         else
         {
-            return nullptr;
+            return fail( p );
         }
     }
 
+    inline std::unique_ptr< node > parse_value( parser & p )
+    {
+        // the field is compared either against the constant or the parameter placeholder
+        if ( has_unused( p ) && p.input[ p.current ].is( token::token_type::parameter ) )
+        {
+            if ( !add_node( p ) ) { return nullptr; }
+            return std::make_unique< node >( p.input[ p.current++ ] );
+        }
+
+        return parse_terminal( p );
+    }
+
 } // namespace internal
 
 /**
  * Builds an expression tree by using a recursive descent parser method.
+ * Building stops as soon as the expression exceeds any of the limits,
+ * so that rejecting it takes time proportional to the limits.
+ *
+ * @param expression Expression to build the tree of
+ * @param limits     Limits of the expression
+ *
+ * @return Root of the expression tree, nullptr if the expression is not valid
  */
-std::unique_ptr< node > build( std::string_view expression )
+inline std::unique_ptr< node > build( std::string_view expression, limits const & limits = {} )
 {
-    auto const tokens{ token::tokenize( expression ) };
+    auto const tokens{ token::tokenize( expression, limits ) };
     if ( tokens.empty() ) { return nullptr; }
 
-    std::size_t current{ 0u };
+    internal::parser p{ tokens, limits };
+
+    auto root{ internal::parse_expression( p ) };
+    if ( p.failed ) { return nullptr; }
 
-    return internal::parse_expression( tokens, current );
+    return root;
 }
 
 } // namespace booleval::tree
 
-#endif // BOOLEVAL_TREE_HPP
\ No newline at end of file
+#endif // BOOLEVAL_TREE_HPP
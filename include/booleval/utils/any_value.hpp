@@ -31,6 +31,7 @@
 #define BOOLEVAL_ANY_VALUE_HPP
 
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <booleval/utils/string_utils.hpp>
 
@@ -42,6 +43,15 @@ namespace booleval::utils
  *
  * Represents the class that accepts any type of value through its constructor
  * or assignment operator and internally stores its string version.
+ *
+ * Arithmetic values are compared numerically, as doubles, except for floats
+ * which are compared in their own precision, the same way compare does it
+ * for the values of their native type.
+ *
+ * Strings passed in as lvalues (e.g. returned by a getter as std::string const &)
+ * and string views are borrowed instead of being copied. In that case, the
+ * any_value object must not outlive the string it refers to, which is the case
+ * when it is used within a single comparison.
  */
 class any_value
 {
@@ -51,70 +61,90 @@ public:
     any_value( any_value       && rhs ) = default;
     any_value( any_value const  & rhs ) = default;
 
-    template< typename T >
+    template
+    <
+        typename T,
+        typename = std::enable_if_t< !std::is_same_v< std::decay_t< T >, any_value > >
+    >
     any_value( T && rhs ) noexcept
     {
-        if constexpr ( std::is_arithmetic_v< std::remove_reference_t< T > > )
-        {
-            value_ = utils::to_chars< std::remove_reference_t< T > >( std::forward< T >( rhs ) );
-            use_string_comparison_ = false;
-        }
-        else if constexpr ( std::is_constructible_v< std::string, std::remove_reference_t< T > > )
-        {
-            value_ = std::forward< T >( rhs );
-            use_string_comparison_ = true;
-        }
+        assign( std::forward< T >( rhs ) );
     }
 
     any_value& operator=( any_value       && rhs ) = default;
     any_value& operator=( any_value const  & rhs ) = default;
 
-    template< typename T >
+    template
+    <
+        typename T,
+        typename = std::enable_if_t< !std::is_same_v< std::decay_t< T >, any_value > >
+    >
     any_value& operator=( T && rhs ) noexcept
     {
-        if constexpr ( std::is_arithmetic_v< std::remove_reference_t< T > > )
-        {
-            value_ = utils::to_chars< std::remove_reference_t< T > >( std::forward< T >( rhs ) );
-            use_string_comparison_ = false;
-        }
-        else if constexpr ( std::is_constructible_v< std::string, std::remove_reference_t< T > > )
-        {
-            value_ = std::forward< T >( rhs );
-            use_string_comparison_ = true;
-        }
+        assign( std::forward< T >( rhs ) );
         return *this;
     }
 
+    /**
+     * Gets the string version of the value, either owned or borrowed.
+     *
+     * @return String version of the value
+     */
+    [[ nodiscard ]] std::string_view value() const noexcept
+    {
+        return is_borrowed_ ? view_ : std::string_view{ value_ };
+    }
+
+    /**
+     * Checks whether the value is a float, i.e. compared in single precision.
+     *
+     * @return True if the value is a float, otherwise false
+     */
+    [[ nodiscard ]] bool is_float() const noexcept
+    {
+        return is_float_;
+    }
+
+    /**
+     * Checks whether the value is borrowed, i.e. refers to a string not owned by this object.
+     *
+     * @return True if the value is borrowed, otherwise false
+     */
+    [[ nodiscard ]] bool is_borrowed() const noexcept
+    {
+        return is_borrowed_;
+    }
+
     template< typename T >
     [[ nodiscard ]] bool operator==( T && rhs ) const noexcept
     {
-        return compare( value_, rhs, std::equal_to<>{} );
+        return compare( value(), rhs, std::equal_to<>{} );
     }
 
     template< typename T >
     [[ nodiscard ]] bool operator!=( T && rhs ) const noexcept
     {
-        return compare( value_, rhs, std::not_equal_to<>{} );
+        return compare( value(), rhs, std::not_equal_to<>{} );
     }
 
     [[ nodiscard ]] bool operator>( std::string_view const rhs ) const noexcept
     {
-        return compare( value_, rhs, std::greater<>{} );
+        return compare( value(), rhs, std::greater<>{} );
     }
 
     [[ nodiscard ]] bool operator<( std::string_view const rhs ) const noexcept
     {
-        return compare( value_, rhs, std::less<>{} );
+        return compare( value(), rhs, std::less<>{} );
     }
 
     [[ nodiscard ]] bool operator>=( std::string_view const rhs ) const noexcept
     {
-        return compare( value_, rhs, std::greater_equal<>{} );
+        return compare( value(), rhs, std::greater_equal<>{} );
     }
 
     [[ nodiscard ]] bool operator<=( std::string_view const rhs ) const noexcept
     {
-        return compare( value_, rhs, std::less_equal<>{} );
+        return compare( value(), rhs, std::less_equal<>{} );
     }
 
     ~any_value() = default;
@@ -123,14 +153,55 @@ public:
     friend bool operator!=( any_value const & lhs, any_value const & rhs ) noexcept;
 
 private:
+    template< typename T >
+    void assign( T && rhs ) noexcept
+    {
+        using value_type = std::remove_cv_t< std::remove_reference_t< T > >;
+
+        if constexpr ( std::is_arithmetic_v< value_type > )
+        {
+            value_ = utils::to_chars< value_type >( std::forward< T >( rhs ) );
+            is_borrowed_ = false;
+            is_float_ = std::is_same_v< value_type, float >;
+            use_string_comparison_ = false;
+        }
+        else if constexpr
+        (
+            std::is_convertible_v< T &&, std::string_view > &&
+            ( std::is_lvalue_reference_v< T > || !std::is_same_v< value_type, std::string > )
+        )
+        {
+            view_ = std::string_view{ rhs };
+            value_.clear();
+            is_borrowed_ = true;
+            is_float_ = false;
+            use_string_comparison_ = true;
+        }
+        else if constexpr ( std::is_constructible_v< std::string, T && > )
+        {
+            value_ = std::forward< T >( rhs );
+            is_borrowed_ = false;
+            is_float_ = false;
+            use_string_comparison_ = true;
+        }
+    }
 
     template< typename F >
     bool compare( std::string_view const lhs, std::string_view const rhs, F && f ) const noexcept
     {
         if ( use_string_comparison_ ) { return f( lhs, rhs ); }
 
-        auto const arithmetic_lhs{ utils::from_chars< double >( lhs ) };
-        auto const arithmetic_rhs{ utils::from_chars< double >( rhs ) };
+        // the float is formatted in the shortest form, so it is parsed back exactly
+        if ( is_float_ ) { return compare_numbers< float >( lhs, rhs, std::forward< F >( f ) ); }
+
+        return compare_numbers< double >( lhs, rhs, std::forward< F >( f ) );
+    }
+
+    template< typename T, typename F >
+    static bool compare_numbers( std::string_view const lhs, std::string_view const rhs, F && f ) noexcept
+    {
+        auto const arithmetic_lhs{ utils::from_chars< T >( lhs ) };
+        auto const arithmetic_rhs{ utils::from_chars< T >( rhs ) };
 
         if ( arithmetic_lhs && arithmetic_rhs )
         {
@@ -140,18 +211,21 @@ private:
         return false;
     }
 
-    std::string value_;
-    bool        use_string_comparison_{ false };
+    std::string      value_;
+    std::string_view view_{};
+    bool             is_borrowed_          { false };
+    bool             is_float_             { false };
+    bool             use_string_comparison_{ false };
 };
 
 [[ nodiscard ]] inline bool operator==( any_value const & lhs, any_value const & rhs ) noexcept
 {
-    return lhs.value_ == rhs.value_;
+    return lhs.value() == rhs.value();
 }
 
 [[ nodiscard ]] inline bool operator!=( any_value const & lhs, any_value const & rhs ) noexcept
 {
-    return lhs.value_ != rhs.value_;
+    return lhs.value() != rhs.value();
 }
 
 } // namespace booleval::utils
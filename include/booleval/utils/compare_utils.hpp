@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_COMPARE_UTILS_HPP
+#define BOOLEVAL_COMPARE_UTILS_HPP
+
+#include <string_view>
+#include <type_traits>
+
+#include <booleval/utils/any_value.hpp>
+#include <booleval/utils/string_utils.hpp>
+
+namespace booleval::utils
+{
+
+/**
+ * Compares the value of its native type against the value from the expression.
+ *
+ * Arithmetic values are compared numerically. Floating point values are compared
+ * in their own precision, while the other arithmetic values are compared as doubles.
+ * String-like values are compared lexicographically without being copied.
+ * Values already wrapped into any_value are compared the way any_value does it.
+ *
+ * @param value Value of the field in its native type
+ * @param rhs   Value from the expression
+ * @param f     Comparison function
+ *
+ * @return True if the comparison holds, false otherwise or if the values are not comparable
+ */
+template< typename T, typename F >
+[[ nodiscard ]] bool compare( T const & value, std::string_view const rhs, F && f ) noexcept
+{
+    using value_type = std::decay_t< T >;
+
+    if constexpr ( std::is_floating_point_v< value_type > )
+    {
+        auto const arithmetic_rhs{ utils::from_chars< value_type >( rhs ) };
+        return arithmetic_rhs && f( value, arithmetic_rhs.value() );
+    }
+    else if constexpr ( std::is_arithmetic_v< value_type > )
+    {
+        auto const arithmetic_rhs{ utils::from_chars< double >( rhs ) };
+        return arithmetic_rhs && f( static_cast< double >( value ), arithmetic_rhs.value() );
+    }
+    else if constexpr ( std::is_same_v< value_type, any_value > )
+    {
+        return f( value, rhs );
+    }
+    else if constexpr ( std::is_convertible_v< T const &, std::string_view > )
+    {
+        return f( std::string_view{ value }, rhs );
+    }
+    else
+    {
+        return false;
+    }
+}
+
+} // namespace booleval::utils
+
+#endif // BOOLEVAL_COMPARE_UTILS_HPP
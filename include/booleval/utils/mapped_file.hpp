@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_MAPPED_FILE_HPP
+#define BOOLEVAL_MAPPED_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <fstream>
+#include <utility>
+#include <string_view>
+
+#ifndef BOOLEVAL_HAS_MMAP
+#   if defined( __unix__ ) || defined( __APPLE__ )
+#       define BOOLEVAL_HAS_MMAP 1
+#   else
+#       define BOOLEVAL_HAS_MMAP 0
+#   endif
+#endif
+
+#if BOOLEVAL_HAS_MMAP
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#endif
+
+namespace booleval::utils
+{
+
+/**
+ * @class mapped_file
+ *
+ * Represents the file mapped into memory read-only. Where mmap is available,
+ * the mapping is shared, so all the processes mapping the same file share one
+ * physical copy of it. Otherwise, the file is read into memory.
+ */
+class mapped_file
+{
+public:
+    mapped_file() noexcept = default;
+
+    mapped_file( mapped_file && rhs ) noexcept
+    {
+        *this = std::move( rhs );
+    }
+
+    mapped_file( mapped_file const & rhs ) = delete;
+
+    /**
+     * Maps the file at the specified path.
+     *
+     * @param path Path of the file to be mapped
+     */
+    explicit mapped_file( std::string_view const path )
+    {
+#if BOOLEVAL_HAS_MMAP
+        std::string const file_path{ path };
+
+        auto const fd{ ::open( file_path.c_str(), O_RDONLY ) };
+        if ( fd < 0 ) { return; }
+
+        struct stat info{};
+        if ( ::fstat( fd, &info ) == 0 && info.st_size > 0 )
+        {
+            auto * const address{ ::mmap( nullptr, static_cast< std::size_t >( info.st_size ), PROT_READ, MAP_SHARED, fd, 0 ) };
+            if ( address != MAP_FAILED )
+            {
+                data_ = static_cast< std::byte const * >( address );
+                size_ = static_cast< std::size_t >( info.st_size );
+            }
+        }
+
+        ::close( fd );
+#else
+        std::ifstream file{ std::string{ path }, std::ios::binary | std::ios::ate };
+        if ( !file ) { return; }
+
+        buffer_.resize( static_cast< std::size_t >( file.tellg() ) );
+        file.seekg( 0 );
+        if ( file.read( reinterpret_cast< char * >( std::data( buffer_ ) ), static_cast< std::streamsize >( std::size( buffer_ ) ) ) )
+        {
+            data_ = std::data( buffer_ );
+            size_ = std::size( buffer_ );
+        }
+#endif
+    }
+
+    mapped_file & operator=( mapped_file && rhs ) noexcept
+    {
+        if ( this != &rhs )
+        {
+            unmap();
+            buffer_ = std::move( rhs.buffer_ );
+            data_   = std::exchange( rhs.data_, nullptr );
+            size_   = std::exchange( rhs.size_, 0 );
+        }
+        return *this;
+    }
+
+    mapped_file & operator=( mapped_file const & rhs ) = delete;
+
+    ~mapped_file() noexcept
+    {
+        unmap();
+    }
+
+    /**
+     * Checks whether the file is mapped.
+     *
+     * @return True if the file is mapped, otherwise false
+     */
+    [[ nodiscard ]] bool is_mapped() const noexcept
+    {
+        return data_ != nullptr;
+    }
+
+    /**
+     * Gets the mapped bytes.
+     *
+     * @return Pointer to the first mapped byte
+     */
+    [[ nodiscard ]] std::byte const * data() const noexcept
+    {
+        return data_;
+    }
+
+    /**
+     * Gets the number of mapped bytes.
+     *
+     * @return Number of mapped bytes
+     */
+    [[ nodiscard ]] std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    void unmap() noexcept
+    {
+#if BOOLEVAL_HAS_MMAP
+        if ( data_ != nullptr )
+        {
+            ::munmap( const_cast< std::byte * >( data_ ), size_ );
+        }
+#endif
+        buffer_.clear();
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+private:
+    std::vector< std::byte > buffer_;
+    std::byte const *        data_{ nullptr };
+    std::size_t              size_{ 0 };
+};
+
+} // namespace booleval::utils
+
+#endif // BOOLEVAL_MAPPED_FILE_HPP
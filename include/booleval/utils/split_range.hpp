@@ -173,10 +173,15 @@ public:
                 }
                 else
                 {
-                    return std::min
+                    // a single pass, so that finding each token does not scan the rest of the string
+                    return std::find_if
                     (
-                        find_next_quote( first, last ),
-                        find_next_delim( first, last )
+                        first,
+                        last,
+                        [ this ]( char const c ) noexcept
+                        {
+                            return c == iterator_quote_char || is_delim( c );
+                        }
                     );
                 }
             }
@@ -199,17 +204,32 @@ public:
             std::string_view::iterator const first,
             std::string_view::iterator const last
         ) const noexcept
+        {
+            return std::find_if
+            (
+                first,
+                last,
+                [ this ]( char const c ) noexcept
+                {
+                    return is_delim( c );
+                }
+            );
+        }
+
+        /**
+         * Checks whether the character is one of the delimiters.
+         *
+         * @param c Character to check
+         *
+         * @return True if the character is a delimiter, otherwise false
+         */
+        [[ nodiscard ]] constexpr bool is_delim( char const c ) const noexcept
         {
             if constexpr ( is_set( iterator_options, split_options::split_by_whitespace ) )
             {
-                auto const whitespace { std::find( first, last, whitespace_char ) };
-                auto const other_delim{ std::find_first_of( first, last, std::begin( delims_ ), std::end( delims_ ) ) };
-                return std::min( whitespace, other_delim );
-            }
-            else
-            {
-                return std::find_first_of( first, last, std::begin( delims_ ), std::end( delims_ ) );
+                if ( c == whitespace_char ) { return true; }
             }
+            return delims_.find( c ) != std::string_view::npos;
         }
 
         /**
@@ -30,15 +30,30 @@
 #ifndef BOOLEVAL_STRING_UTILS_HPP
 #define BOOLEVAL_STRING_UTILS_HPP
 
+#include <cmath>
 #include <array>
 #include <limits>
+#include <locale>
 #include <string>
+#include <cstdint>
+#include <iomanip>
 #include <numeric>
 #include <sstream>
 #include <charconv>
 #include <optional>
+#include <algorithm>
 #include <string_view>
 
+// Floating point versions of std::from_chars and std::to_chars are
+// not implemented by all standard libraries (e.g. older libstdc++ and libc++)
+#if !defined( BOOLEVAL_HAS_FLOATING_POINT_CHARCONV )
+#   if defined( __cpp_lib_to_chars ) && __cpp_lib_to_chars >= 201611L
+#       define BOOLEVAL_HAS_FLOATING_POINT_CHARCONV 1
+#   else
+#       define BOOLEVAL_HAS_FLOATING_POINT_CHARCONV 0
+#   endif
+#endif
+
 namespace booleval::utils
 {
 
@@ -152,150 +167,279 @@ template< typename InputIt >
     return result;
 }
 
-/**
- * Converts from string view to arithmetic value.
- * If value cannot be parsed, std::nullopt is returned.
- *
- * NOTE: Floating point version of std::from_chars is
- * implemented only on MSVC and not on GCC/CLANG.
- *
- * @param strv String view to convert to arithmetic value
- *
- * @return Optional value
- */
-#if defined( __GNUC__ ) || defined( __clang__ )
-template
-<
-    typename T,
-    typename std::enable_if_t< std::is_integral_v< T > >* = nullptr
->
-#elif defined( _MSC_VER )
-template
-<
-    typename T,
-    typename std::enable_if_t< std::is_arithmetic_v< T > >* = nullptr
->
-#endif
-[[ nodiscard ]] std::optional< T > from_chars( std::string_view const strv ) noexcept
+namespace internal
 {
-    T value{};
 
-    auto const result
+    /**
+     * Parses floating point value from string view in a locale-independent way.
+     *
+     * Values with a short enough mantissa and small enough exponent are computed
+     * exactly with a single multiplication or division (Clinger's fast path).
+     * All the other values are handed over to the classic locale stream.
+     *
+     * @param strv String view to convert to floating point value
+     *
+     * @return Optional value
+     */
+    template< typename T >
+    [[ nodiscard ]] std::optional< T > parse_floating_point( std::string_view const strv ) noexcept
     {
-        std::from_chars
+        constexpr std::array< double, 23 > powers_of_ten
+        {
+            1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 , 1e6 , 1e7 ,
+            1e8 , 1e9 , 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        // the largest mantissa and power of ten that are exactly representable
+        constexpr int           max_exact_exponent{ std::numeric_limits< T >::digits >= 53 ? 22 : 10 };
+        constexpr std::uint64_t max_exact_mantissa{ std::uint64_t{ 1 } << std::min( std::numeric_limits< T >::digits, 63 ) };
+        constexpr int           max_digits        { 19 };
+
+        auto       it { std::begin( strv ) };
+        auto const end{ std::end  ( strv ) };
+
+        auto const is_digit{ [ & ]( auto const i ) noexcept { return i != end && *i >= '0' && *i <= '9'; } };
+
+        bool const is_negative{ it != end && *it == '-' };
+        if ( it != end && ( *it == '-' || *it == '+' ) ) { ++it; }
+
+        std::uint64_t mantissa    { 0     };
+        int           exponent    { 0     };
+        int           digits      { 0     };
+        bool          has_digits  { false };
+        bool          is_truncated{ false };
+
+        for ( ; is_digit( it ); ++it )
+        {
+            has_digits = true;
+            if ( digits < max_digits )
+            {
+                mantissa = mantissa * 10 + static_cast< std::uint64_t >( *it - '0' );
+                if ( mantissa != 0 ) { ++digits; }
+            }
+            else
+            {
+                is_truncated |= *it != '0';
+                ++exponent;
+            }
+        }
+
+        if ( it != end && *it == '.' )
+        {
+            for ( ++it; is_digit( it ); ++it )
+            {
+                has_digits = true;
+                if ( digits < max_digits )
+                {
+                    mantissa = mantissa * 10 + static_cast< std::uint64_t >( *it - '0' );
+                    if ( mantissa != 0 ) { ++digits; }
+                    --exponent;
+                }
+                else
+                {
+                    is_truncated |= *it != '0';
+                }
+            }
+        }
+
+        if ( !has_digits ) { return std::nullopt; }
+
+        if ( it != end && ( *it == 'e' || *it == 'E' ) )
+        {
+            auto exponent_it{ std::next( it ) };
+
+            bool const is_negative_exponent{ exponent_it != end && *exponent_it == '-' };
+            if ( exponent_it != end && ( *exponent_it == '-' || *exponent_it == '+' ) ) { ++exponent_it; }
+
+            if ( is_digit( exponent_it ) )
+            {
+                int explicit_exponent{ 0 };
+                for ( ; is_digit( exponent_it ); ++exponent_it )
+                {
+                    explicit_exponent = std::min( explicit_exponent * 10 + ( *exponent_it - '0' ), 100000 );
+                }
+
+                exponent += is_negative_exponent ? -explicit_exponent : explicit_exponent;
+                it = exponent_it;
+            }
+        }
+
+        if
         (
-            std::data( strv ),
-            std::data( strv ) + std::size( strv ),
-            value
+            !is_truncated                      &&
+            mantissa <= max_exact_mantissa     &&
+            exponent >= -max_exact_exponent    &&
+            exponent <=  max_exact_exponent
         )
-    };
+        {
+            auto value{ static_cast< T >( mantissa ) };
+            auto const power{ static_cast< T >( powers_of_ten[ static_cast< std::size_t >( exponent < 0 ? -exponent : exponent ) ] ) };
 
-    if ( result.ec == std::errc() ) { return value; }
+            if ( exponent < 0 ) { value /= power; }
+            else                { value *= power; }
 
-    return std::nullopt;
-}
+            return is_negative ? -value : value;
+        }
+
+        T value{};
+
+        std::istringstream ss{ std::string{ std::begin( strv ), it } };
+        ss.imbue( std::locale::classic() );
+        ss >> value;
+
+        if ( ss.fail() ) { return std::nullopt; }
+
+        return value;
+    }
+
+    /**
+     * Formats floating point value in a locale-independent way by using
+     * the shortest precision that still parses back to the same value.
+     *
+     * @param value Floating point value to convert to string
+     *
+     * @return String representation of floating point value
+     */
+    template< typename T >
+    [[ nodiscard ]] std::string format_floating_point( T const value ) noexcept
+    {
+        std::ostringstream ss;
+        ss.imbue( std::locale::classic() );
+
+        for ( auto precision{ std::numeric_limits< T >::digits10 }; ; ++precision )
+        {
+            ss.str( {} );
+            ss << std::setprecision( precision ) << value;
+
+            auto result{ ss.str() };
+            if ( precision >= std::numeric_limits< T >::max_digits10 ) { return result; }
+
+            T parsed{};
+            std::istringstream is{ result };
+            is.imbue( std::locale::classic() );
+            is >> parsed;
+
+            if ( !is.fail() && parsed == value ) { return result; }
+        }
+    }
+
+} // namespace internal
 
 /**
  * Converts from string view to arithmetic value.
  * If value cannot be parsed, std::nullopt is returned.
  *
- * NOTE: Floating point version of std::from_chars is
- * implemented only on MSVC and not on GCC/CLANG.
+ * Parsing is locale-independent. Floating point values are parsed by
+ * std::from_chars whenever the standard library implements it, and by
+ * the bundled fast path implementation otherwise. Only finite values are
+ * numbers, so "nan", "inf" and "infinity" remain strings.
  *
  * @param strv String view to convert to arithmetic value
  *
  * @return Optional value
  */
-#if defined( __GNUC__ ) || defined( __clang__ )
 template
 <
     typename T,
-    typename std::enable_if_t< std::is_floating_point_v< T > >* = nullptr
+    typename std::enable_if_t< std::is_arithmetic_v< T > >* = nullptr
 >
 [[ nodiscard ]] std::optional< T > from_chars( std::string_view const strv ) noexcept
 {
-    T value{};
+#if !BOOLEVAL_HAS_FLOATING_POINT_CHARCONV
+    if constexpr ( std::is_floating_point_v< T > )
+    {
+        auto const value{ internal::parse_floating_point< T >( strv ) };
+        if ( value && !std::isfinite( value.value() ) ) { return std::nullopt; }
+        return value;
+    }
+    else
+#endif
+    {
+        auto first{ std::data( strv ) };
+        auto last { std::data( strv ) + std::size( strv ) };
+
+        if constexpr ( std::is_floating_point_v< T > )
+        {
+            // std::from_chars does not accept explicit plus sign
+            if ( first != last && *first == '+' ) { ++first; }
+        }
+
+        T value{};
 
-    std::stringstream ss;
-    ss << strv;
-    ss >> value;
+        auto const result{ std::from_chars( first, last, value ) };
 
-    if ( ss.fail() ) { return std::nullopt; }
+        if ( result.ec != std::errc() ) { return std::nullopt; }
 
-    return value;
+        if constexpr ( std::is_floating_point_v< T > )
+        {
+            if ( !std::isfinite( value ) ) { return std::nullopt; }
+        }
+
+        return value;
+    }
 }
-#endif
 
 /**
  * Converts from arithmetic value to string.
  *
- * NOTE: Floating point version of std::to_chars is
- * implemented only on MSVC and not on GCC/CLANG.
+ * Formatting is locale-independent. Floating point values are formatted
+ * with the shortest representation that parses back to the same value.
+ * Booleans are formatted as 1 and 0.
  *
  * @param value Arithmetic value to convert to string
  *
  * @return String representation of arithmetic value
  */
-#if defined( __GNUC__ ) || defined( __clang__ )
-template
-<
-    typename T,
-    typename std::enable_if_t< std::is_integral_v< T > >* = nullptr
->
-#elif defined( _MSC_VER )
 template
 <
     typename T,
     typename std::enable_if_t< std::is_arithmetic_v< T > >* = nullptr
 >
-#endif
 [[ nodiscard ]] std::string to_chars( T const value ) noexcept
 {
-    constexpr std::size_t buffer_size{ std::numeric_limits< T >::digits10 + 2 };  // +1 for minus, +1 for digits10
-    std::array< char, buffer_size > buffer;
-
-    auto const result
+    // booleans are represented the same way they are compared, i.e. as 1 and 0
+    if constexpr ( std::is_same_v< T, bool > )
     {
-        std::to_chars
-        (
-            std::data( buffer ),
-            std::data( buffer ) + std::size( buffer ),
-            value
-        )
-    };
-
-    if ( result.ec == std::errc() )
+        return value ? "1" : "0";
+    }
+    else
+#if !BOOLEVAL_HAS_FLOATING_POINT_CHARCONV
+    if constexpr ( std::is_floating_point_v< T > )
     {
-        return std::string( buffer.data(), result.ptr - buffer.data() );
+        return internal::format_floating_point< T >( value );
     }
+    else
+#endif
+    {
+        // +1 for minus, +1 for digits10, the rest for the decimal point and exponent
+        constexpr std::size_t buffer_size
+        {
+            std::is_floating_point_v< T >
+                ? std::numeric_limits< T >::max_digits10 + 10
+                : std::numeric_limits< T >::digits10 + 2
+        };
+        std::array< char, buffer_size > buffer;
 
-    return {};
-}
+        auto const result
+        {
+            std::to_chars
+            (
+                std::data( buffer ),
+                std::data( buffer ) + std::size( buffer ),
+                value
+            )
+        };
 
-/**
- * Converts from arithmetic value to string.
- *
- * NOTE: Floating point version of std::to_chars is
- * implemented only on MSVC and not on GCC/CLANG.
- *
- * @param value Arithmetic value to convert to string
- *
- * @return String representation of arithmetic value
- */
-#if defined( __GNUC__ ) || defined( __clang__ )
-template
-<
-    typename T,
-    typename std::enable_if_t< std::is_floating_point_v< T > >* = nullptr
->
-[[ nodiscard ]] std::string to_chars( T const value ) noexcept
-{
-    auto result{ std::to_string( value ) };
-    result = rtrim( result, '0' );
-    return result;
+        if ( result.ec == std::errc() )
+        {
+            return std::string( buffer.data(), result.ptr - buffer.data() );
+        }
+
+        return {};
+    }
 }
-#endif
 
 } // namespace booleval::utils
 
-#endif // BOOLEVAL_STRING_UTILS_HPP
\ No newline at end of file
+#endif // BOOLEVAL_STRING_UTILS_HPP
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Replaces the global operator new and delete, so that the allocations made by
+ * each thread are counted. It is linked into the test and benchmark binaries only,
+ * each of which is a program of its own, so the operators are defined exactly once.
+ */
+
+#include <new>
+#include <cstddef>
+#include <cstdlib>
+
+#include "allocation_counter.hpp"
+
+namespace booleval::testing::internal
+{
+
+    inline void * counted_allocate( std::size_t const size ) noexcept
+    {
+        ++thread_allocations.allocations;
+        thread_allocations.bytes += size;
+        return std::malloc( size == 0 ? 1 : size );
+    }
+
+    inline void * counted_allocate( std::size_t const size, std::align_val_t const alignment ) noexcept
+    {
+        ++thread_allocations.allocations;
+        thread_allocations.bytes += size;
+
+        auto const align  { static_cast< std::size_t >( alignment ) };
+        auto const rounded{ ( ( size == 0 ? 1 : size ) + align - 1 ) / align * align };
+#if defined( _MSC_VER )
+        return _aligned_malloc( rounded, align );
+#else
+        return std::aligned_alloc( align, rounded );
+#endif
+    }
+
+    inline void counted_deallocate( void * const p ) noexcept
+    {
+        if ( p == nullptr ) { return; }
+
+        ++thread_allocations.deallocations;
+        std::free( p );
+    }
+
+    inline void counted_deallocate( void * const p, std::align_val_t ) noexcept
+    {
+        if ( p == nullptr ) { return; }
+
+        ++thread_allocations.deallocations;
+#if defined( _MSC_VER )
+        _aligned_free( p );
+#else
+        std::free( p );
+#endif
+    }
+
+    template< typename... Args >
+    void * counted_allocate_or_throw( std::size_t const size, Args... args )
+    {
+        auto * const p{ counted_allocate( size, args... ) };
+        if ( p == nullptr ) { throw std::bad_alloc{}; }
+        return p;
+    }
+
+} // namespace booleval::testing::internal
+
+void * operator new  ( std::size_t size                                            ) { return booleval::testing::internal::counted_allocate_or_throw( size            ); }
+void * operator new[]( std::size_t size                                            ) { return booleval::testing::internal::counted_allocate_or_throw( size            ); }
+void * operator new  ( std::size_t size, std::align_val_t al                       ) { return booleval::testing::internal::counted_allocate_or_throw( size, al        ); }
+void * operator new[]( std::size_t size, std::align_val_t al                       ) { return booleval::testing::internal::counted_allocate_or_throw( size, al        ); }
+void * operator new  ( std::size_t size,                      std::nothrow_t const & ) noexcept { return booleval::testing::internal::counted_allocate( size     ); }
+void * operator new[]( std::size_t size,                      std::nothrow_t const & ) noexcept { return booleval::testing::internal::counted_allocate( size     ); }
+void * operator new  ( std::size_t size, std::align_val_t al, std::nothrow_t const & ) noexcept { return booleval::testing::internal::counted_allocate( size, al ); }
+void * operator new[]( std::size_t size, std::align_val_t al, std::nothrow_t const & ) noexcept { return booleval::testing::internal::counted_allocate( size, al ); }
+
+void operator delete  ( void * p                                                          ) noexcept { booleval::testing::internal::counted_deallocate( p     ); }
+void operator delete[]( void * p                                                          ) noexcept { booleval::testing::internal::counted_deallocate( p     ); }
+void operator delete  ( void * p, std::size_t                                             ) noexcept { booleval::testing::internal::counted_deallocate( p     ); }
+void operator delete[]( void * p, std::size_t                                             ) noexcept { booleval::testing::internal::counted_deallocate( p     ); }
+void operator delete  ( void * p,              std::align_val_t al                        ) noexcept { booleval::testing::internal::counted_deallocate( p, al ); }
+void operator delete[]( void * p,              std::align_val_t al                        ) noexcept { booleval::testing::internal::counted_deallocate( p, al ); }
+void operator delete  ( void * p, std::size_t, std::align_val_t al                        ) noexcept { booleval::testing::internal::counted_deallocate( p, al ); }
+void operator delete[]( void * p, std::size_t, std::align_val_t al                        ) noexcept { booleval::testing::internal::counted_deallocate( p, al ); }
+void operator delete  ( void * p,                                   std::nothrow_t const & ) noexcept { booleval::testing::internal::counted_deallocate( p     ); }
+void operator delete[]( void * p,                                   std::nothrow_t const & ) noexcept { booleval::testing::internal::counted_deallocate( p     ); }
+void operator delete  ( void * p,              std::align_val_t al, std::nothrow_t const & ) noexcept { booleval::testing::internal::counted_deallocate( p, al ); }
+void operator delete[]( void * p,              std::align_val_t al, std::nothrow_t const & ) noexcept { booleval::testing::internal::counted_deallocate( p, al ); }
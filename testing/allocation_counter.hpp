@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_ALLOCATION_COUNTER_HPP
+#define BOOLEVAL_ALLOCATION_COUNTER_HPP
+
+#include <cstdint>
+
+namespace booleval::testing
+{
+
+/**
+ * struct allocation_stats
+ *
+ * Represents the number of heap allocations and deallocations made.
+ */
+struct allocation_stats
+{
+    std::uint64_t allocations  { 0 }; // calls of operator new
+    std::uint64_t deallocations{ 0 }; // calls of operator delete with non-null pointer
+    std::uint64_t bytes        { 0 }; // bytes requested by operator new
+
+    constexpr allocation_stats operator-( allocation_stats const & rhs ) const noexcept
+    {
+        return { allocations - rhs.allocations, deallocations - rhs.deallocations, bytes - rhs.bytes };
+    }
+};
+
+namespace internal
+{
+
+    // counted per thread, so that the allocations made by other threads do not interfere
+    inline thread_local allocation_stats thread_allocations{};
+
+} // namespace internal
+
+/**
+ * Gets the allocations made by the calling thread so far. The allocations are
+ * counted by the global operator new and delete replaced in allocation_counter.cpp,
+ * which is linked into every test and benchmark binary.
+ *
+ * @return Allocations made by the calling thread
+ */
+[[ nodiscard ]] inline allocation_stats thread_allocation_stats() noexcept
+{
+    return internal::thread_allocations;
+}
+
+/**
+ * @class allocation_scope
+ *
+ * Represents the scope in which the allocations made by the calling thread are counted.
+ */
+class allocation_scope
+{
+public:
+    allocation_scope() noexcept = default;
+
+    /**
+     * Gets the allocations made by the calling thread since the scope began.
+     *
+     * @return Allocations made within the scope
+     */
+    [[ nodiscard ]] allocation_stats stats() const noexcept
+    {
+        return thread_allocation_stats() - start_;
+    }
+
+private:
+    allocation_stats start_{ thread_allocation_stats() };
+};
+
+} // namespace booleval::testing
+
+#endif // BOOLEVAL_ALLOCATION_COUNTER_HPP
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <booleval/compiled_expression.hpp>
+
+#include "allocation_counter.hpp"
+
+TEST( CompiledExpressionTest, DefaultConstructor )
+{
+    booleval::compiled_expression expression;
+
+    EXPECT_TRUE( expression.empty() );
+    EXPECT_EQ  ( expression.size(), 0U );
+    EXPECT_EQ  ( expression.field_count(), 0U );
+    EXPECT_EQ  ( expression.constant_count(), 0U );
+}
+
+TEST( CompiledExpressionTest, InvalidExpression )
+{
+    EXPECT_TRUE( booleval::compile( ""                ).empty() );
+    EXPECT_TRUE( booleval::compile( "field_a"         ).empty() );
+    EXPECT_TRUE( booleval::compile( "field_a foo and" ).empty() );
+}
+
+TEST( CompiledExpressionTest, RelationalOperation )
+{
+    auto const expression{ booleval::compile( "field_a > 1" ) };
+
+    ASSERT_EQ( expression.size(), 1U );
+
+    auto const & node{ expression.node( 0 ) };
+    EXPECT_EQ( node.type, booleval::token::token_type::gt );
+    EXPECT_EQ( expression.field   ( node.left  ), "field_a" );
+    EXPECT_EQ( expression.constant( node.right ), "1"       );
+}
+
+TEST( CompiledExpressionTest, Parameters )
+{
+    using booleval::compiled_expression;
+
+    auto expression{ booleval::compile( "field_a > $2 and field_b == foo or field_c < $1" ) };
+
+    ASSERT_FALSE( expression.empty() );
+    ASSERT_EQ   ( expression.parameter_count(), 2U );
+    ASSERT_EQ   ( expression.constant_count() , 1U );
+
+    auto const & first{ expression.node( 2 ) };
+    ASSERT_TRUE( compiled_expression::is_parameter( first.right ) );
+    ASSERT_EQ  ( compiled_expression::parameter_index( first.right ), 1U );
+    ASSERT_FALSE( expression.operand( first.right ).has_value() );
+
+    expression.bind_parameters( { "1", "2" } );
+    ASSERT_EQ( expression.operand( first.right ), "2" );
+
+    expression.bind_parameters( { "3", "4" } );
+    ASSERT_EQ( expression.operand( first.right ), "4" );
+
+    ASSERT_TRUE( booleval::compile( "field_a > $1 == 1" ).empty() );
+    ASSERT_TRUE( booleval::compile( "$1 > field_a"      ).empty() );
+
+    // the parameter count is part of the image, the values are not
+    auto const loaded{ compiled_expression::load( expression.image_data(), expression.image_size() ) };
+    ASSERT_TRUE ( loaded.has_value() );
+    ASSERT_EQ   ( loaded->parameter_count(), 2U );
+    ASSERT_FALSE( loaded->operand( first.right ).has_value() );
+}
+
+TEST( CompiledExpressionTest, Schedule )
+{
+    // or( and( field_a, field_b ), field_c ) in pre-order
+    auto expression{ booleval::compile( "field_a == 1 and field_b == 2 or field_c == 3" ) };
+    ASSERT_EQ( expression.size(), 5U );
+
+    ASSERT_EQ( expression.first_operand ( 0 ), 1U );
+    ASSERT_EQ( expression.second_operand( 0 ), 4U );
+
+    // field_b is the cheapest one and the "and" operation costs 1 + 100 / 2 > 10
+    std::uint32_t const costs[]{ 100, 1, 10 };
+    expression.schedule( [ &costs ]( std::uint32_t const index ) { return costs[ index ]; } );
+
+    ASSERT_EQ( expression.first_operand ( 0 ), 4U );
+    ASSERT_EQ( expression.second_operand( 0 ), 1U );
+    ASSERT_EQ( expression.first_operand ( 1 ), 3U );
+    ASSERT_EQ( expression.second_operand( 1 ), 2U );
+
+    // the schedule is not part of the image
+    auto const loaded{ booleval::compiled_expression::load( expression.image_data(), expression.image_size() ) };
+    ASSERT_EQ( loaded->first_operand( 0 ), 1U );
+
+    // equal costs keep the order, and scheduling again does not allocate
+    {
+        booleval::testing::allocation_scope const scope;
+        expression.schedule( []( std::uint32_t ) { return 1U; } );
+        ASSERT_EQ( scope.stats().allocations, 0U );
+    }
+    ASSERT_EQ( expression.first_operand( 0 ), 1U );
+    ASSERT_EQ( expression.first_operand( 1 ), 2U );
+}
+
+TEST( CompiledExpressionTest, PreOrderLayout )
+{
+    auto const expression{ booleval::compile( "(field_a > 1 or field_b == foo) and field_a < 5" ) };
+
+    ASSERT_EQ( expression.size(), 5U );
+
+    auto const & root{ expression.node( 0 ) };
+    EXPECT_EQ( root.type , booleval::token::token_type::logical_and );
+    EXPECT_EQ( root.left , 1U );
+    EXPECT_EQ( root.right, 4U );
+
+    auto const & logical_or{ expression.node( 1 ) };
+    EXPECT_EQ( logical_or.type , booleval::token::token_type::logical_or );
+    EXPECT_EQ( logical_or.left , 2U );
+    EXPECT_EQ( logical_or.right, 3U );
+
+    EXPECT_EQ( expression.node( 2 ).type, booleval::token::token_type::gt );
+    EXPECT_EQ( expression.node( 3 ).type, booleval::token::token_type::eq );
+    EXPECT_EQ( expression.node( 4 ).type, booleval::token::token_type::lt );
+}
+
+TEST( CompiledExpressionTest, DistinctFields )
+{
+    auto const expression{ booleval::compile( "field_a > 1 and field_b == foo and field_a < 5" ) };
+
+    ASSERT_EQ( expression.field_count()   , 2U );
+    ASSERT_EQ( expression.constant_count(), 3U );
+
+    EXPECT_EQ( expression.field( 0 ), "field_a" );
+    EXPECT_EQ( expression.field( 1 ), "field_b" );
+
+    EXPECT_EQ( expression.node( 2 ).left, expression.node( 4 ).left );
+}
+
+TEST( CompiledExpressionTest, Bind )
+{
+    auto expression{ booleval::compile( "field_a > 1 and field_b == foo" ) };
+
+    EXPECT_EQ( expression.slot( 0 ), booleval::compiled_expression::npos );
+    EXPECT_EQ( expression.slot( 1 ), booleval::compiled_expression::npos );
+
+    expression.bind
+    (
+        []( std::string_view const name ) -> std::optional< std::size_t >
+        {
+            if ( name == "field_b" ) { return 7U; }
+            return std::nullopt;
+        }
+    );
+
+    EXPECT_EQ( expression.slot( 0 ), booleval::compiled_expression::npos );
+    EXPECT_EQ( expression.slot( 1 ), 7U );
+}
+
+TEST( CompiledExpressionTest, OwnedStrings )
+{
+    std::string source{ "field_a > 1 and field_b == foo" };
+    auto const expression{ booleval::compile( source ) };
+
+    source.assign( std::size( source ), 'x' );
+    source.shrink_to_fit();
+
+    EXPECT_EQ( expression.field   ( 0 ), "field_a" );
+    EXPECT_EQ( expression.field   ( 1 ), "field_b" );
+    EXPECT_EQ( expression.constant( 0 ), "1"       );
+    EXPECT_EQ( expression.constant( 1 ), "foo"     );
+
+    auto const copy{ expression };
+    EXPECT_EQ( copy.field   ( 1 ), "field_b" );
+    EXPECT_EQ( copy.constant( 1 ), "foo"     );
+}
+
+TEST( CompiledExpressionTest, InternedStrings )
+{
+    auto const expression{ booleval::compile( "field_a == foo or field_b == foo or field_a == field_b" ) };
+
+    ASSERT_EQ( expression.constant_count(), 3U );
+
+    EXPECT_EQ( std::data( expression.constant( 0 ) ), std::data( expression.constant( 1 ) ) );
+    EXPECT_EQ( std::data( expression.constant( 2 ) ), std::data( expression.field   ( 1 ) ) );
+    EXPECT_EQ( expression.memory_usage().strings, std::size( "field_afield_bfoo" ) - 1 );
+}
+
+TEST( CompiledExpressionTest, MemoryUsage )
+{
+    EXPECT_EQ( booleval::compiled_expression{}.memory_usage().total(), 0U );
+
+    auto const expression{ booleval::compile( "field_a > 1 and field_b == foo and field_a < 5" ) };
+    auto const usage     { expression.memory_usage() };
+
+    // the image is made of the header, the nodes, the tables of 2 fields and 3 constants and the string pool
+    EXPECT_EQ( usage.nodes    , 5 * sizeof( booleval::tree::flat_node ) );
+    EXPECT_EQ( usage.tables   , ( 2 + 3 ) * 2 * sizeof( std::uint32_t ) );
+    EXPECT_EQ( usage.strings  , std::size( "field_afield_b15foo" ) - 1 );
+    EXPECT_EQ( usage.header   , expression.image_size() - usage.nodes - usage.tables - usage.strings );
+    EXPECT_EQ( usage.constants, 0U );
+    EXPECT_GE( usage.bindings , 2 * sizeof( std::uint32_t ) + 5 );
+    EXPECT_EQ( usage.total()  , usage.header + usage.nodes + usage.tables + usage.constants + usage.strings + usage.bindings );
+
+    auto const root{ booleval::tree::build( "field_a > 1 and field_b == foo and field_a < 5" ) };
+    EXPECT_LT( usage.total(), booleval::tree::memory_usage( *root ).total() );
+}
+
+TEST( CompiledExpressionTest, TotalMemoryUsage )
+{
+    std::vector< booleval::compiled_expression > expressions;
+    expressions.push_back( booleval::compile( "field_a > 1"                    ) );
+    expressions.push_back( booleval::compile( "field_a > 1 and field_b == foo" ) );
+
+    auto const total{ booleval::total_memory_usage( expressions ) };
+
+    EXPECT_EQ( total.total(), expressions[ 0 ].memory_usage().total() + expressions[ 1 ].memory_usage().total() );
+}
+
+TEST( CompiledExpressionTest, Image )
+{
+    auto const expression{ booleval::compile( "(field_a > 1 or field_b == foo) and field_a < 5" ) };
+
+    ASSERT_NE( expression.image_data(), nullptr );
+    ASSERT_TRUE( booleval::compiled_expression::check( expression.image_data(), expression.image_size() ).success );
+
+    std::vector< std::byte > const image{ expression.image_data(), expression.image_data() + expression.image_size() };
+
+    for ( auto const & loaded :
+    {
+        booleval::compiled_expression::load( std::data( image ), std::size( image ) ),
+        booleval::compiled_expression::view( std::data( image ), std::size( image ) )
+    } )
+    {
+        ASSERT_TRUE( loaded.has_value() );
+        ASSERT_EQ  ( loaded->size()          , expression.size()           );
+        ASSERT_EQ  ( loaded->field_count()   , expression.field_count()    );
+        ASSERT_EQ  ( loaded->constant_count(), expression.constant_count() );
+
+        for ( std::uint32_t i{ 0 }; i < expression.size(); ++i )
+        {
+            EXPECT_EQ( loaded->node( i ).type , expression.node( i ).type  );
+            EXPECT_EQ( loaded->node( i ).left , expression.node( i ).left  );
+            EXPECT_EQ( loaded->node( i ).right, expression.node( i ).right );
+        }
+
+        EXPECT_EQ( loaded->field   ( 1 ), "field_b" );
+        EXPECT_EQ( loaded->constant( 1 ), "foo"     );
+        EXPECT_EQ( loaded->slot    ( 1 ), booleval::compiled_expression::npos );
+    }
+
+    auto const viewed{ booleval::compiled_expression::view( std::data( image ), std::size( image ) ) };
+    EXPECT_EQ( viewed->image_data(), std::data( image ) );
+    EXPECT_EQ( viewed->memory_usage().strings, 0U );
+}
+
+TEST( CompiledExpressionTest, DeterministicImage )
+{
+    auto const lhs{ booleval::compile( "field_a > 1 and field_b == foo" ) };
+    auto const rhs{ booleval::compile( "field_a > 1 and field_b == foo" ) };
+
+    ASSERT_EQ( lhs.image_size(), rhs.image_size() );
+    EXPECT_EQ( std::memcmp( lhs.image_data(), rhs.image_data(), lhs.image_size() ), 0 );
+}
+
+TEST( CompiledExpressionTest, CorruptedImage )
+{
+    using booleval::compiled_expression;
+
+    auto const expression{ booleval::compile( "field_a > 1 and field_b == foo" ) };
+
+    std::vector< std::byte > const image{ expression.image_data(), expression.image_data() + expression.image_size() };
+
+    auto const check = [ &image ]( std::size_t const offset, std::uint32_t const value, std::size_t const size )
+    {
+        auto corrupted{ image };
+        std::memcpy( std::data( corrupted ) + offset, &value, size );
+        EXPECT_FALSE( compiled_expression::load( std::data( corrupted ), std::size( corrupted ) ).has_value() );
+        return compiled_expression::check( std::data( corrupted ), std::size( corrupted ) ).message;
+    };
+
+    EXPECT_EQ( compiled_expression::check( std::data( image ), std::size( image ) - 1 ).message, "Truncated image" );
+    EXPECT_EQ( compiled_expression::check( nullptr, 0 ).message, "Truncated image" );
+
+    EXPECT_EQ( check(  0, 0         , 4 ), "Unknown image format"      );
+    EXPECT_EQ( check(  4, 2         , 2 ), "Unsupported image version" );
+    EXPECT_EQ( check(  6, 0x0201    , 2 ), "Unsupported byte order"    );
+    EXPECT_EQ( check( 12, 4         , 4 ), "Truncated image"           );
+    EXPECT_EQ( check( 36, 0         , 4 ), "Corrupted node"            );
+    EXPECT_EQ( check( 48, 7         , 4 ), "Corrupted node"            );
+    EXPECT_EQ( check( 72, 0xFFFFFFFF, 4 ), "Corrupted string"          );
+    EXPECT_EQ( check( 52, 0x80000000, 4 ), "Corrupted node"            );
+
+    std::vector< std::uint32_t > aligned( std::size( image ) / 4 + 1 );
+    auto * misaligned{ reinterpret_cast< std::byte * >( std::data( aligned ) ) + 1 };
+    std::memcpy( misaligned, std::data( image ), std::size( image ) );
+    EXPECT_EQ( compiled_expression::check( misaligned, std::size( image ) ).message, "Misaligned image" );
+}
+
+TEST( CompiledExpressionTest, SharedNode )
+{
+    using booleval::compiled_expression;
+
+    // nodes: 0 or( 1, 4 ), 1 and( 2, 3 ), 2, 3 and 4 relational
+    auto const expression{ booleval::compile( "(field_a > 1 and field_b == foo) or field_a < 5" ) };
+
+    std::vector< std::byte > image{ expression.image_data(), expression.image_data() + expression.image_size() };
+    ASSERT_TRUE( compiled_expression::check( std::data( image ), std::size( image ) ).success );
+
+    // the right operand of the root shares the second operand of its left one
+    std::uint32_t const shared{ 3 };
+    std::memcpy( std::data( image ) + 40, &shared, sizeof( shared ) );
+
+    EXPECT_EQ( compiled_expression::check( std::data( image ), std::size( image ) ).message, "Corrupted node" );
+    EXPECT_FALSE( compiled_expression::view( std::data( image ), std::size( image ) ).has_value() );
+}
+
+TEST( CompiledExpressionTest, ImageLimits )
+{
+    using booleval::compiled_expression;
+
+    std::string expression{ "field_a == 1" };
+    for ( std::size_t i{ 0 }; i < 1100; ++i )
+    {
+        expression = "field_a == 1 and (" + expression + ")";
+    }
+
+    auto const deep{ booleval::compile( expression, booleval::limits::unlimited() ) };
+    ASSERT_FALSE( deep.empty() );
+
+    EXPECT_EQ   ( compiled_expression::check( deep.image_data(), deep.image_size() ).message, "Nodes nested too deeply" );
+    EXPECT_FALSE( compiled_expression::load ( deep.image_data(), deep.image_size() ).has_value() );
+    EXPECT_TRUE ( compiled_expression::check( deep.image_data(), deep.image_size(), booleval::limits::unlimited() ).success );
+
+    auto const shallow{ booleval::compile( "field_a > 1 and field_b == foo" ) };
+
+    booleval::limits limits{};
+    limits.max_nodes = 2;
+    EXPECT_EQ   ( compiled_expression::check( shallow.image_data(), shallow.image_size(), limits ).message, "Too many nodes" );
+    EXPECT_FALSE( compiled_expression::view ( shallow.image_data(), shallow.image_size(), limits ).has_value() );
+}
@@ -0,0 +1,667 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BOOLEVAL_DIFFERENTIAL_HPP
+#define BOOLEVAL_DIFFERENTIAL_HPP
+
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+
+#include <booleval/evaluator.hpp>
+#include <booleval/rule_set.hpp>
+#include <booleval/schema_evaluator.hpp>
+#include <booleval/compiled_expression.hpp>
+#include <booleval/tree/tree.hpp>
+#include <booleval/tree/canonical.hpp>
+#include <booleval/tree/flat_profile.hpp>
+#include <booleval/tree/result_visitor.hpp>
+#include <booleval/tree/schema_visitor.hpp>
+
+/**
+ * Differential testing of the evaluation engines. Random expressions over the
+ * fields of a typed record are evaluated against random records by every engine,
+ * i.e. by the visitors of the expression tree, the visitors of the compiled
+ * expression, the compiled expression loaded from its image and the rule set
+ * viewed from its snapshot, and all of them have to agree with the result visitor
+ * of the expression tree, which is the reference. Shared by the differential test
+ * and the expression fuzzer.
+ */
+namespace booleval::differential
+{
+
+/**
+ * struct record
+ *
+ * Represents the record the expressions are evaluated against, holding the
+ * fields of each type supported.
+ */
+struct record
+{
+    int         int_0     {};
+    int         int_1     {};
+    unsigned    unsigned_0{};
+    double      double_0  {};
+    float       float_0   {};
+    std::string string_0  {};
+    std::string string_1  {};
+    bool        bool_0    {};
+};
+
+enum class field_kind : std::uint8_t
+{
+    integer,
+    unsigned_integer,
+    floating_point,
+    string,
+    boolean
+};
+
+struct field_description
+{
+    std::string_view name;
+    field_kind       kind;
+};
+
+namespace internal
+{
+
+    inline constexpr char int_0     []{ "int_0"      };
+    inline constexpr char int_1     []{ "int_1"      };
+    inline constexpr char unsigned_0[]{ "unsigned_0" };
+    inline constexpr char double_0  []{ "double_0"   };
+    inline constexpr char float_0   []{ "float_0"    };
+    inline constexpr char string_0  []{ "string_0"   };
+    inline constexpr char string_1  []{ "string_1"   };
+    inline constexpr char bool_0    []{ "bool_0"     };
+
+    constexpr std::array fields
+    {
+        field_description{ int_0     , field_kind::integer          },
+        field_description{ int_1     , field_kind::integer          },
+        field_description{ unsigned_0, field_kind::unsigned_integer },
+        field_description{ double_0  , field_kind::floating_point   },
+        field_description{ float_0   , field_kind::floating_point   },
+        field_description{ string_0  , field_kind::string           },
+        field_description{ string_1  , field_kind::string           },
+        field_description{ bool_0    , field_kind::boolean          }
+    };
+
+    // constants are drawn from small domains, so that the records often satisfy the relations
+    constexpr std::array< std::string_view, 8 > integers        { "-2", "-1", "0", "1", "2", "3", "10", "2147483647" };
+    constexpr std::array< std::string_view, 5 > unsigned_values { "0", "1", "2", "3", "4294967295" };
+    constexpr std::array< std::string_view, 8 > floating_points { "-1.5", "0", "0.1", "0.100000001", "0.5", "1", "2.25", "1e3" };
+    constexpr std::array< std::string_view, 5 > strings         { "a", "b", "foo", "bar", "foo bar" };
+    constexpr std::array< std::string_view, 4 > booleans        { "0", "1", "true", "false" };
+
+    // values of the wrong type or out of range, which fail the conversion of the constant
+    constexpr std::array< std::string_view, 5 > malformed       { "1.5", "-1", "foo", "99999999999", "0x10" };
+
+    constexpr std::array< std::string_view, 6 > logical         { "and", "AND", "&&", "or", "OR", "||" };
+    constexpr std::array< std::string_view, 13 > relational
+    {
+        "", "==", "eq", "!=", "neq", ">", "gt", "<", "lt", ">=", "geq", "<=", "leq"
+    };
+
+    /**
+     * Renders the expression tree back into the expression, replacing each constant
+     * by the parameter placeholder and collecting the constants as parameter values.
+     * Fails on the field names that would not be parsed back the same way.
+     */
+    inline bool parameterize( tree::node const & node, std::string & expression, std::vector< parameter > & values )
+    {
+        if ( node.left == nullptr || node.right == nullptr ) { return false; }
+
+        if ( node.token.is_one_of( token::token_type::logical_and, token::token_type::logical_or ) )
+        {
+            expression += "(";
+            if ( !parameterize( *node.left, expression, values ) ) { return false; }
+            expression += node.token.is( token::token_type::logical_and ) ? ") and (" : ") or (";
+            if ( !parameterize( *node.right, expression, values ) ) { return false; }
+            expression += ")";
+            return true;
+        }
+
+        auto const is_relational
+        {
+            node.token.is_one_of
+            (
+                token::token_type::eq, token::token_type::neq,
+                token::token_type::gt, token::token_type::lt ,
+                token::token_type::geq, token::token_type::leq
+            )
+        };
+        if ( !is_relational ) { return false; }
+
+        auto const name{ node.left->token.value() };
+        auto const is_plain
+        {
+            std::all_of
+            (
+                std::cbegin( name ),
+                std::cend  ( name ),
+                []( char const c ) noexcept { return std::isalnum( static_cast< unsigned char >( c ) ) || c == '_'; }
+            )
+        };
+        if ( name.empty() || !is_plain ) { return false; }
+
+        values.emplace_back( node.right->token.value() );
+        expression += std::string{ name } + " " + std::string{ token::to_token_keyword( node.token.type() ) } +
+                      " $" + std::to_string( std::size( values ) );
+        return true;
+    }
+
+} // namespace internal
+
+using record_schema = schema
+<
+    record,
+    static_field< internal::int_0     , &record::int_0      >,
+    static_field< internal::int_1     , &record::int_1      >,
+    static_field< internal::unsigned_0, &record::unsigned_0 >,
+    static_field< internal::double_0  , &record::double_0   >,
+    static_field< internal::float_0   , &record::float_0    >,
+    static_field< internal::string_0  , &record::string_0   >,
+    static_field< internal::string_1  , &record::string_1   >,
+    static_field< internal::bool_0    , &record::bool_0     >
+>;
+
+/**
+ * Gets the human readable description of the record.
+ *
+ * @param r Record
+ *
+ * @return Record description
+ */
+[[ nodiscard ]] inline std::string describe( record const & r )
+{
+    return "{ int_0: "      + std::to_string( r.int_0      ) +
+           ", int_1: "      + std::to_string( r.int_1      ) +
+           ", unsigned_0: " + std::to_string( r.unsigned_0 ) +
+           ", double_0: "   + std::to_string( r.double_0   ) +
+           ", float_0: "    + std::to_string( r.float_0    ) +
+           ", string_0: \"" + r.string_0 + "\""              +
+           ", string_1: \"" + r.string_1 + "\""              +
+           ", bool_0: "     + ( r.bool_0 ? "true" : "false" ) + " }";
+}
+
+/**
+ * @class generator
+ *
+ * Generates random expressions over the fields of the record and random records.
+ * Expressions use every spelling of the operators, optional parentheses and
+ * the implicit equality. A fraction of them are mutated into malformed ones,
+ * e.g. by dropping a token or referring to an unknown field, so that the
+ * engines are also checked to reject the same expressions.
+ */
+class generator
+{
+public:
+    /**
+     * Creates the generator.
+     *
+     * @param seed              Seed of the random number engine
+     * @param max_depth         Maximum nesting depth of the logical operations
+     * @param malformed_percent Percentage of expressions mutated into malformed ones
+     */
+    explicit generator
+    (
+        std::uint64_t const seed,
+        std::size_t   const max_depth         = 6,
+        unsigned      const malformed_percent = 10
+    )
+        : engine_           { seed              }
+        , max_depth_        { max_depth         }
+        , malformed_percent_{ malformed_percent }
+    {}
+
+    /**
+     * Generates the random expression.
+     *
+     * @return Expression
+     */
+    [[ nodiscard ]] std::string expression()
+    {
+        std::vector< std::string > tokens;
+        logical( tokens, uniform( max_depth_ + 1 ) );
+
+        if ( uniform( 100 ) < malformed_percent_ )
+        {
+            mutate( tokens );
+        }
+
+        std::string result;
+        for ( auto const & token : tokens )
+        {
+            // parentheses are delimiters, so they are sometimes stuck to the neighbouring tokens
+            auto const is_stuck{ ( token == ")" || ( !result.empty() && result.back() == '(' ) ) && chance( 50 ) };
+            if ( !result.empty() && !is_stuck ) { result += ' '; }
+            result += token;
+        }
+        return result;
+    }
+
+    /**
+     * Generates the random record, with field values drawn from the same
+     * domains as the constants.
+     *
+     * @return Record
+     */
+    [[ nodiscard ]] record make_record()
+    {
+        record r;
+        r.int_0      = std::stoi ( std::string{ pick( internal::integers        ) } );
+        r.int_1      = std::stoi ( std::string{ pick( internal::integers        ) } );
+        r.unsigned_0 = static_cast< unsigned >( std::stoul( std::string{ pick( internal::unsigned_values ) } ) );
+        r.double_0   = std::stod ( std::string{ pick( internal::floating_points ) } );
+        r.float_0    = std::stof ( std::string{ pick( internal::floating_points ) } );
+        r.string_0   = pick( internal::strings );
+        r.string_1   = pick( internal::strings );
+        r.bool_0     = chance( 50 );
+        return r;
+    }
+
+private:
+    [[ nodiscard ]] std::size_t uniform( std::size_t const count )
+    {
+        return std::uniform_int_distribution< std::size_t >{ 0, count - 1 }( engine_ );
+    }
+
+    [[ nodiscard ]] bool chance( unsigned const percent )
+    {
+        return uniform( 100 ) < percent;
+    }
+
+    template< typename C >
+    [[ nodiscard ]] typename C::value_type pick( C const & values )
+    {
+        return values[ uniform( std::size( values ) ) ];
+    }
+
+    void logical( std::vector< std::string > & tokens, std::size_t const depth )
+    {
+        if ( depth == 0 || chance( 25 ) )
+        {
+            relation( tokens );
+            return;
+        }
+
+        operand( tokens, depth - 1 );
+        tokens.emplace_back( pick( internal::logical ) );
+        operand( tokens, depth - 1 );
+    }
+
+    void operand( std::vector< std::string > & tokens, std::size_t const depth )
+    {
+        if ( chance( 50 ) )
+        {
+            tokens.emplace_back( "(" );
+            logical( tokens, depth );
+            tokens.emplace_back( ")" );
+        }
+        else
+        {
+            logical( tokens, depth );
+        }
+    }
+
+    void relation( std::vector< std::string > & tokens )
+    {
+        auto const field{ pick( internal::fields ) };
+        tokens.emplace_back( field.name );
+
+        auto const operation{ pick( internal::relational ) };
+        if ( !operation.empty() ) { tokens.emplace_back( operation ); }
+
+        auto const constant{ chance( 10 ) ? pick( internal::malformed ) : constant_of( field.kind ) };
+        if ( constant.find( ' ' ) != std::string_view::npos )
+        {
+            tokens.emplace_back( "\"" + std::string{ constant } + "\"" );
+        }
+        else
+        {
+            tokens.emplace_back( constant );
+        }
+    }
+
+    [[ nodiscard ]] std::string_view constant_of( field_kind const kind )
+    {
+        switch ( kind )
+        {
+            case field_kind::integer         : return pick( internal::integers        );
+            case field_kind::unsigned_integer: return pick( internal::unsigned_values );
+            case field_kind::floating_point  : return pick( internal::floating_points );
+            case field_kind::string          : return pick( internal::strings         );
+            case field_kind::boolean         : return pick( internal::booleans        );
+        }
+        return {};
+    }
+
+    void mutate( std::vector< std::string > & tokens )
+    {
+        auto const position{ uniform( std::size( tokens ) ) };
+        switch ( uniform( 4 ) )
+        {
+            case 0 : tokens.erase( std::next( std::begin( tokens ), static_cast< std::ptrdiff_t >( position ) ) ); break;
+            case 1 : tokens.insert( std::next( std::begin( tokens ), static_cast< std::ptrdiff_t >( position ) ), chance( 50 ) ? "(" : ")" ); break;
+            case 2 : tokens.insert( std::next( std::begin( tokens ), static_cast< std::ptrdiff_t >( position ) ), std::string{ pick( internal::logical ) } ); break;
+            default:
+                for ( auto & token : tokens )
+                {
+                    if ( token == internal::int_0 ) { token = "unknown"; break; }
+                }
+                break;
+        }
+    }
+
+private:
+    std::mt19937_64 engine_;
+    std::size_t     max_depth_;
+    unsigned        malformed_percent_;
+};
+
+/**
+ * struct report
+ *
+ * Represents the outcome of checking the expression, i.e. the mismatches found
+ * between the engines and the time spent on parsing and evaluation.
+ */
+struct report
+{
+    std::vector< std::string > mismatches;
+
+    bool          is_valid        { false };
+    std::size_t   node_count      { 0     };
+    std::uint64_t parse_nanoseconds   { 0 };
+    std::uint64_t evaluate_nanoseconds{ 0 };
+};
+
+/**
+ * @class checker
+ *
+ * Evaluates the expression with every engine and compares the results with
+ * the reference one, i.e. the result visitor of the expression tree.
+ */
+class checker
+{
+public:
+    checker()
+    {
+        result_visitor_.fields
+        ({
+            make_field( internal::int_0     , &record::int_0      ),
+            make_field( internal::int_1     , &record::int_1      ),
+            make_field( internal::unsigned_0, &record::unsigned_0 ),
+            make_field( internal::double_0  , &record::double_0   ),
+            make_field( internal::float_0   , &record::float_0    ),
+            make_field( internal::string_0  , &record::string_0   ),
+            make_field( internal::string_1  , &record::string_1   ),
+            make_field( internal::bool_0    , &record::bool_0     )
+        });
+
+        evaluator_.fields
+        ({
+            make_field( internal::int_0     , &record::int_0      ),
+            make_field( internal::int_1     , &record::int_1      ),
+            make_field( internal::unsigned_0, &record::unsigned_0 ),
+            make_field( internal::double_0  , &record::double_0   ),
+            make_field( internal::float_0   , &record::float_0    ),
+            make_field( internal::string_0  , &record::string_0   ),
+            make_field( internal::string_1  , &record::string_1   ),
+            make_field( internal::bool_0    , &record::bool_0     )
+        });
+    }
+
+    /**
+     * Checks whether all the engines agree on the expression and the records.
+     *
+     * @param expression Expression to check
+     * @param records    Records the expression is evaluated against
+     *
+     * @return Report of the check
+     */
+    [[ nodiscard ]] report check( std::string_view const expression, std::vector< record > const & records )
+    {
+        report r;
+
+        using clock = std::chrono::steady_clock;
+
+        auto const parse_start{ clock::now() };
+        auto const root{ tree::build( expression ) };
+        auto compiled{ compile( expression ) };
+        r.parse_nanoseconds = elapsed( parse_start );
+
+        r.is_valid   = root != nullptr;
+        r.node_count = compiled.size();
+
+        auto const accepted
+        {
+            [ &r, expression ]( std::string_view const engine, bool const is_accepted, bool const is_expected )
+            {
+                if ( is_accepted != is_expected )
+                {
+                    r.mismatches.push_back
+                    (
+                        std::string{ engine } + ( is_expected ? " rejects" : " accepts" ) + " \"" + std::string{ expression } + "\""
+                    );
+                }
+            }
+        };
+
+        accepted( "compile"                   , !compiled.empty()                                      , r.is_valid );
+        accepted( "evaluator"                 , evaluator_.expression( expression )        && evaluator_.is_activated()       , r.is_valid );
+        accepted( "schema_evaluator"          , schema_evaluator_.expression( expression ) && schema_evaluator_.is_activated(), r.is_valid );
+
+        if ( !r.is_valid || !r.mismatches.empty() ) { return r; }
+
+        compare( r, "evaluator validation"       , expression, nullptr, result_visitor_.validate( *root ), evaluator_.validation()        );
+        compare( r, "schema_evaluator validation", expression, nullptr, result_visitor_.validate( *root ), schema_evaluator_.validation() );
+
+        // the image is loaded into a copy, as well as used in place
+        auto loaded{ compiled_expression::load( compiled.image_data(), compiled.image_size() ) };
+        auto viewed{ compiled_expression::view( compiled.image_data(), compiled.image_size() ) };
+        accepted( "compiled_expression::load", loaded.has_value(), true );
+        accepted( "compiled_expression::view", viewed.has_value(), true );
+
+        // the canonical form has to be a fixed point, and evaluate the same way
+        auto const canonical{ tree::canonicalize( tree::build( expression ) ) };
+        auto const twice    { tree::canonicalize( tree::canonicalize( tree::build( expression ) ) ) };
+        accepted( "tree::canonicalize", tree::hash( *twice ) == tree::hash( *canonical ), true );
+
+        rule_set rules;
+        rules.add( compiled );
+        auto const snapshot{ rules.snapshot() };
+        auto       snapshot_rules{ rule_set::view( std::data( snapshot ), std::size( snapshot ) ) };
+        accepted( "rule_set::view", snapshot_rules.has_value() && snapshot_rules->size() == 1, true );
+
+        if ( !r.mismatches.empty() ) { return r; }
+
+        schema_evaluator< record_schema > viewed_evaluator;
+        accepted( "schema_evaluator (view)", viewed_evaluator.expression( std::move( *viewed ) ), true );
+
+        schema_evaluator< record_schema > loaded_schema_evaluator;
+        accepted( "schema_evaluator (load)", loaded_schema_evaluator.expression( std::move( *loaded ) ), true );
+
+        snapshot_rules->bind( result_visitor_ );
+
+        auto profiled{ compiled };
+        schema_visitor_.bind( profiled );
+        tree::flat_profile profile{ profiled };
+
+        // the constants passed as parameters have to be compared the same way
+        std::string              parameterized;
+        std::vector< parameter > values;
+        schema_evaluator< record_schema > parameterized_evaluator;
+        auto const is_parameterized
+        {
+            internal::parameterize( *root, parameterized, values ) &&
+            parameterized_evaluator.expression( parameterized )
+        };
+
+        // objects selected block by block have to be the ones matched one by one
+        auto const selected_by_evaluator       { selection( evaluator_       , records ) };
+        auto const selected_by_schema_evaluator{ selection( schema_evaluator_, records ) };
+
+        for ( auto const & obj : records )
+        {
+            auto const expected{ result_visitor_.visit( *root, obj ) };
+            auto const position{ static_cast< std::size_t >( &obj - std::data( records ) ) };
+
+            auto const evaluate_start{ clock::now() };
+            auto const matched{ evaluator_.matches( obj ) };
+            r.evaluate_nanoseconds += elapsed( evaluate_start );
+
+            auto const accessor
+            {
+                [ &obj ]( std::uint32_t const slot, auto && f ) noexcept
+                {
+                    return record_schema::visit( slot, obj, f );
+                }
+            };
+
+            compare( r, "tree::result_visitor::matches"    , expression, &obj, expected, result_visitor_.matches( *root, obj )            );
+            compare( r, "evaluator::evaluate"              , expression, &obj, expected, evaluator_.evaluate( obj )                       );
+            compare( r, "evaluator::matches"               , expression, &obj, expected, matched                                          );
+            compare( r, "schema_evaluator::evaluate"       , expression, &obj, expected, schema_evaluator_.evaluate( obj )                );
+            compare( r, "schema_evaluator::matches"        , expression, &obj, expected, schema_evaluator_.matches( obj )                 );
+            compare( r, "schema_evaluator::matches (load)" , expression, &obj, expected, loaded_schema_evaluator.matches( obj )           );
+            compare( r, "schema_evaluator::evaluate (view)", expression, &obj, expected, viewed_evaluator.evaluate( obj )                 );
+            compare( r, "tree::flat_profile::matches"      , expression, &obj, expected, profile.matches( profiled, 0, accessor )         );
+            compare( r, "rule_set::view"                   , expression, &obj, expected, result_visitor_.matches( ( *snapshot_rules )[ 0 ], obj ) );
+            compare( r, "tree::canonicalize"               , expression, &obj, expected, result_visitor_.matches( *canonical, obj )    );
+            compare( r, "evaluator::select"                , expression, &obj, expected, selected_by_evaluator       [ position ]      );
+            compare( r, "schema_evaluator::select"         , expression, &obj, expected, selected_by_schema_evaluator[ position ]      );
+
+            if ( is_parameterized )
+            {
+                compare( r, "schema_evaluator::evaluate (parameters)", expression, &obj, expected, parameterized_evaluator.evaluate( obj, values ) );
+                compare( r, "schema_evaluator::matches (parameters)" , expression, &obj, expected, parameterized_evaluator.matches ( obj, values ) );
+            }
+        }
+
+        return r;
+    }
+
+private:
+    [[ nodiscard ]] static std::uint64_t elapsed( std::chrono::steady_clock::time_point const start ) noexcept
+    {
+        return static_cast< std::uint64_t >
+        (
+            std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - start ).count()
+        );
+    }
+
+    template< typename E >
+    [[ nodiscard ]] static std::vector< bool > selection( E const & engine, std::vector< record > const & records )
+    {
+        std::vector< std::size_t > positions( std::size( records ) );
+        std::vector< bool >        selected ( std::size( records ) );
+
+        auto const end{ engine.select( std::cbegin( records ), std::cend( records ), std::begin( positions ) ) };
+        for ( auto it{ std::begin( positions ) }; it != end; ++it )
+        {
+            selected[ *it ] = true;
+        }
+
+        return selected;
+    }
+
+    static void compare
+    (
+        report                 & r,
+        std::string_view const   engine,
+        std::string_view const   expression,
+        record           const * obj,
+        result           const & expected,
+        result           const & actual
+    )
+    {
+        if ( expected.success != actual.success || expected.message != actual.message )
+        {
+            mismatch( r, engine, expression, obj, describe( expected ), describe( actual ) );
+        }
+    }
+
+    static void compare
+    (
+        report                 & r,
+        std::string_view const   engine,
+        std::string_view const   expression,
+        record           const * obj,
+        result           const & expected,
+        bool             const   actual
+    )
+    {
+        if ( expected.success != actual )
+        {
+            mismatch( r, engine, expression, obj, expected.success ? "true" : "false", actual ? "true" : "false" );
+        }
+    }
+
+    static void mismatch
+    (
+        report                 & r,
+        std::string_view const   engine,
+        std::string_view const   expression,
+        record           const * obj,
+        std::string      const & expected,
+        std::string      const & actual
+    )
+    {
+        r.mismatches.push_back
+        (
+            std::string{ engine } + ": expected " + expected + ", got " + actual +
+            " for \"" + std::string{ expression } + "\"" +
+            ( obj == nullptr ? std::string{} : " and " + differential::describe( *obj ) )
+        );
+    }
+
+    [[ nodiscard ]] static std::string describe( result const & r )
+    {
+        return std::string{ r.success ? "true" : "false" } + ( r.message.empty() ? "" : " (" + std::string{ r.message } + ")" );
+    }
+
+private:
+    tree::result_visitor                  result_visitor_;
+    tree::schema_visitor< record_schema > schema_visitor_;
+    evaluator                             evaluator_;
+    schema_evaluator< record_schema >     schema_evaluator_;
+};
+
+} // namespace booleval::differential
+
+#endif // BOOLEVAL_DIFFERENTIAL_HPP
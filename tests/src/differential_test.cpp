@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <gtest/gtest.h>
+
+#include "differential.hpp"
+
+namespace
+{
+
+    using booleval::differential::checker;
+    using booleval::differential::generator;
+    using booleval::differential::record;
+
+    std::uint64_t environment( char const * name, std::uint64_t const fallback )
+    {
+        auto const * value{ std::getenv( name ) };
+        return value == nullptr ? fallback : std::strtoull( value, nullptr, 10 );
+    }
+
+    // the best of several runs, so that a preempted run is not taken for a performance cliff
+    template< typename F >
+    std::uint64_t best_of( std::size_t const runs, F && f )
+    {
+        auto best{ std::numeric_limits< std::uint64_t >::max() };
+        for ( std::size_t i{ 0 }; i < runs; ++i )
+        {
+            auto const start{ std::chrono::steady_clock::now() };
+            f();
+            auto const elapsed{ std::chrono::steady_clock::now() - start };
+            best = std::min( best, static_cast< std::uint64_t >( std::chrono::duration_cast< std::chrono::nanoseconds >( elapsed ).count() ) );
+        }
+        return best;
+    }
+
+    std::uint64_t parse_time( std::string const & expression )
+    {
+        return best_of( 5, [ &expression ]{ static_cast< void >( booleval::compile( expression ) ); } );
+    }
+
+    std::string nested( std::size_t const depth )
+    {
+        return std::string( depth, '(' ) + "int_0 == 1" + std::string( depth, ')' );
+    }
+
+    std::string chained( std::size_t const width )
+    {
+        std::string expression{ "int_0 == 0" };
+        for ( std::size_t i{ 1 }; i < width; ++i )
+        {
+            expression += " or int_0 == " + std::to_string( i );
+        }
+        return expression;
+    }
+
+    std::string balanced( std::size_t const width )
+    {
+        if ( width == 1 ) { return "string_0 == foo"; }
+        return "(" + balanced( width / 2 ) + ") and (" + balanced( width - width / 2 ) + ")";
+    }
+
+    std::string quoted( std::size_t const width )
+    {
+        std::string expression{ "string_0 == \"foo bar\"" };
+        for ( std::size_t i{ 1 }; i < width; ++i )
+        {
+            expression += " or string_0 == \"foo bar\"";
+        }
+        return expression;
+    }
+
+} // namespace
+
+TEST( DifferentialTest, RandomExpressions )
+{
+    // the seed and the number of expressions can be changed for a longer run, e.g.
+    // BOOLEVAL_DIFFERENTIAL_SEED=$RANDOM BOOLEVAL_DIFFERENTIAL_ITERATIONS=100000
+    auto const seed      { environment( "BOOLEVAL_DIFFERENTIAL_SEED"      , 2021 ) };
+    auto const iterations{ environment( "BOOLEVAL_DIFFERENTIAL_ITERATIONS", 2000 ) };
+
+    generator generator{ seed };
+    checker   checker;
+
+    std::vector< record > records;
+    for ( std::size_t i{ 0 }; i < 32; ++i )
+    {
+        records.push_back( generator.make_record() );
+    }
+
+    struct sample
+    {
+        std::string expression;
+        double      nanoseconds_per_byte;
+    };
+
+    std::vector< sample > samples;
+    std::size_t           valid     { 0 };
+    std::size_t           mismatches{ 0 };
+
+    for ( std::uint64_t i{ 0 }; i < iterations; ++i )
+    {
+        auto const expression{ generator.expression() };
+        auto const report    { checker.check( expression, records ) };
+
+        for ( auto const & mismatch : report.mismatches )
+        {
+            // only the first few are reported, there are usually many more caused by the same bug
+            if ( ++mismatches <= 10 ) { ADD_FAILURE() << mismatch << " (seed " << seed << ")"; }
+        }
+
+        if ( report.is_valid )
+        {
+            ++valid;
+            samples.push_back( { expression, static_cast< double >( report.parse_nanoseconds ) / static_cast< double >( std::size( expression ) ) } );
+        }
+    }
+
+    EXPECT_EQ( mismatches, 0U );
+
+    // both the valid and the malformed expressions have to be generated
+    EXPECT_GT( valid, iterations / 2 );
+    EXPECT_LT( valid, iterations     );
+
+    // the expressions taking much longer to parse per byte than the median one
+    // hint at a performance cliff, e.g. backtracking in the parser
+    if ( std::size( samples ) < 2 ) { return; }
+
+    auto sorted{ samples };
+    auto const middle{ std::next( std::begin( sorted ), static_cast< std::ptrdiff_t >( std::size( sorted ) / 2 ) ) };
+    std::nth_element
+    (
+        std::begin( sorted ),
+        middle,
+        std::end( sorted ),
+        []( auto const & lhs, auto const & rhs ) { return lhs.nanoseconds_per_byte < rhs.nanoseconds_per_byte; }
+    );
+    auto const median{ middle->nanoseconds_per_byte };
+
+    constexpr double outlier_factor{ 50.0 };
+
+    for ( auto const & s : samples )
+    {
+        if ( s.nanoseconds_per_byte < median * outlier_factor ) { continue; }
+
+        // measured again, so that the outlier caused by preemption is not reported
+        auto const nanoseconds_per_byte
+        {
+            static_cast< double >( parse_time( s.expression ) ) / static_cast< double >( std::size( s.expression ) )
+        };
+
+        EXPECT_LT( nanoseconds_per_byte, median * outlier_factor )
+            << "parsing \"" << s.expression << "\" takes " << nanoseconds_per_byte
+            << " ns per byte, median is " << median << " ns per byte";
+    }
+}
+
+TEST( DifferentialTest, ParseTimeScaling )
+{
+    struct shape
+    {
+        char const *                              name;
+        std::function< std::string( std::size_t ) > make;
+    };
+
+    std::vector< shape > const shapes
+    {
+        { "nested"  , nested   },
+        { "chained" , chained  },
+        { "balanced", balanced },
+        { "quoted"  , quoted   }
+    };
+
+    // growing the expression 8 times makes the linear parser 8 times slower, while
+    // the quadratic one is 64 times slower, so the bound leaves enough room for noise
+    constexpr std::size_t size  { 64 };
+    constexpr std::size_t growth{ 8  };
+    constexpr double      bound { 32 };
+
+    for ( auto const & s : shapes )
+    {
+        auto const small{ s.make( size          ) };
+        auto const large{ s.make( size * growth ) };
+
+        ASSERT_FALSE( booleval::compile( small ).empty() ) << s.name;
+        ASSERT_FALSE( booleval::compile( large ).empty() ) << s.name;
+
+        auto const ratio
+        {
+            static_cast< double >( parse_time( large ) ) / static_cast< double >( std::max< std::uint64_t >( parse_time( small ), 1 ) )
+        };
+
+        EXPECT_LT( ratio, bound ) << "parsing " << s.name << " expression " << growth << " times larger is " << ratio << " times slower";
+    }
+}
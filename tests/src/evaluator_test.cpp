@@ -27,9 +27,17 @@
  *
  */
 
+#include <string>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <booleval/evaluator.hpp>
 
+#include "allocation_counter.hpp"
+
 namespace
 {
 
@@ -68,6 +76,31 @@ namespace
         U value_2_{};
     };
 
+    class baz
+    {
+    public:
+        baz( std::string value_1, unsigned value_2 )
+        : value_1_{ std::move( value_1 ) }
+        , value_2_{ value_2 }
+        {}
+
+        std::string const & value_1() const noexcept { return value_1_; }
+        unsigned            value_2() const noexcept { return value_2_; }
+
+    private:
+        std::string value_1_{};
+        unsigned    value_2_{};
+    };
+
+    class qux
+    {
+    public:
+        unsigned value() const noexcept { ++calls; return value_; }
+
+        unsigned         value_{ 0 };
+        mutable unsigned calls { 0 };
+    };
+
 } // namespace
 
 TEST( EvaluatorTest, DefaultConstructor )
@@ -512,3 +545,478 @@ TEST( EvaluatorTest, UnknownField )
         ASSERT_EQ   ( result.message, "Unknown field" );
     }
 }
+
+TEST( EvaluatorTest, DataMembersAndAccessors )
+{
+    struct baz
+    {
+        unsigned    value_1{};
+        std::string value_2{};
+    };
+
+    baz x{ 1, "foo" };
+    baz y{ 2, "bar" };
+
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "field_1", &baz::value_1 ),
+            booleval::make_field( "field_2", []( baz const & obj ) noexcept { return obj.value_2; } )
+        }
+    };
+
+    {
+        ASSERT_TRUE ( evaluator.expression( "field_1 1 and field_2 foo" ) );
+        ASSERT_TRUE ( evaluator.is_activated()                            );
+        ASSERT_TRUE ( evaluator.evaluate( x ).success                     );
+        ASSERT_FALSE( evaluator.evaluate( y ).success                     );
+    }
+    {
+        ASSERT_TRUE ( evaluator.expression( "field_1 > 1 or field_2 == baz" ) );
+        ASSERT_TRUE ( evaluator.is_activated()                                );
+        ASSERT_FALSE( evaluator.evaluate( x ).success                         );
+        ASSERT_TRUE ( evaluator.evaluate( y ).success                         );
+    }
+}
+
+TEST( EvaluatorTest, Matches )
+{
+    bar< std::string, unsigned > x{ "foo", 1 };
+    bar< std::string, unsigned > y{ "bar", 2 };
+    bar< std::string, unsigned > m{ "baz", 1 };
+    bar< std::string, unsigned > n{ "qux", 2 };
+
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "field_1", &bar< std::string, unsigned >::value_1 ),
+            booleval::make_field( "field_2", &bar< std::string, unsigned >::value_2 )
+        }
+    };
+
+    ASSERT_FALSE( evaluator.matches( x ) );
+
+    for
+    (
+        auto const * expression :
+        {
+            "(field_1 foo and field_2 1) or (field_1 qux and field_2 2)",
+            "(field_1 foo or field_1 bar) and (field_2 2 or field_2 1)",
+            "field_1 > bar and field_2 <= 1",
+            "field_1 foo or unknown_field 2"
+        }
+    )
+    {
+        ASSERT_TRUE( evaluator.expression( expression ) );
+
+        for ( auto const & obj : { x, y, m, n } )
+        {
+            ASSERT_EQ( evaluator.matches( obj ), evaluator.evaluate( obj ).success ) << expression;
+        }
+    }
+}
+
+TEST( EvaluatorTest, Validation )
+{
+    booleval::evaluator evaluator;
+
+    ASSERT_FALSE( evaluator.validation().success                              );
+    ASSERT_EQ   ( evaluator.validation().message, "Evaluator not activated" );
+
+    ASSERT_TRUE ( evaluator.expression( "field_1 foo and field_2 1" )      );
+    ASSERT_FALSE( evaluator.validation().success                           );
+    ASSERT_EQ   ( evaluator.validation().message, "Unknown field"          );
+
+    evaluator.fields
+    (
+        {
+            booleval::make_field( "field_1", &bar< std::string, unsigned >::value_1 ),
+            booleval::make_field( "field_2", &bar< std::string, unsigned >::value_2 )
+        }
+    );
+
+    ASSERT_TRUE( evaluator.validation().success );
+}
+
+TEST( EvaluatorTest, ExpressionOutlivesSource )
+{
+    foo< unsigned > x{ 1 };
+
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "field", &foo< unsigned >::value ) }
+    };
+
+    {
+        std::string source{ "field == 1 or field == 2" };
+        ASSERT_TRUE( evaluator.expression( source ) );
+        source.assign( std::size( source ), ' ' );
+    }
+
+    ASSERT_TRUE( evaluator.evaluate( x ).success );
+    ASSERT_TRUE( evaluator.matches ( x )         );
+}
+
+TEST( EvaluatorTest, CompiledExpression )
+{
+    foo< unsigned > x{ 1 };
+
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "field", &foo< unsigned >::value ) }
+    };
+
+    auto const image{ booleval::compile( "field == 1 or field == 2" ) };
+    auto       loaded{ booleval::compiled_expression::view( image.image_data(), image.image_size() ) };
+
+    ASSERT_TRUE ( loaded.has_value() );
+    ASSERT_TRUE ( evaluator.expression( std::move( loaded.value() ) ) );
+    ASSERT_TRUE ( evaluator.validation().success  );
+    ASSERT_TRUE ( evaluator.evaluate( x ).success );
+
+    ASSERT_FALSE( evaluator.expression( booleval::compiled_expression{} ) );
+    ASSERT_FALSE( evaluator.is_activated() );
+}
+
+TEST( EvaluatorTest, Parameters )
+{
+    bar< std::string, unsigned > x{ "foo", 1 };
+
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "field_1", &bar< std::string, unsigned >::value_1 ),
+            booleval::make_field( "field_2", &bar< std::string, unsigned >::value_2 )
+        }
+    };
+
+    ASSERT_TRUE ( evaluator.expression( "field_1 == $1 and field_2 > $2" ) );
+    ASSERT_TRUE ( evaluator.validation().success );
+
+    auto const unbound{ evaluator.evaluate( x ) };
+    ASSERT_FALSE( unbound.success );
+    ASSERT_EQ   ( unbound.message, "Unbound parameter" );
+    ASSERT_FALSE( evaluator.matches( x ) );
+
+    evaluator.parameters( { "foo", "0" } );
+    ASSERT_TRUE( evaluator.evaluate( x ).success );
+    ASSERT_TRUE( evaluator.matches ( x )         );
+
+    evaluator.parameters( { "foo", "1" } );
+    ASSERT_FALSE( evaluator.evaluate( x ).success );
+    ASSERT_FALSE( evaluator.matches ( x )         );
+
+    evaluator.parameters( { "bar", "0" } );
+    ASSERT_FALSE( evaluator.matches( x ) );
+}
+
+TEST( EvaluatorTest, DollarValues )
+{
+    bar< std::string, unsigned > x{ "$5", 1 };
+
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "price", &bar< std::string, unsigned >::value_1 ) }
+    };
+
+    // quoted, the value is compared as written
+    ASSERT_TRUE( evaluator.expression( "price == \"$5\"" ) );
+    ASSERT_TRUE( evaluator.evaluate( x ).success );
+    ASSERT_TRUE( evaluator.matches ( x )         );
+
+    // unquoted, it is the placeholder of the fifth parameter
+    ASSERT_TRUE( evaluator.expression( "price == $5" ) );
+
+    auto const unbound{ evaluator.evaluate( x ) };
+    ASSERT_FALSE( unbound.success );
+    ASSERT_EQ   ( unbound.message, "Unbound parameter" );
+    ASSERT_FALSE( evaluator.matches( x ) );
+
+    evaluator.parameters( { "", "", "", "", "$5" } );
+    ASSERT_TRUE( evaluator.matches( x ) );
+}
+
+TEST( EvaluatorTest, ParameterFrames )
+{
+    bar< std::string, unsigned > const x{ "foo", 1 };
+
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "field_1", &bar< std::string, unsigned >::value_1 ),
+            booleval::make_field( "field_2", &bar< std::string, unsigned >::value_2 )
+        }
+    };
+
+    ASSERT_TRUE( evaluator.expression( "field_1 == $1 and field_2 > $2" ) );
+
+    ASSERT_TRUE ( evaluator.evaluate( x, { "foo", 0 } ).success );
+    ASSERT_FALSE( evaluator.evaluate( x, { "foo", 1 } ).success );
+    ASSERT_TRUE ( evaluator.matches ( x, { "foo", 0.5 } ) );
+    ASSERT_FALSE( evaluator.matches ( x, { "bar", 0 } ) );
+
+    auto const unbound{ evaluator.evaluate( x, { "foo" } ) };
+    ASSERT_FALSE( unbound.success );
+    ASSERT_EQ   ( unbound.message, "Unbound parameter" );
+
+    // the frame supplied takes precedence over the parameters bound
+    evaluator.parameters( { "bar", "5" } );
+    ASSERT_FALSE( evaluator.matches( x ) );
+    ASSERT_TRUE ( evaluator.matches( x, { "foo", 0 } ) );
+}
+
+TEST( EvaluatorTest, ConcurrentParameterFrames )
+{
+    std::vector< bar< std::string, unsigned > > objects;
+    for ( unsigned i{ 0 }; i < 100; ++i )
+    {
+        objects.emplace_back( i % 2 == 0 ? "even" : "odd", std::move( i ) );
+    }
+
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "field_1", &bar< std::string, unsigned >::value_1 ),
+            booleval::make_field( "field_2", &bar< std::string, unsigned >::value_2 )
+        }
+    };
+
+    ASSERT_TRUE( evaluator.expression( "field_1 == $1 and field_2 < $2" ) );
+
+    std::vector< std::size_t > counts( 8 );
+    std::vector< std::thread > threads;
+    for ( std::size_t t{ 0 }; t < std::size( counts ); ++t )
+    {
+        threads.emplace_back
+        (
+            [ &, t ]
+            {
+                booleval::parameter const frame[]{ t % 2 == 0 ? "even" : "odd", static_cast< unsigned >( t * 10 ) };
+                for ( int round{ 0 }; round < 100; ++round )
+                {
+                    counts[ t ] = static_cast< std::size_t >( std::count_if
+                    (
+                        std::cbegin( objects ),
+                        std::cend  ( objects ),
+                        [ & ]( auto const & obj ) { return evaluator.matches( obj, { frame, 2 } ); }
+                    ) );
+                }
+            }
+        );
+    }
+
+    for ( auto & thread : threads ) { thread.join(); }
+
+    for ( std::size_t t{ 0 }; t < std::size( counts ); ++t )
+    {
+        EXPECT_EQ( counts[ t ], t * 5 ) << t;
+    }
+}
+
+TEST( EvaluatorTest, FieldFetchedOncePerObject )
+{
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "x", &qux::value, { 10 } ) }
+    };
+
+    ASSERT_TRUE( evaluator.expression( "x > 5 and x < 10 or x == 42" ) );
+
+    for ( unsigned const value : { 7U, 42U, 1U } )
+    {
+        qux const obj{ value };
+
+        ASSERT_TRUE( evaluator.evaluate( obj ).success == ( value != 1U ) );
+        EXPECT_EQ  ( obj.calls, 1U ) << value;
+
+        ASSERT_TRUE( evaluator.matches( obj ) == ( value != 1U ) );
+        EXPECT_EQ  ( obj.calls, 2U ) << value;
+    }
+}
+
+TEST( EvaluatorTest, CheapFieldFetchedEveryTime )
+{
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "x", &qux::value ) }
+    };
+
+    ASSERT_TRUE( evaluator.expression( "x > 5 and x < 10" ) );
+
+    qux const obj{ 7 };
+    ASSERT_TRUE( evaluator.matches( obj ) );
+    EXPECT_EQ  ( obj.calls, 2U );
+}
+
+TEST( EvaluatorTest, CheapFieldsFirst )
+{
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "cheap"    , []( qux const & obj ) noexcept { return obj.value_ % 2; } ),
+            booleval::make_field( "expensive", &qux::value, { 100 } )
+        }
+    };
+
+    ASSERT_TRUE( evaluator.expression( "expensive > 5 and cheap == 1" ) );
+
+    qux const even{ 8 };
+    ASSERT_FALSE( evaluator.matches( even ) );
+    EXPECT_EQ   ( even.calls, 0U );
+
+    qux const odd{ 9 };
+    ASSERT_TRUE( evaluator.matches( odd ) );
+    EXPECT_EQ  ( odd.calls, 1U );
+
+    // the full evaluation still visits every node
+    ASSERT_FALSE( evaluator.evaluate( even ).success );
+    EXPECT_EQ   ( even.calls, 1U );
+}
+
+TEST( EvaluatorTest, UncacheableField )
+{
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "x", &qux::value, { 10, false } ) }
+    };
+
+    ASSERT_TRUE( evaluator.expression( "x > 5 and x < 10" ) );
+
+    qux const obj{ 7 };
+    ASSERT_TRUE( evaluator.matches( obj ) );
+    EXPECT_EQ  ( obj.calls, 2U );
+}
+
+TEST( EvaluatorTest, Select )
+{
+    std::vector< qux > objects;
+    for ( unsigned i{ 0 }; i < 100; ++i )
+    {
+        objects.push_back( { i, 0 } );
+    }
+
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "x", &qux::value ) }
+    };
+
+    std::vector< std::size_t > selected;
+    static_cast< void >( evaluator.select( std::cbegin( objects ), std::cend( objects ), std::back_inserter( selected ) ) );
+    ASSERT_TRUE( selected.empty() );
+
+    ASSERT_TRUE( evaluator.expression( "x < 20 and x >= 10 or x == 42" ) );
+
+    static_cast< void >( evaluator.select( std::cbegin( objects ), std::cend( objects ), std::back_inserter( selected ) ) );
+    ASSERT_EQ( selected, ( std::vector< std::size_t >{ 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 42 } ) );
+
+    // the second operand of and is checked on 20 objects, the second operand of or on 90 objects
+    unsigned calls{ 0 };
+    for ( auto const & obj : objects ) { calls += obj.calls; }
+    ASSERT_EQ( calls, 100U + 20U + 90U );
+
+    ASSERT_TRUE( evaluator.expression( "x < $1" ) );
+
+    selected.clear();
+    static_cast< void >( evaluator.select( std::cbegin( objects ), std::cend( objects ), std::back_inserter( selected ), { 3 } ) );
+    ASSERT_EQ( selected, ( std::vector< std::size_t >{ 0, 1, 2 } ) );
+}
+
+TEST( EvaluatorTest, SelectThrowingOutput )
+{
+    std::vector< qux > const objects( 10 );
+
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "x", &qux::value ) }
+    };
+    ASSERT_TRUE( evaluator.expression( "x == 0" ) );
+
+    // select throws only if writing to the output iterator does
+    std::size_t positions[ 10 ];
+    static_assert(  noexcept( evaluator.select( objects.cbegin(), objects.cend(), positions ) ) );
+    static_assert( !noexcept( evaluator.select( objects.cbegin(), objects.cend(), std::back_inserter( std::declval< std::vector< std::size_t > & >() ) ) ) );
+
+    struct full {};
+
+    // output iterator throwing once the vector is filled up to its capacity
+    struct bounded_output
+    {
+        bounded_output & operator*    (     ) noexcept { return *this; }
+        bounded_output & operator++   ( int ) noexcept { return *this; }
+        bounded_output & operator=    ( std::size_t const position )
+        {
+            if ( std::size( *selected ) == selected->capacity() ) { throw full{}; }
+            selected->push_back( position );
+            return *this;
+        }
+
+        std::vector< std::size_t > * selected;
+    };
+
+    std::vector< std::size_t > selected;
+    selected.reserve( 4 );
+
+    EXPECT_THROW( static_cast< void >( evaluator.select( std::cbegin( objects ), std::cend( objects ), bounded_output{ &selected } ) ), full );
+    EXPECT_EQ   ( selected, ( std::vector< std::size_t >{ 0, 1, 2, 3 } ) );
+}
+
+TEST( EvaluatorTest, Limits )
+{
+    foo< unsigned > x{ 1 };
+
+    booleval::evaluator evaluator
+    {
+        { booleval::make_field( "field", &foo< unsigned >::value ) }
+    };
+
+    booleval::limits limits;
+    limits.max_depth = 1;
+    evaluator.limits( limits );
+
+    ASSERT_TRUE ( evaluator.expression( "(field == 1) or (field == 2)" ) );
+    ASSERT_TRUE ( evaluator.matches( x ) );
+
+    ASSERT_FALSE( evaluator.expression( "((field == 1)) or (field == 2)" ) );
+    ASSERT_FALSE( evaluator.is_activated() );
+    ASSERT_FALSE( evaluator.matches( x ) );
+}
+
+TEST( EvaluatorTest, NoAllocationsOnEvaluation )
+{
+    // strings longer than the small string buffer, so that copying them would allocate
+    baz const x{ "a_string_longer_than_the_small_string_buffer", 1 };
+    baz const y{ "another_string_longer_than_the_small_string_buffer", 2 };
+
+    booleval::evaluator evaluator
+    {
+        {
+            booleval::make_field( "field_1", &baz::value_1 ),
+            booleval::make_field( "field_2", &baz::value_2 )
+        }
+    };
+
+    ASSERT_TRUE( evaluator.expression( "(field_1 a_string_longer_than_the_small_string_buffer and field_2 1) or field_2 > 1" ) );
+    ASSERT_TRUE( evaluator.validation().success );
+
+    booleval::evaluator parameter_evaluator
+    {
+        {
+            booleval::make_field( "field_1", &baz::value_1 ),
+            booleval::make_field( "field_2", &baz::value_2 )
+        }
+    };
+
+    ASSERT_TRUE( parameter_evaluator.expression( "field_1 == $1 and field_2 < $2" ) );
+
+    booleval::testing::allocation_scope const scope;
+
+    ASSERT_TRUE( evaluator.matches ( x )         );
+    ASSERT_TRUE( evaluator.evaluate( x ).success );
+    ASSERT_TRUE( evaluator.matches ( y )         );
+    ASSERT_TRUE( evaluator.evaluate( y ).success );
+
+    ASSERT_TRUE( parameter_evaluator.matches ( x, { "a_string_longer_than_the_small_string_buffer", 2 } )         );
+    ASSERT_TRUE( parameter_evaluator.evaluate( x, { "a_string_longer_than_the_small_string_buffer", 2 } ).success );
+
+    EXPECT_EQ( scope.stats().allocations, 0U );
+}
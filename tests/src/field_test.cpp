@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <type_traits>
+#include <gtest/gtest.h>
+#include <booleval/field.hpp>
+
+namespace
+{
+
+    struct foo
+    {
+        unsigned    value_1{};
+        std::string value_2{};
+
+        unsigned value_3() const noexcept { return value_1 * 2; }
+        unsigned value_5()       noexcept { return value_1 * 3; }
+    };
+
+    std::string const & value_4( foo const & obj ) noexcept
+    {
+        return obj.value_2;
+    }
+
+    struct bar
+    {
+        unsigned value{};
+    };
+
+    template< typename M, typename = void >
+    struct is_field_accessor : std::false_type {};
+
+    template< typename M >
+    struct is_field_accessor< M, std::void_t< decltype( booleval::make_field( "field", std::declval< M >() ) ) > > : std::true_type {};
+
+} // namespace
+
+TEST( FieldTest, Getter )
+{
+    std::unique_ptr< booleval::field_base > field{ booleval::make_field( "field", &foo::value_3 ) };
+
+    ASSERT_EQ( field->name, "field" );
+    ASSERT_EQ( field->invoke( foo{ 2, "foo" } ), "4" );
+}
+
+TEST( FieldTest, NonConstGetter )
+{
+    // the object is evaluated through a const reference, so only const getters are accepted
+    static_assert(  is_field_accessor< decltype( &foo::value_3 ) >::value );
+    static_assert( !is_field_accessor< decltype( &foo::value_5 ) >::value );
+    static_assert( !std::is_constructible_v< booleval::field< foo >, std::string_view, decltype( &foo::value_5 ) > );
+}
+
+TEST( FieldTest, DataMember )
+{
+    std::unique_ptr< booleval::field_base > field_1{ booleval::make_field( "field_1", &foo::value_1 ) };
+    std::unique_ptr< booleval::field_base > field_2{ booleval::make_field( "field_2", &foo::value_2 ) };
+
+    foo const x{ 2, "foo" };
+
+    ASSERT_EQ( field_1->invoke( x ), "2"   );
+    ASSERT_EQ( field_2->invoke( x ), "foo" );
+}
+
+TEST( FieldTest, FreeFunction )
+{
+    std::unique_ptr< booleval::field_base > field{ booleval::make_field( "field", &value_4 ) };
+
+    ASSERT_EQ( field->invoke( foo{ 2, "foo" } ), "foo" );
+}
+
+TEST( FieldTest, StatelessLambda )
+{
+    std::unique_ptr< booleval::field_base > field
+    {
+        booleval::make_field( "field", []( foo const & obj ) noexcept { return obj.value_1 + 1; } )
+    };
+
+    ASSERT_EQ( field->invoke( foo{ 2, "foo" } ), "3" );
+}
+
+TEST( FieldTest, StatelessLambdaByValue )
+{
+    std::unique_ptr< booleval::field_base > field_1
+    {
+        booleval::make_field( "field_1", []( bar x ) noexcept { return x.value + 1; } )
+    };
+    std::unique_ptr< booleval::field_base > field_2
+    {
+        booleval::make_field( "field_2", []( bar const x ) noexcept { return x.value + 2; } )
+    };
+
+    ASSERT_EQ( field_1->invoke( bar{ 2 } ), "3" );
+    ASSERT_EQ( field_2->invoke( bar{ 2 } ), "4" );
+    ASSERT_EQ( field_1->invoke( foo{ 2, "foo" } ), booleval::utils::any_value{} );
+}
+
+TEST( FieldTest, DefaultConstructed )
+{
+    booleval::field< foo > const field;
+
+    ASSERT_EQ( field.get( foo{ 2, "foo" } ), booleval::utils::any_value{} );
+}
+
+TEST( FieldTest, DifferentClass )
+{
+    std::unique_ptr< booleval::field_base > field{ booleval::make_field( "field", &foo::value_1 ) };
+
+    ASSERT_EQ( field->invoke( bar{ 2 } ), booleval::utils::any_value{} );
+}
+
+TEST( FieldTest, BorrowedString )
+{
+    std::unique_ptr< booleval::field_base > field_1{ booleval::make_field( "field_1", &foo::value_2 ) };
+    std::unique_ptr< booleval::field_base > field_2{ booleval::make_field( "field_2", &value_4      ) };
+
+    foo const x{ 2, "foo foo foo foo foo foo foo foo" };
+
+    auto const value_1{ field_1->invoke( x ) };
+    auto const value_2{ field_2->invoke( x ) };
+
+    ASSERT_TRUE( value_1.is_borrowed() );
+    ASSERT_TRUE( value_2.is_borrowed() );
+    ASSERT_EQ  ( std::data( value_1.value() ), std::data( x.value_2 ) );
+    ASSERT_EQ  ( std::data( value_2.value() ), std::data( x.value_2 ) );
+}
+
+TEST( FieldTest, Options )
+{
+    std::unique_ptr< booleval::field_base > plain    { booleval::make_field( "field_1", &foo::value_1 ) };
+    std::unique_ptr< booleval::field_base > getter   { booleval::make_field( "field_2", &foo::value_3, { 100, false } ) };
+    std::unique_ptr< booleval::field_base > function { booleval::make_field( "field_3", &value_4, { 10 } ) };
+    std::unique_ptr< booleval::field_base > lambda
+    {
+        booleval::make_field( "field_4", []( foo const & obj ) noexcept { return obj.value_1; }, { 1, false } )
+    };
+
+    ASSERT_EQ  ( plain->options.cost, 0U );
+    ASSERT_TRUE( plain->options.cacheable );
+
+    ASSERT_EQ   ( getter->options.cost, 100U );
+    ASSERT_FALSE( getter->options.cacheable );
+    ASSERT_EQ   ( getter->invoke( foo{ 2, "foo" } ), "4" );
+
+    ASSERT_EQ  ( function->options.cost, 10U );
+    ASSERT_TRUE( function->options.cacheable );
+
+    ASSERT_EQ   ( lambda->options.cost, 1U );
+    ASSERT_FALSE( lambda->options.cacheable );
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <functional>
+#include <string_view>
+#include <gtest/gtest.h>
+#include <booleval/parameter.hpp>
+
+TEST( ParameterTest, Unbound )
+{
+    booleval::parameter const parameter;
+
+    ASSERT_FALSE( parameter.is_bound() );
+    ASSERT_FALSE( parameter.compare( 1             , std::equal_to<>{}     ) );
+    ASSERT_FALSE( parameter.compare( std::string{} , std::not_equal_to<>{} ) );
+
+    char const * const null{ nullptr };
+    booleval::parameter const null_text{ null };
+
+    ASSERT_FALSE( null_text.is_bound() );
+    ASSERT_FALSE( null_text.compare( std::string{}, std::equal_to<>{} ) );
+}
+
+TEST( ParameterTest, Text )
+{
+    booleval::parameter const number{ "1.5" };
+    booleval::parameter const text  { "foo" };
+
+    ASSERT_TRUE ( number.is_bound() );
+    ASSERT_TRUE ( number.compare( 1.5 , std::equal_to<>{} ) );
+    ASSERT_TRUE ( number.compare( 1.5F, std::equal_to<>{} ) );
+    ASSERT_TRUE ( number.compare( 2U  , std::greater<>{}  ) );
+    ASSERT_TRUE ( number.compare( std::string{ "1.5" }, std::equal_to<>{} ) );
+    ASSERT_FALSE( number.compare( std::string{ "1.50" }, std::equal_to<>{} ) );
+
+    ASSERT_TRUE ( text.compare( std::string_view{ "foo" }, std::equal_to<>{} ) );
+    ASSERT_TRUE ( text.compare( std::string_view{ "goo" }, std::greater<>{}  ) );
+    ASSERT_FALSE( text.compare( 1                        , std::not_equal_to<>{} ) );
+}
+
+TEST( ParameterTest, Number )
+{
+    booleval::parameter const integer { 10   };
+    booleval::parameter const floating{ 0.1F };
+
+    ASSERT_TRUE ( integer.compare( 10   , std::equal_to<>{} ) );
+    ASSERT_TRUE ( integer.compare( 12.5 , std::greater<>{}  ) );
+    ASSERT_TRUE ( integer.compare( std::string{ "10.0" }, std::equal_to<>{} ) );
+    ASSERT_FALSE( integer.compare( std::string{ "foo"  }, std::not_equal_to<>{} ) );
+
+    ASSERT_TRUE ( floating.compare( 0.1F, std::equal_to<>{} ) );
+}
+
+TEST( ParameterTest, Frame )
+{
+    booleval::parameter const parameters[]{ 1, "foo" };
+    booleval::parameter_frame const frame{ parameters, 2 };
+
+    ASSERT_EQ   ( frame.size(), 2U );
+    ASSERT_TRUE ( frame[ 0 ].compare( 1, std::equal_to<>{} ) );
+    ASSERT_TRUE ( frame[ 1 ].compare( std::string_view{ "foo" }, std::equal_to<>{} ) );
+    ASSERT_FALSE( frame[ 2 ].is_bound() );
+
+    ASSERT_FALSE( booleval::parameter_frame{}[ 0 ].is_bound() );
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <booleval/schema.hpp>
+#include <booleval/rule_set.hpp>
+#include <booleval/tree/schema_visitor.hpp>
+
+namespace
+{
+
+    struct foo
+    {
+        unsigned    value_1{};
+        std::string value_2{};
+    };
+
+    constexpr char field_1[]{ "field_1" };
+    constexpr char field_2[]{ "field_2" };
+
+    using foo_schema = booleval::schema
+    <
+        foo,
+        booleval::static_field< field_1, &foo::value_1 >,
+        booleval::static_field< field_2, &foo::value_2 >
+    >;
+
+    booleval::rule_set make_rules()
+    {
+        booleval::rule_set rules;
+        rules.add( booleval::compile( "field_1 == 1"                    ) );
+        rules.add( booleval::compile( "field_2 == foo and field_1 > 1"  ) );
+        rules.add( booleval::compiled_expression{}                        );
+        rules.add( booleval::compile( "field_2 != foo or field_1 <= 2"  ) );
+        return rules;
+    }
+
+    std::vector< bool > matches( booleval::rule_set & rules, foo const & obj )
+    {
+        booleval::tree::schema_visitor< foo_schema > visitor;
+        rules.bind( visitor );
+
+        std::vector< bool > result;
+        for ( auto const & rule : rules )
+        {
+            result.push_back( visitor.matches( rule, obj ) );
+        }
+        return result;
+    }
+
+} // namespace
+
+TEST( RuleSetTest, Add )
+{
+    auto rules{ make_rules() };
+
+    ASSERT_FALSE( rules.empty() );
+    ASSERT_EQ   ( rules.size(), 4U );
+    ASSERT_EQ   ( rules[ 1 ].field( 0 ), "field_2" );
+    ASSERT_TRUE ( rules[ 2 ].empty() );
+
+    EXPECT_EQ( rules.memory_usage().total(), booleval::total_memory_usage( rules ).total() );
+
+    EXPECT_EQ( matches( rules, { 1, "foo" } ), ( std::vector< bool >{ true , false, false, true  } ) );
+    EXPECT_EQ( matches( rules, { 3, "foo" } ), ( std::vector< bool >{ false, true , false, false } ) );
+}
+
+TEST( RuleSetTest, Snapshot )
+{
+    auto const original{ make_rules() };
+    auto const bytes   { original.snapshot() };
+
+    ASSERT_TRUE( booleval::rule_set::check( std::data( bytes ), std::size( bytes ) ).success );
+
+    auto rules{ booleval::rule_set::view( std::data( bytes ), std::size( bytes ) ) };
+    ASSERT_TRUE( rules.has_value() );
+    ASSERT_EQ  ( rules->size(), original.size() );
+
+    for ( std::size_t i{ 0 }; i < rules->size(); ++i )
+    {
+        ASSERT_EQ( ( *rules )[ i ].image_size(), original[ i ].image_size() );
+        if ( original[ i ].image_size() == 0 ) { continue; }
+
+        auto const * image{ ( *rules )[ i ].image_data() };
+        EXPECT_GE( image, std::data( bytes ) );
+        EXPECT_LT( image, std::data( bytes ) + std::size( bytes ) );
+        EXPECT_EQ( std::memcmp( image, original[ i ].image_data(), original[ i ].image_size() ), 0 );
+    }
+
+    EXPECT_EQ( rules->memory_usage().strings, 0U );
+    EXPECT_EQ( matches( *rules, { 3, "foo" } ), ( std::vector< bool >{ false, true, false, false } ) );
+}
+
+TEST( RuleSetTest, CorruptedSnapshot )
+{
+    auto const bytes{ make_rules().snapshot() };
+
+    auto const check = [ &bytes ]( std::size_t const offset, std::uint64_t const value, std::size_t const size )
+    {
+        auto corrupted{ bytes };
+        std::memcpy( std::data( corrupted ) + offset, &value, size );
+        EXPECT_FALSE( booleval::rule_set::view( std::data( corrupted ), std::size( corrupted ) ).has_value() );
+        return booleval::rule_set::check( std::data( corrupted ), std::size( corrupted ) ).message;
+    };
+
+    EXPECT_EQ( booleval::rule_set::check( std::data( bytes ), std::size( bytes ) - 1 ).message, "Truncated snapshot" );
+
+    EXPECT_EQ( check(  0, 0     , 4 ), "Unknown snapshot format"      );
+    EXPECT_EQ( check(  4, 2     , 2 ), "Unsupported snapshot version" );
+    EXPECT_EQ( check( 16, 1000  , 8 ), "Truncated snapshot"           );
+    EXPECT_EQ( check( 24, 3     , 8 ), "Corrupted snapshot index"     );
+    EXPECT_EQ( check( 32, 100000, 8 ), "Corrupted snapshot index"     );
+}
+
+TEST( RuleSetTest, Map )
+{
+    auto const path{ ( std::filesystem::temp_directory_path() / "booleval_rule_set_test.snapshot" ).string() };
+
+    ASSERT_TRUE( make_rules().save( path ) );
+
+    auto rules{ booleval::rule_set::map( path ) };
+    std::remove( path.c_str() );
+
+    ASSERT_TRUE( rules.has_value() );
+    ASSERT_EQ  ( rules->size(), 4U );
+
+    auto const copy{ *rules };
+    rules.reset();
+
+    EXPECT_EQ( copy[ 1 ].constant( 0 ), "foo" );
+
+    EXPECT_FALSE( booleval::rule_set::map( path ).has_value() );
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <iterator>
+#include <gtest/gtest.h>
+#include <booleval/schema_evaluator.hpp>
+
+#include "allocation_counter.hpp"
+
+namespace
+{
+
+    template< typename T, typename U >
+    class bar
+    {
+    public:
+        bar( T && value_1, U && value_2 )
+        : value_1_{ value_1 }
+        , value_2_{ value_2 }
+        {}
+
+        T const & value_1() const noexcept { return value_1_; }
+        U const & value_2() const noexcept { return value_2_; }
+
+    private:
+        T value_1_{};
+        U value_2_{};
+    };
+
+    struct baz
+    {
+        float       value_1{};
+        std::string value_2{};
+    };
+
+    constexpr char field_1[]{ "field_1" };
+    constexpr char field_2[]{ "field_2" };
+
+    using bar_schema = booleval::schema
+    <
+        bar< std::string, unsigned >,
+        booleval::static_field< field_1, &bar< std::string, unsigned >::value_1 >,
+        booleval::static_field< field_2, &bar< std::string, unsigned >::value_2 >
+    >;
+
+    using baz_schema = booleval::schema
+    <
+        baz,
+        booleval::static_field< field_1, &baz::value_1 >,
+        booleval::static_field< field_2, &baz::value_2 >
+    >;
+
+} // namespace
+
+TEST( SchemaEvaluatorTest, DefaultConstructor )
+{
+    booleval::schema_evaluator< bar_schema > evaluator;
+
+    ASSERT_FALSE( evaluator.is_activated() );
+}
+
+TEST( SchemaEvaluatorTest, InvalidExpression )
+{
+    booleval::schema_evaluator< bar_schema > evaluator;
+
+    ASSERT_FALSE( evaluator.expression( "(field_1 foo or field_2 1" ) );
+    ASSERT_FALSE( evaluator.is_activated()                            );
+    ASSERT_FALSE( evaluator.evaluate( { "foo", 1 } ).success          );
+}
+
+TEST( SchemaEvaluatorTest, MultipleOperators )
+{
+    bar< std::string, unsigned > x{ "foo", 1 };
+    bar< std::string, unsigned > y{ "bar", 2 };
+    bar< std::string, unsigned > m{ "baz", 1 };
+    bar< std::string, unsigned > n{ "qux", 2 };
+
+    booleval::schema_evaluator< bar_schema > evaluator;
+
+    {
+        ASSERT_TRUE ( evaluator.expression( "(field_1 foo or field_1 bar) and (field_2 2 or field_2 1)" ) );
+        ASSERT_TRUE ( evaluator.is_activated()        );
+        ASSERT_TRUE ( evaluator.evaluate( x ).success );
+        ASSERT_TRUE ( evaluator.evaluate( y ).success );
+        ASSERT_FALSE( evaluator.evaluate( m ).success );
+        ASSERT_FALSE( evaluator.evaluate( n ).success );
+    }
+    {
+        ASSERT_TRUE ( evaluator.expression( "(field_1 foo and field_2 1) or (field_1 qux and field_2 2)" ) );
+        ASSERT_TRUE ( evaluator.is_activated()        );
+        ASSERT_TRUE ( evaluator.evaluate( x ).success );
+        ASSERT_FALSE( evaluator.evaluate( y ).success );
+        ASSERT_FALSE( evaluator.evaluate( m ).success );
+        ASSERT_TRUE ( evaluator.evaluate( n ).success );
+    }
+    {
+        ASSERT_TRUE ( evaluator.expression( "field_1 > bar and field_2 <= 1" ) );
+        ASSERT_TRUE ( evaluator.is_activated()        );
+        ASSERT_TRUE ( evaluator.evaluate( x ).success );
+        ASSERT_FALSE( evaluator.evaluate( y ).success );
+        ASSERT_TRUE ( evaluator.evaluate( m ).success );
+        ASSERT_FALSE( evaluator.evaluate( n ).success );
+    }
+}
+
+TEST( SchemaEvaluatorTest, DataMembers )
+{
+    baz x{ 1.22f, "foo" };
+    baz y{ 1.24f, "bar" };
+
+    booleval::schema_evaluator< baz_schema > evaluator;
+
+    {
+        ASSERT_TRUE ( evaluator.expression( "field_1 1.22" ) );
+        ASSERT_TRUE ( evaluator.evaluate( x ).success      );
+        ASSERT_FALSE( evaluator.evaluate( y ).success      );
+    }
+    {
+        ASSERT_TRUE ( evaluator.expression( "field_1 > 1.23 or field_2 == foo" ) );
+        ASSERT_TRUE ( evaluator.evaluate( x ).success                          );
+        ASSERT_TRUE ( evaluator.evaluate( y ).success                          );
+    }
+    {
+        ASSERT_TRUE ( evaluator.expression( "field_1 > one" ) );
+        ASSERT_FALSE( evaluator.evaluate( x ).success       );
+        ASSERT_FALSE( evaluator.evaluate( y ).success       );
+    }
+}
+
+TEST( SchemaEvaluatorTest, UnknownField )
+{
+    booleval::schema_evaluator< bar_schema > evaluator;
+
+    ASSERT_TRUE( evaluator.expression( "unknown_field 1" ) );
+    ASSERT_TRUE( evaluator.is_activated()                  );
+
+    auto const result{ evaluator.evaluate( { "foo", 1 } ) };
+    ASSERT_FALSE( result.success                  );
+    ASSERT_EQ   ( result.message, "Unknown field" );
+}
+
+TEST( SchemaEvaluatorTest, Matches )
+{
+    booleval::schema_evaluator< bar_schema > evaluator;
+
+    ASSERT_TRUE ( evaluator.expression( "field_1 foo or unknown_field 2" ) );
+    ASSERT_FALSE( evaluator.validation().success                           );
+    ASSERT_EQ   ( evaluator.validation().message, "Unknown field"          );
+
+    ASSERT_TRUE ( evaluator.matches( { "foo", 1 } ) );
+    ASSERT_FALSE( evaluator.matches( { "bar", 2 } ) );
+
+    ASSERT_TRUE( evaluator.expression( "field_1 foo or field_2 2" ) );
+    ASSERT_TRUE( evaluator.validation().success                     );
+    ASSERT_TRUE( evaluator.matches( { "bar", 2 } )                  );
+}
+
+TEST( SchemaEvaluatorTest, ParameterFrames )
+{
+    booleval::schema_evaluator< baz_schema > evaluator;
+
+    ASSERT_TRUE( evaluator.expression( "field_1 > $1 and field_2 != $2" ) );
+
+    ASSERT_TRUE ( evaluator.matches ( { 1.5F, "foo" }, { 1, "bar" } ) );
+    ASSERT_FALSE( evaluator.matches ( { 1.5F, "foo" }, { "1.5", "bar" } ) );
+    ASSERT_TRUE ( evaluator.evaluate( { 1.5F, "foo" }, { 1.25, "bar" } ).success );
+
+    auto const unbound{ evaluator.evaluate( { 1.5F, "foo" }, {} ) };
+    ASSERT_FALSE( unbound.success );
+    ASSERT_EQ   ( unbound.message, "Unbound parameter" );
+}
+
+TEST( SchemaEvaluatorTest, Select )
+{
+    std::vector< baz > const objects{ { 1.0F, "foo" }, { 2.0F, "bar" }, { 3.0F, "foo" }, { 4.0F, "baz" } };
+
+    booleval::schema_evaluator< baz_schema > evaluator;
+
+    ASSERT_TRUE( evaluator.expression( "field_1 > $1 and field_2 == foo or field_2 == baz" ) );
+
+    std::vector< std::size_t > selected;
+    static_cast< void >( evaluator.select( std::cbegin( objects ), std::cend( objects ), std::back_inserter( selected ), { 1.5 } ) );
+    ASSERT_EQ( selected, ( std::vector< std::size_t >{ 2, 3 } ) );
+
+    selected.clear();
+    static_cast< void >( evaluator.select( std::cbegin( objects ), std::cend( objects ), std::back_inserter( selected ), { 0.5 } ) );
+    ASSERT_EQ( selected, ( std::vector< std::size_t >{ 0, 2, 3 } ) );
+}
+
+TEST( SchemaEvaluatorTest, Limits )
+{
+    booleval::schema_evaluator< bar_schema > evaluator;
+
+    booleval::limits limits;
+    limits.max_literal_bytes = 3;
+    evaluator.limits( limits );
+
+    ASSERT_FALSE( evaluator.expression( "field_1 foo" ) );
+    ASSERT_FALSE( evaluator.is_activated()              );
+
+    evaluator.limits( booleval::limits::unlimited() );
+
+    ASSERT_TRUE( evaluator.expression( "field_1 foo" ) );
+    ASSERT_TRUE( evaluator.matches( { "foo", 1 } )     );
+}
+
+TEST( SchemaEvaluatorTest, NoAllocationsOnEvaluation )
+{
+    // strings longer than the small string buffer, so that copying them would allocate
+    bar< std::string, unsigned > const x{ "a_string_longer_than_the_small_string_buffer", 1 };
+    baz                          const y{ 1.5F, "another_string_longer_than_the_small_string_buffer" };
+
+    booleval::schema_evaluator< bar_schema > bar_evaluator;
+    booleval::schema_evaluator< baz_schema > baz_evaluator;
+
+    ASSERT_TRUE( bar_evaluator.expression( "field_1 a_string_longer_than_the_small_string_buffer and field_2 1" ) );
+    ASSERT_TRUE( baz_evaluator.expression( "field_1 > 1 and field_2 != a_string_longer_than_the_small_string_buffer" ) );
+
+    booleval::schema_evaluator< baz_schema > parameter_evaluator;
+    ASSERT_TRUE( parameter_evaluator.expression( "field_1 > $1 and field_2 != $2" ) );
+
+    booleval::testing::allocation_scope const scope;
+
+    ASSERT_TRUE( bar_evaluator.matches ( x )         );
+    ASSERT_TRUE( bar_evaluator.evaluate( x ).success );
+    ASSERT_TRUE( baz_evaluator.matches ( y )         );
+    ASSERT_TRUE( baz_evaluator.evaluate( y ).success );
+    ASSERT_TRUE( parameter_evaluator.matches( y, { 1, "a_string_longer_than_the_small_string_buffer" } ) );
+
+    EXPECT_EQ( scope.stats().allocations, 0U );
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <gtest/gtest.h>
+#include <booleval/schema.hpp>
+
+namespace
+{
+
+    struct foo
+    {
+        unsigned    value_1{};
+        std::string value_2{};
+
+        double value_3() const noexcept { return static_cast< double >( value_1 ) / 2; }
+    };
+
+    constexpr char field_1[]{ "field_1" };
+    constexpr char field_2[]{ "field_2" };
+    constexpr char field_3[]{ "field_3" };
+
+    using foo_schema = booleval::schema
+    <
+        foo,
+        booleval::static_field< field_1, &foo::value_1 >,
+        booleval::static_field< field_2, &foo::value_2 >,
+        booleval::static_field< field_3, &foo::value_3 >
+    >;
+
+    // more fields than the slots dispatched by a single switch
+    struct wide
+    {
+        int v0{ 0 }, v1{ 1 }, v2{ 2 }, v3{ 3 }, v4{ 4 }, v5{ 5 }, v6{ 6 }, v7{ 7 }, v8{ 8 }, v9{ 9 };
+    };
+
+    constexpr char v0[]{ "v0" }, v1[]{ "v1" }, v2[]{ "v2" }, v3[]{ "v3" }, v4[]{ "v4" };
+    constexpr char v5[]{ "v5" }, v6[]{ "v6" }, v7[]{ "v7" }, v8[]{ "v8" }, v9[]{ "v9" };
+
+    using wide_schema = booleval::schema
+    <
+        wide,
+        booleval::static_field< v0, &wide::v0 >, booleval::static_field< v1, &wide::v1 >,
+        booleval::static_field< v2, &wide::v2 >, booleval::static_field< v3, &wide::v3 >,
+        booleval::static_field< v4, &wide::v4 >, booleval::static_field< v5, &wide::v5 >,
+        booleval::static_field< v6, &wide::v6 >, booleval::static_field< v7, &wide::v7 >,
+        booleval::static_field< v8, &wide::v8 >, booleval::static_field< v9, &wide::v9 >
+    >;
+
+} // namespace
+
+TEST( SchemaTest, Size )
+{
+    ASSERT_EQ( foo_schema::size, 3U );
+}
+
+TEST( SchemaTest, IndexOf )
+{
+    static_assert( foo_schema::index_of( "field_1" ) == 0U );
+    static_assert( foo_schema::index_of( "field_2" ) == 1U );
+    static_assert( foo_schema::index_of( "field_3" ) == 2U );
+
+    ASSERT_FALSE( foo_schema::index_of( "field_4" ) );
+    ASSERT_FALSE( foo_schema::index_of( ""        ) );
+}
+
+TEST( SchemaTest, Visit )
+{
+    foo const x{ 3, "foo" };
+
+    ASSERT_TRUE
+    (
+        foo_schema::visit
+        (
+            0,
+            x,
+            []( auto const & value )
+            {
+                if constexpr ( std::is_same_v< std::decay_t< decltype( value ) >, unsigned > ) { return value == 3U; }
+                else                                                                          { return false;       }
+            }
+        )
+    );
+
+    ASSERT_TRUE
+    (
+        foo_schema::visit
+        (
+            1,
+            x,
+            []( auto const & value )
+            {
+                if constexpr ( std::is_same_v< std::decay_t< decltype( value ) >, std::string > ) { return value == "foo"; }
+                else                                                                             { return false;         }
+            }
+        )
+    );
+
+    ASSERT_TRUE
+    (
+        foo_schema::visit
+        (
+            2,
+            x,
+            []( auto const & value )
+            {
+                if constexpr ( std::is_same_v< std::decay_t< decltype( value ) >, double > ) { return value == 1.5; }
+                else                                                                        { return false;      }
+            }
+        )
+    );
+
+    ASSERT_FALSE( foo_schema::visit( 3, x, []( auto const & ) { return true; } ) );
+}
+
+TEST( SchemaTest, VisitWide )
+{
+    wide const x{};
+
+    for ( std::size_t slot{ 0 }; slot < wide_schema::size; ++slot )
+    {
+        ASSERT_TRUE( wide_schema::visit( slot, x, [ slot ]( int const value ) { return value == static_cast< int >( slot ); } ) ) << slot;
+    }
+
+    ASSERT_FALSE( wide_schema::visit( 10, x, []( int ) { return true; } ) );
+    ASSERT_FALSE( wide_schema::visit( 16, x, []( int ) { return true; } ) );
+    ASSERT_FALSE( wide_schema::visit( 99, x, []( int ) { return true; } ) );
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <booleval/stream/csv_filter.hpp>
+
+#include "allocation_counter.hpp"
+
+namespace
+{
+
+    constexpr std::string_view input
+    {
+        "id,level,latency,message\r\n"
+        "1,info,12.5,ok\r\n"
+        "2,error,250,\"failed, retrying\"\r\n"
+        "\r\n"
+        "3,error,7,\"multi\nline \"\"quoted\"\"\"\n"
+        "4,warning,900,slow"
+    };
+
+    std::string make_input( std::size_t const records )
+    {
+        std::string result{ "id,level,latency,message\n" };
+        for ( std::size_t i{ 0 }; i < records; ++i )
+        {
+            result += std::to_string( i ) + ( i % 3 == 0 ? ",error," : ",info," ) + std::to_string( i % 1000 ) +
+                      ( i % 7 == 0 ? ",\"line\nbreak, \"\"quoted\"\"\"\n" : ",plain\n" );
+        }
+        return result;
+    }
+
+} // namespace
+
+TEST( CsvFilterTest, Header )
+{
+    booleval::stream::csv_filter filter;
+
+    ASSERT_TRUE ( filter.expression( "level == error and latency > 100" ) );
+    ASSERT_FALSE( filter.validation().success );
+
+    ASSERT_TRUE ( filter.header( "id,level,latency" ) );
+    ASSERT_TRUE ( filter.validation().success );
+    ASSERT_EQ   ( filter.compiled().slot( 0 ), 1U );
+    ASSERT_EQ   ( filter.compiled().slot( 1 ), 2U );
+
+    ASSERT_FALSE( filter.header( "id,\"level\"" ) );
+    ASSERT_EQ   ( filter.validation().message, "Unknown field" );
+}
+
+TEST( CsvFilterTest, Matches )
+{
+    booleval::stream::csv_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error and latency > 100" ) );
+    ASSERT_TRUE( filter.header( "id,level,latency" ) );
+
+    EXPECT_TRUE ( filter.matches( "1,error,101" ) );
+    EXPECT_FALSE( filter.matches( "1,error,99"  ) );
+    EXPECT_FALSE( filter.matches( "1,info,101"  ) );
+    EXPECT_FALSE( filter.matches( "1,error"     ) );
+}
+
+TEST( CsvFilterTest, FilterView )
+{
+    booleval::stream::csv_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error or latency >= 900" ) );
+
+    std::vector< std::string_view > matches;
+    auto const stats{ filter.filter( input, [ &matches ]( std::string_view const record ) { matches.push_back( record ); } ) };
+
+    EXPECT_EQ( stats.records, 4U );
+    EXPECT_EQ( stats.matches, 3U );
+    EXPECT_EQ( stats.bytes  , std::size( input ) );
+
+    ASSERT_EQ( std::size( matches ), 3U );
+    EXPECT_EQ( matches[ 0 ], "2,error,250,\"failed, retrying\"" );
+    EXPECT_EQ( matches[ 1 ], "3,error,7,\"multi\nline \"\"quoted\"\"\"" );
+    EXPECT_EQ( matches[ 2 ], "4,warning,900,slow" );
+}
+
+TEST( CsvFilterTest, FilterStream )
+{
+    for ( std::size_t const chunk_size : { 1U, 5U, 4096U } )
+    {
+        booleval::stream::csv_filter filter;
+        ASSERT_TRUE( filter.expression( "level == error" ) );
+
+        std::istringstream stream{ std::string{ input } };
+
+        std::vector< std::string > matches;
+        auto const stats
+        {
+            filter.filter( stream, [ &matches ]( std::string_view const record ) { matches.emplace_back( record ); }, chunk_size )
+        };
+
+        EXPECT_EQ( stats.records, 4U );
+        EXPECT_EQ( stats.matches, 2U );
+        EXPECT_EQ( stats.bytes  , std::size( input ) );
+
+        ASSERT_EQ( std::size( matches ), 2U );
+        EXPECT_EQ( matches[ 1 ], "3,error,7,\"multi\nline \"\"quoted\"\"\"" );
+    }
+}
+
+TEST( CsvFilterTest, Split )
+{
+    auto const records{ make_input( 1000 ) };
+    auto const body   { std::string_view{ records }.substr( records.find( '\n' ) + 1 ) };
+
+    for ( std::size_t const count : { 1U, 2U, 3U, 8U, 64U } )
+    {
+        auto const chunks{ booleval::stream::csv_filter::split( body, count ) };
+
+        ASSERT_LE( std::size( chunks ), count );
+
+        std::size_t total{ 0 };
+        for ( auto const chunk : chunks )
+        {
+            EXPECT_EQ( std::data( chunk ), std::data( body ) + total );
+            EXPECT_EQ( chunk.back(), '\n' );
+            total += std::size( chunk );
+        }
+        EXPECT_EQ( total, std::size( body ) );
+    }
+}
+
+TEST( CsvFilterTest, FilterParallel )
+{
+    auto const records{ make_input( 10000 ) };
+
+    booleval::stream::csv_filter sequential;
+    ASSERT_TRUE( sequential.expression( "level == error and latency > 500" ) );
+
+    std::vector< std::string_view > expected;
+    auto const expected_stats{ sequential.filter( records, [ &expected ]( std::string_view const r ) { expected.push_back( r ); } ) };
+
+    for ( std::size_t const threads : { 1U, 2U, 4U } )
+    {
+        booleval::stream::csv_filter parallel;
+        ASSERT_TRUE( parallel.expression( "level == error and latency > 500" ) );
+
+        std::vector< std::string_view > matches;
+        auto const stats{ parallel.filter( records, [ &matches ]( std::string_view const r ) { matches.push_back( r ); }, threads ) };
+
+        EXPECT_EQ( stats.records, expected_stats.records );
+        EXPECT_EQ( stats.matches, expected_stats.matches );
+        EXPECT_EQ( stats.bytes  , expected_stats.bytes   );
+        EXPECT_EQ( matches, expected );
+    }
+}
+
+TEST( CsvFilterTest, Profile )
+{
+    auto const records{ make_input( 1000 ) };
+
+    booleval::stream::csv_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error and latency > 500" ) );
+
+    std::size_t expected{ 0 };
+    auto const expected_stats{ filter.filter( records, [ &expected ]( std::string_view ) { ++expected; } ) };
+
+    booleval::stream::csv_filter profiled;
+    ASSERT_TRUE( profiled.expression( "level == error and latency > 500" ) );
+
+    booleval::tree::flat_profile profile{ profiled.compiled() };
+    auto const stats{ profiled.profile( records, profile ) };
+
+    EXPECT_EQ( stats.records, expected_stats.records );
+    EXPECT_EQ( stats.matches, expected );
+
+    ASSERT_EQ( profile.size(), 3U );
+    EXPECT_EQ( profile[ 0 ].evaluations, stats.records );
+    EXPECT_EQ( profile[ 0 ].matches    , stats.matches );
+    EXPECT_EQ( profile[ 2 ].evaluations, profile[ 1 ].matches );
+}
+
+TEST( CsvFilterTest, NoAllocationsOnFiltering )
+{
+    auto const records{ make_input( 1000 ) };
+
+    booleval::stream::csv_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error and latency > 500 and message != plain" ) );
+
+    // quoted columns are unquoted into the scratch buffer, allocated once
+    ASSERT_TRUE( filter.header( "id,level,latency,message" ) );
+    ASSERT_TRUE( filter.matches( "1,error,501,\"a column longer than the small string buffer, \"\"quoted\"\"\"" ) );
+
+    booleval::testing::allocation_scope const scope;
+
+    std::size_t matches{ 0 };
+    auto const body{ std::string_view{ records }.substr( records.find( '\n' ) + 1 ) };
+    auto const stats{ filter.filter( body, [ &matches ]( std::string_view ) noexcept { ++matches; } ) };
+
+    EXPECT_GT( stats.matches, 0U );
+    EXPECT_EQ( scope.stats().allocations, 0U );
+}
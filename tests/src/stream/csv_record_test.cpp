@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <variant>
+#include <gtest/gtest.h>
+#include <booleval/stream/csv_record.hpp>
+
+TEST( CsvRecordTest, IsDecimalNumber )
+{
+    using booleval::stream::internal::is_decimal_number;
+
+    EXPECT_TRUE ( is_decimal_number( "1"       ) );
+    EXPECT_TRUE ( is_decimal_number( "-1.5"    ) );
+    EXPECT_TRUE ( is_decimal_number( "+.5e-3"  ) );
+    EXPECT_TRUE ( is_decimal_number( "2."      ) );
+
+    EXPECT_FALSE( is_decimal_number( ""        ) );
+    EXPECT_FALSE( is_decimal_number( "-"       ) );
+    EXPECT_FALSE( is_decimal_number( "."       ) );
+    EXPECT_FALSE( is_decimal_number( "1U"      ) );
+    EXPECT_FALSE( is_decimal_number( "1e"      ) );
+    EXPECT_FALSE( is_decimal_number( "1 2"     ) );
+    EXPECT_FALSE( is_decimal_number( "foo"     ) );
+}
+
+TEST( CsvRecordTest, Columns )
+{
+    booleval::stream::csv_record record;
+
+    record.reset( R"(a,"b,c",,"d ""e""",f)" "\r" );
+
+    EXPECT_EQ( record.column( 4 ), "f"         );
+    EXPECT_EQ( record.column( 0 ), "a"         );
+    EXPECT_EQ( record.column( 1 ), "b,c"       );
+    EXPECT_EQ( record.column( 2 ), ""          );
+    EXPECT_EQ( record.column( 3 ), "d \"e\""   );
+    EXPECT_EQ( record.column( 5 ), std::nullopt );
+
+    record.reset( "x\ty" );
+    EXPECT_EQ( record.column( 0 ), "x\ty" );
+
+    booleval::stream::csv_record tsv{ '\t' };
+    tsv.reset( "x\ty" );
+    EXPECT_EQ( tsv.column( 1 ), "y" );
+}
+
+TEST( CsvRecordTest, Visit )
+{
+    using value = std::variant< std::monostate, double, std::string >;
+
+    booleval::stream::csv_record record;
+    record.reserve( 3 );
+    record.reset( "12.5,foo,1U,\"a \"\"quoted\"\" column\"" );
+
+    auto const get = [ &record ]( std::uint32_t const index )
+    {
+        value result{};
+        auto const found
+        {
+            record.visit
+            (
+                index,
+                [ &result ]( auto const & v )
+                {
+                    if constexpr ( std::is_same_v< std::decay_t< decltype( v ) >, double > ) { result = v; }
+                    else { result = std::string{ v }; }
+                    return true;
+                }
+            )
+        };
+        return found ? result : value{};
+    };
+
+    EXPECT_EQ( get( 0 ), value{ 12.5  } );
+    EXPECT_EQ( get( 1 ), value{ "foo" } );
+    EXPECT_EQ( get( 2 ), value{ "1U"  } );
+    EXPECT_EQ( get( 3 ), value{}        ); // not reserved
+
+    record.reserve( 4 );
+    record.reset( "12.5,foo,1U,\"a \"\"quoted\"\" column\"" );
+    EXPECT_EQ( get( 3 ), value{ "a \"quoted\" column" } );
+    EXPECT_EQ( get( 1 ), value{ "foo" } );
+}
+
+TEST( CsvRecordTest, RecordEnd )
+{
+    using booleval::stream::csv_record;
+
+    std::string_view const input{ "a,b\n\"c\nd\",e\n\"f\"\"\ng\"\nh" };
+
+    auto const first{ csv_record::record_end( input, 0 ) };
+    EXPECT_EQ( input.substr( 0, first ), "a,b" );
+
+    auto const second{ csv_record::record_end( input, first + 1 ) };
+    EXPECT_EQ( input.substr( first + 1, second - first - 1 ), "\"c\nd\",e" );
+
+    auto const third{ csv_record::record_end( input, second + 1 ) };
+    EXPECT_EQ( input.substr( second + 1, third - second - 1 ), "\"f\"\"\ng\"" );
+
+    EXPECT_EQ( csv_record::record_end( input, third + 1 ), std::size( input ) );
+    EXPECT_EQ( csv_record::record_end( "\"unterminated\n", 0 ), 14U );
+}
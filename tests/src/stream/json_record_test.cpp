@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <variant>
+#include <gtest/gtest.h>
+#include <booleval/stream/json_record.hpp>
+
+namespace
+{
+
+    using value = std::variant< std::monostate, double, std::string >;
+
+    value get( booleval::stream::json_record & record, std::uint32_t const slot )
+    {
+        value result{};
+        auto const found
+        {
+            record.visit
+            (
+                slot,
+                [ &result ]( auto const & v )
+                {
+                    if constexpr ( std::is_same_v< std::decay_t< decltype( v ) >, double > ) { result = v; }
+                    else { result = std::string{ v }; }
+                    return true;
+                }
+            )
+        };
+        return found ? result : value{};
+    }
+
+} // namespace
+
+TEST( JsonRecordTest, Values )
+{
+    booleval::stream::json_record record{ { "a", "b", "c", "d", "e", "f" } };
+
+    record.reset( R"({ "a": 1.5, "b" : "foo", "c":true, "d": null, "e": [1, {"x": "]"}], "f": {"y": 2}})" );
+
+    EXPECT_EQ( get( record, 0 ), value{ 1.5 } );
+    EXPECT_EQ( get( record, 1 ), value{ "foo" } );
+    EXPECT_EQ( get( record, 2 ), value{ "true" } );
+    EXPECT_EQ( get( record, 3 ), value{ "null" } );
+    EXPECT_EQ( get( record, 4 ), value{ R"([1, {"x": "]"}])" } );
+    EXPECT_EQ( get( record, 5 ), value{ R"({"y": 2})" } );
+}
+
+TEST( JsonRecordTest, TopLevelMembersOnly )
+{
+    booleval::stream::json_record record{ { "x", "y" } };
+
+    record.reset( R"({"a": {"x": 1}, "b": "\"x\": 2", "y": -3})" );
+
+    EXPECT_EQ( get( record, 0 ), value{} );
+    EXPECT_EQ( get( record, 1 ), value{ -3.0 } );
+}
+
+TEST( JsonRecordTest, EscapedStrings )
+{
+    booleval::stream::json_record record{ { "a", "b", "c" } };
+
+    record.reset( R"({"a": "x\"y\\", "b": "é😀\n", "c": "\q"})" );
+
+    EXPECT_EQ( get( record, 0 ), value{ "x\"y\\" } );
+    EXPECT_EQ( get( record, 1 ), value{ "\xC3\xA9\xF0\x9F\x98\x80\n" } );
+    EXPECT_EQ( get( record, 2 ), value{} );
+}
+
+TEST( JsonRecordTest, Reset )
+{
+    booleval::stream::json_record record{ { "a" } };
+
+    record.reset( R"({"a": 1})" );
+    EXPECT_EQ( get( record, 0 ), value{ 1.0 } );
+
+    record.reset( R"({"b": 1})" );
+    EXPECT_EQ( get( record, 0 ), value{} );
+}
+
+TEST( JsonRecordTest, MalformedRecords )
+{
+    booleval::stream::json_record record{ { "a", "b" } };
+
+    for ( auto const * malformed :
+    {
+        "", "[]", "{", R"({"a")", R"({"a":)", R"({"a": "foo)", R"({"a": [1, 2)", R"({"a" 1})", "{\"a\": \"\\"
+    } )
+    {
+        record.reset( malformed );
+        EXPECT_EQ( get( record, 0 ), value{} ) << malformed;
+        EXPECT_EQ( get( record, 1 ), value{} ) << malformed;
+    }
+
+    record.reset( R"({"a": 1, "b")" );
+    EXPECT_EQ( get( record, 0 ), value{ 1.0 } );
+    EXPECT_EQ( get( record, 1 ), value{}      );
+}
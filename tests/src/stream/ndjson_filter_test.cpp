@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <booleval/stream/ndjson_filter.hpp>
+
+#include "allocation_counter.hpp"
+
+namespace
+{
+
+    constexpr std::string_view input
+    {
+        "{\"id\": 1, \"level\": \"info\" , \"latency\": 12.5}\n"
+        "{\"id\": 2, \"level\": \"error\", \"latency\": 250}\r\n"
+        "\n"
+        "{\"id\": 3, \"level\": \"error\", \"latency\": 7}\n"
+        "{\"id\": 4, \"latency\": 900}"
+    };
+
+} // namespace
+
+TEST( NdjsonFilterTest, Expression )
+{
+    booleval::stream::ndjson_filter filter;
+
+    ASSERT_FALSE( filter.is_activated() );
+    ASSERT_FALSE( filter.matches( "{}" ) );
+
+    ASSERT_FALSE( filter.expression( "level" ) );
+    ASSERT_TRUE ( filter.expression( "level == error" ) );
+    ASSERT_TRUE ( filter.is_activated() );
+}
+
+TEST( NdjsonFilterTest, Matches )
+{
+    booleval::stream::ndjson_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error and latency > 100" ) );
+
+    EXPECT_TRUE ( filter.matches( R"({"level": "error", "latency": 101})" ) );
+    EXPECT_FALSE( filter.matches( R"({"level": "error", "latency": 99})"  ) );
+    EXPECT_FALSE( filter.matches( R"({"level": "info" , "latency": 101})" ) );
+    EXPECT_FALSE( filter.matches( R"({"latency": 101})"                   ) );
+    EXPECT_FALSE( filter.matches( "not json"                              ) );
+}
+
+TEST( NdjsonFilterTest, FilterView )
+{
+    booleval::stream::ndjson_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error or latency >= 900" ) );
+
+    std::vector< std::string_view > matches;
+    auto const stats{ filter.filter( input, [ &matches ]( std::string_view const line ) { matches.push_back( line ); } ) };
+
+    EXPECT_EQ( stats.records, 4U );
+    EXPECT_EQ( stats.matches, 3U );
+    EXPECT_EQ( stats.bytes  , std::size( input ) );
+    EXPECT_DOUBLE_EQ( stats.selectivity(), 0.75 );
+
+    ASSERT_EQ( std::size( matches ), 3U );
+    EXPECT_EQ( matches[ 0 ], R"({"id": 2, "level": "error", "latency": 250})" );
+    EXPECT_EQ( matches[ 2 ], R"({"id": 4, "latency": 900})" );
+
+    // zero copy
+    EXPECT_GE( std::data( matches[ 0 ] ), std::data( input ) );
+    EXPECT_LT( std::data( matches[ 0 ] ), std::data( input ) + std::size( input ) );
+}
+
+TEST( NdjsonFilterTest, FilterStream )
+{
+    booleval::stream::ndjson_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error" ) );
+
+    for ( std::size_t const chunk_size : { 1U, 7U, 4096U } )
+    {
+        std::istringstream stream{ std::string{ input } };
+
+        std::vector< std::string > matches;
+        auto const stats
+        {
+            filter.filter( stream, [ &matches ]( std::string_view const line ) { matches.emplace_back( line ); }, chunk_size )
+        };
+
+        EXPECT_EQ( stats.records, 4U );
+        EXPECT_EQ( stats.matches, 2U );
+        EXPECT_EQ( stats.bytes  , std::size( input ) );
+
+        ASSERT_EQ( std::size( matches ), 2U );
+        EXPECT_EQ( matches[ 1 ], R"({"id": 3, "level": "error", "latency": 7})" );
+    }
+}
+
+TEST( NdjsonFilterTest, Split )
+{
+    for ( std::size_t const count : { 1U, 2U, 3U, 8U, 64U } )
+    {
+        auto const chunks{ booleval::stream::ndjson_filter::split( input, count ) };
+
+        ASSERT_LE( std::size( chunks ), count );
+
+        std::size_t total{ 0 };
+        for ( auto const chunk : chunks )
+        {
+            EXPECT_EQ( std::data( chunk ), std::data( input ) + total );
+            EXPECT_TRUE( chunk.back() == '\n' || std::data( chunk ) + std::size( chunk ) == std::data( input ) + std::size( input ) );
+            total += std::size( chunk );
+        }
+        EXPECT_EQ( total, std::size( input ) );
+    }
+}
+
+TEST( NdjsonFilterTest, FilterParallel )
+{
+    booleval::stream::ndjson_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error or latency >= 900" ) );
+
+    for ( std::size_t const threads : { 1U, 2U, 4U } )
+    {
+        std::vector< std::string_view > matches;
+        auto const stats{ filter.filter( input, [ &matches ]( std::string_view const line ) { matches.push_back( line ); }, threads ) };
+
+        EXPECT_EQ( stats.records, 4U );
+        EXPECT_EQ( stats.matches, 3U );
+        EXPECT_EQ( stats.bytes  , std::size( input ) );
+
+        ASSERT_EQ( std::size( matches ), 3U );
+        EXPECT_EQ( matches[ 0 ], R"({"id": 2, "level": "error", "latency": 250})" );
+        EXPECT_EQ( matches[ 2 ], R"({"id": 4, "latency": 900})" );
+    }
+}
+
+TEST( NdjsonFilterTest, Profile )
+{
+    booleval::stream::ndjson_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error and latency > 100" ) );
+
+    booleval::tree::flat_profile profile{ filter.compiled() };
+    auto const stats{ filter.profile( input, profile ) };
+
+    EXPECT_EQ( stats.records, 4U );
+    EXPECT_EQ( stats.matches, 1U );
+
+    ASSERT_EQ( profile.size(), 3U );
+    EXPECT_EQ( profile[ 0 ].evaluations, 4U );
+    EXPECT_EQ( profile[ 0 ].matches    , 1U );
+    EXPECT_EQ( profile[ 1 ].evaluations, 4U );
+    EXPECT_EQ( profile[ 1 ].matches    , 2U );
+    EXPECT_EQ( profile[ 2 ].evaluations, 2U );
+    EXPECT_EQ( profile[ 2 ].matches    , 1U );
+}
+
+TEST( NdjsonFilterTest, NoAllocationsOnFiltering )
+{
+    booleval::stream::ndjson_filter filter;
+    ASSERT_TRUE( filter.expression( "level == error or latency >= 900" ) );
+
+    // escaped strings are decoded into the scratch buffer, allocated once
+    ASSERT_FALSE( filter.matches( R"({"level": "a string longer than the small string buffer, \"escaped\""})" ) );
+
+    booleval::testing::allocation_scope const scope;
+
+    std::size_t matches{ 0 };
+    auto const stats{ filter.filter( input, [ &matches ]( std::string_view ) noexcept { ++matches; } ) };
+    EXPECT_FALSE( filter.matches( R"({"level": "a string longer than the small string buffer, \"escaped\""})" ) );
+
+    EXPECT_EQ( stats.matches, 3U );
+    EXPECT_EQ( scope.stats().allocations, 0U );
+}
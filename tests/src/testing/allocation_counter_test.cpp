@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <thread>
+#include <string>
+#include <vector>
+#include <memory>
+#include <gtest/gtest.h>
+
+#include "allocation_counter.hpp"
+
+TEST( AllocationCounterTest, NoAllocations )
+{
+    booleval::testing::allocation_scope const scope;
+
+    std::string const small{ "small" };
+
+    auto const stats{ scope.stats() };
+    EXPECT_EQ( stats.allocations  , 0U );
+    EXPECT_EQ( stats.deallocations, 0U );
+    EXPECT_EQ( stats.bytes        , 0U );
+    EXPECT_EQ( small, "small" );
+}
+
+TEST( AllocationCounterTest, Allocations )
+{
+    booleval::testing::allocation_scope const scope;
+
+    {
+        auto const value{ std::make_unique< std::uint64_t >( 1 ) };
+        EXPECT_EQ( scope.stats().allocations  , 1U );
+        EXPECT_EQ( scope.stats().deallocations, 0U );
+        EXPECT_EQ( scope.stats().bytes        , sizeof( std::uint64_t ) );
+    }
+
+    EXPECT_EQ( scope.stats().deallocations, 1U );
+
+    std::vector< int > values;
+    values.reserve( 100 );
+    // the pointer escapes, so that the pair of new and delete is not elided
+    int * volatile const array{ new int[ 10 ] };
+    delete[] array;
+
+    auto const stats{ scope.stats() };
+    EXPECT_EQ( stats.allocations  , 3U );
+    EXPECT_EQ( stats.deallocations, 2U );
+    EXPECT_EQ( stats.bytes        , sizeof( std::uint64_t ) + 110 * sizeof( int ) );
+}
+
+TEST( AllocationCounterTest, AlignedAllocations )
+{
+    struct alignas( 64 ) aligned { char bytes[ 64 ]; };
+
+    booleval::testing::allocation_scope const scope;
+
+    auto const value{ std::make_unique< aligned >() };
+    EXPECT_EQ( reinterpret_cast< std::uintptr_t >( value.get() ) % 64, 0U );
+    EXPECT_EQ( scope.stats().allocations, 1U );
+}
+
+TEST( AllocationCounterTest, PerThread )
+{
+    booleval::testing::allocation_scope const scope;
+
+    std::thread thread
+    {
+        []
+        {
+            booleval::testing::allocation_scope const thread_scope;
+            auto const value{ std::make_unique< int >( 1 ) };
+            EXPECT_EQ( thread_scope.stats().allocations, 1U );
+        }
+    };
+    thread.join();
+
+    // std::thread allocates its state in the calling thread, the rest is not counted here
+    auto const stats{ scope.stats() };
+    EXPECT_LE( stats.allocations, 1U );
+}
@@ -134,3 +134,41 @@ TEST( TokenizerTest, SymbolExpression )
     ASSERT_TRUE( tokens[ 12 ].is( booleval::token::token_type::field ) );
     ASSERT_EQ  ( tokens[ 12 ].value(), "baz" );
 }
+
+TEST( TokenizerTest, ParameterExpression )
+{
+    auto const tokens{ booleval::token::tokenize( "field_a > $1 and field_b $12 or field_c == \"$3\" or $0 or $x" ) };
+    ASSERT_FALSE( tokens.empty() );
+
+    ASSERT_TRUE( tokens[ 2 ].is( booleval::token::token_type::parameter ) );
+    ASSERT_EQ  ( tokens[ 2 ].value(), "$1" );
+
+    ASSERT_TRUE( tokens[ 5 ].is( booleval::token::token_type::eq        ) );
+    ASSERT_TRUE( tokens[ 6 ].is( booleval::token::token_type::parameter ) );
+    ASSERT_EQ  ( tokens[ 6 ].value(), "$12" );
+
+    // quoted placeholders and the ones not followed by a valid index are plain values
+    ASSERT_TRUE( tokens[ 10 ].is( booleval::token::token_type::field ) );
+    ASSERT_TRUE( tokens[ 12 ].is( booleval::token::token_type::field ) );
+    ASSERT_TRUE( tokens[ 14 ].is( booleval::token::token_type::field ) );
+
+    ASSERT_EQ( booleval::token::to_parameter_index( "$1"  ), 0U  );
+    ASSERT_EQ( booleval::token::to_parameter_index( "$12" ), 11U );
+}
+
+TEST( TokenizerTest, Limits )
+{
+    booleval::limits limits;
+    limits.max_tokens = 3;
+
+    ASSERT_EQ  ( std::size( booleval::token::tokenize( "field_a foo"    , limits ) ), 3U );
+    ASSERT_TRUE( booleval::token::tokenize( "field_a == foo and", limits ).empty() );
+
+    limits.max_literal_bytes = 3;
+    ASSERT_TRUE( booleval::token::tokenize( "field_a foo"        , limits ).empty() );
+    ASSERT_TRUE( booleval::token::tokenize( "foo \"foo bar\""    , limits ).empty() );
+
+    limits.max_literal_bytes = 7;
+    limits.max_length        = 10;
+    ASSERT_TRUE( booleval::token::tokenize( "field_a foo", limits ).empty() );
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <cstdint>
+#include <string_view>
+#include <gtest/gtest.h>
+
+#include <booleval/tree/tree.hpp>
+#include <booleval/tree/canonical.hpp>
+#include <booleval/tree/result_visitor.hpp>
+
+namespace
+{
+
+    std::uint64_t canonical_hash( std::string_view const expression )
+    {
+        auto const root{ booleval::tree::canonicalize( booleval::tree::build( expression ) ) };
+        return root == nullptr ? 0 : booleval::tree::hash( *root );
+    }
+
+    struct record
+    {
+        int a{};
+        int b{};
+        int c{};
+    };
+
+} // namespace
+
+TEST( CanonicalTest, Empty )
+{
+    ASSERT_EQ( booleval::tree::canonicalize( nullptr ), nullptr );
+}
+
+TEST( CanonicalTest, Spellings )
+{
+    auto const expected{ canonical_hash( "field_a == 1 and field_b != 2 or field_c > 3" ) };
+
+    EXPECT_EQ( canonical_hash( "field_a eq 1 AND field_b neq 2 OR field_c gt 3" ), expected );
+    EXPECT_EQ( canonical_hash( "field_a EQ 1 && field_b NEQ 2 || field_c GT 3" ), expected );
+    EXPECT_EQ( canonical_hash( "(field_a == 1) and (field_b != 2) or field_c > 3" ), expected );
+
+    EXPECT_EQ( canonical_hash( "field_a >= 1 and field_b <= 2" ), canonical_hash( "field_a GEQ 1 && field_b leq 2" ) );
+}
+
+TEST( CanonicalTest, ImplicitEqual )
+{
+    EXPECT_EQ( canonical_hash( "field_a 1"                ), canonical_hash( "field_a == 1" ) );
+    EXPECT_EQ( canonical_hash( "field_a \"foo bar\""      ), canonical_hash( "field_a EQ \"foo bar\"" ) );
+    EXPECT_EQ( canonical_hash( "field_a $1 and field_b 2" ), canonical_hash( "field_b == 2 and field_a eq $1" ) );
+}
+
+TEST( CanonicalTest, CommutativeOperands )
+{
+    EXPECT_EQ( canonical_hash( "field_a 1 and field_b 2" ), canonical_hash( "field_b 2 and field_a 1" ) );
+    EXPECT_EQ( canonical_hash( "field_a 1 or field_b 2"  ), canonical_hash( "field_b 2 or field_a 1"  ) );
+
+    // chains of the same operation are regrouped regardless of the parentheses
+    EXPECT_EQ
+    (
+        canonical_hash( "(field_a 1 and field_b 2) and field_c 3" ),
+        canonical_hash( "field_c 3 and (field_b 2 and field_a 1)" )
+    );
+    EXPECT_EQ
+    (
+        canonical_hash( "field_a 1 and field_b 2 or field_c 3 and field_a 4" ),
+        canonical_hash( "(field_a 4 and field_c 3) or (field_b 2 and field_a 1)" )
+    );
+}
+
+TEST( CanonicalTest, RepeatedOperands )
+{
+    EXPECT_EQ( canonical_hash( "field_a 1 and field_a == 1"             ), canonical_hash( "field_a 1" ) );
+    EXPECT_EQ( canonical_hash( "field_a 1 or field_b 2 or field_a eq 1" ), canonical_hash( "field_b 2 or field_a 1" ) );
+}
+
+TEST( CanonicalTest, DistinctExpressions )
+{
+    EXPECT_NE( canonical_hash( "field_a > 1"                         ), canonical_hash( "field_a < 1"                          ) );
+    EXPECT_NE( canonical_hash( "field_a 1"                           ), canonical_hash( "field_a 1.0"                          ) );
+    EXPECT_NE( canonical_hash( "field_a 1 and field_b 2"             ), canonical_hash( "field_a 1 or field_b 2"               ) );
+    EXPECT_NE( canonical_hash( "field_a 1 and field_b 2 or field_c 3" ), canonical_hash( "field_a 1 and (field_b 2 or field_c 3)" ) );
+    EXPECT_NE( canonical_hash( "field_a ab"                          ), canonical_hash( "field_ab a"                           ) );
+    EXPECT_NE( canonical_hash( "field_a $1"                          ), canonical_hash( "field_a \"$1\""                       ) );
+}
+
+TEST( CanonicalTest, Equal )
+{
+    auto const lhs  { booleval::tree::canonicalize( booleval::tree::build( "field_a 1 and (field_b 2 or field_c 3)" ) ) };
+    auto const rhs  { booleval::tree::canonicalize( booleval::tree::build( "(field_c == 3 || field_b == 2) && field_a == 1" ) ) };
+    auto const other{ booleval::tree::canonicalize( booleval::tree::build( "field_a 1 and (field_b 2 or field_c 4)" ) ) };
+
+    ASSERT_TRUE ( booleval::tree::equal( *lhs, *rhs   ) );
+    ASSERT_FALSE( booleval::tree::equal( *lhs, *other ) );
+}
+
+TEST( CanonicalTest, StableHash )
+{
+    // the hash is stored, e.g. as the key of the cache, so it must not change between versions
+    auto const root{ booleval::tree::build( "field_a eq 1" ) };
+    ASSERT_NE( root, nullptr );
+    ASSERT_EQ( booleval::tree::hash( *root ), 0xcff1eda0d431202eULL );
+}
+
+TEST( CanonicalTest, SameResult )
+{
+    booleval::tree::result_visitor visitor;
+    visitor.fields
+    ({
+        booleval::make_field( "field_a", &record::a ),
+        booleval::make_field( "field_b", &record::b ),
+        booleval::make_field( "field_c", &record::c )
+    });
+
+    constexpr std::string_view expression{ "(field_c > 1 or field_a == 1) and field_b 2 or field_a < 0 && field_a != -2" };
+
+    auto const original { booleval::tree::build( expression ) };
+    auto const canonical{ booleval::tree::canonicalize( booleval::tree::build( expression ) ) };
+    ASSERT_NE( original , nullptr );
+    ASSERT_NE( canonical, nullptr );
+
+    for ( int a{ -3 }; a <= 3; ++a )
+    {
+        for ( int b{ 1 }; b <= 2; ++b )
+        {
+            for ( int c{ 0 }; c <= 2; ++c )
+            {
+                record const obj{ a, b, c };
+                EXPECT_EQ( visitor.matches( *canonical, obj ), visitor.matches( *original, obj ) );
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <booleval/tree/field_memo.hpp>
+
+namespace
+{
+
+    struct counted
+    {
+        counted( int const v, int & destroyed ) : value{ v }, destroyed_{ &destroyed } {}
+        counted( counted && rhs ) noexcept : value{ rhs.value }, destroyed_{ rhs.destroyed_ } { rhs.destroyed_ = nullptr; }
+        counted( counted const & rhs ) = delete;
+        ~counted() { if ( destroyed_ != nullptr ) { ++*destroyed_; } }
+
+        int   value;
+        int * destroyed_;
+    };
+
+} // namespace
+
+TEST( FieldMemoTest, FetchOnce )
+{
+    booleval::tree::field_memo< std::string, 4 > memo;
+
+    int fetches{ 0 };
+    auto const fetch = [ &fetches ] { ++fetches; return std::string{ "a_string_longer_than_the_small_string_buffer" }; };
+    auto const is_long = []( std::string const & value ) { return std::size( value ) > 16; };
+
+    EXPECT_TRUE( memo.apply( 1, fetch, is_long ) );
+    EXPECT_TRUE( memo.apply( 1, fetch, is_long ) );
+    EXPECT_EQ  ( fetches, 1 );
+
+    EXPECT_TRUE( memo.apply( 2, fetch, is_long ) );
+    EXPECT_EQ  ( fetches, 2 );
+}
+
+TEST( FieldMemoTest, BeyondCapacity )
+{
+    booleval::tree::field_memo< int, 2 > memo;
+
+    int fetches{ 0 };
+    auto const fetch = [ &fetches ] { return ++fetches; };
+
+    // slots are keys, not positions, so the ones beyond the capacity are memoized as well
+    EXPECT_EQ( memo.apply( 70, fetch, []( int const value ) { return value == 1; } ), true );
+    EXPECT_EQ( memo.apply(  9, fetch, []( int const value ) { return value == 2; } ), true );
+    EXPECT_EQ( memo.apply( 70, fetch, []( int const value ) { return value == 1; } ), true );
+    EXPECT_EQ( fetches, 2 );
+
+    // once the memo is full, the other slots are fetched every time
+    EXPECT_EQ( memo.apply( 2, fetch, []( int const value ) { return value == 3; } ), true );
+    EXPECT_EQ( memo.apply( 2, fetch, []( int const value ) { return value == 4; } ), true );
+    EXPECT_EQ( fetches, 4 );
+}
+
+TEST( FieldMemoTest, Destruction )
+{
+    int destroyed{ 0 };
+
+    {
+        booleval::tree::field_memo< counted, 2 > memo;
+
+        auto const is_one = []( counted const & value ) { return value.value == 1; };
+        EXPECT_TRUE( memo.apply(  0, [ &destroyed ] { return counted{ 1, destroyed }; }, is_one ) );
+        EXPECT_TRUE( memo.apply( 63, [ &destroyed ] { return counted{ 1, destroyed }; }, is_one ) );
+        EXPECT_TRUE( memo.apply( 63, [ &destroyed ] { return counted{ 2, destroyed }; }, is_one ) );
+    }
+
+    EXPECT_EQ( destroyed, 2 );
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <vector>
+#include <optional>
+#include <gtest/gtest.h>
+#include <booleval/tree/flat_profile.hpp>
+
+namespace
+{
+
+    auto accessor( std::vector< int > const & values )
+    {
+        return [ &values ]( std::uint32_t const slot, auto && compare ) noexcept
+        {
+            return compare( values[ slot ] );
+        };
+    }
+
+    booleval::compiled_expression compile( std::string_view const expression )
+    {
+        auto compiled{ booleval::compile( expression ) };
+        compiled.bind
+        (
+            []( std::string_view const name ) -> std::optional< std::size_t >
+            {
+                if ( name == "field_a" ) { return 0U; }
+                if ( name == "field_b" ) { return 1U; }
+                return std::nullopt;
+            }
+        );
+        return compiled;
+    }
+
+} // namespace
+
+TEST( FlatProfileTest, DefaultConstructor )
+{
+    booleval::tree::flat_profile profile;
+    EXPECT_EQ( profile.size(), 0U );
+
+    booleval::tree::node_profile node;
+    EXPECT_EQ( node.evaluations, 0U );
+    EXPECT_DOUBLE_EQ( node.selectivity(), 0.0 );
+}
+
+TEST( FlatProfileTest, Matches )
+{
+    auto const expression{ compile( "field_a > 1 and field_b == 2" ) };
+    ASSERT_EQ( expression.size(), 3U );
+
+    booleval::tree::flat_profile profile{ expression };
+    ASSERT_EQ( profile.size(), 3U );
+
+    std::vector< std::vector< int > > const records
+    {
+        { 0, 2 },
+        { 2, 2 },
+        { 2, 3 },
+        { 3, 2 }
+    };
+
+    std::size_t matches{ 0 };
+    for ( auto const & record : records )
+    {
+        auto const expected{ booleval::tree::flat_visitor::matches( expression, 0, accessor( record ) ) };
+        auto const actual  { profile.matches( expression, 0, accessor( record ) ) };
+        EXPECT_EQ( actual, expected );
+        matches += actual ? 1 : 0;
+    }
+
+    EXPECT_EQ( profile[ 0 ].evaluations, 4U );
+    EXPECT_EQ( profile[ 0 ].matches    , matches );
+    EXPECT_EQ( profile[ 1 ].evaluations, 4U );
+    EXPECT_EQ( profile[ 1 ].matches    , 3U );
+
+    // the second operand is short-circuited whenever the first one is not satisfied
+    EXPECT_EQ( profile[ 2 ].evaluations, 3U );
+    EXPECT_EQ( profile[ 2 ].matches    , 2U );
+    EXPECT_DOUBLE_EQ( profile[ 2 ].selectivity(), 2.0 / 3.0 );
+}
+
+TEST( FlatProfileTest, Accumulate )
+{
+    auto const expression{ compile( "field_a == 1 or field_b == 1" ) };
+
+    booleval::tree::flat_profile first { expression };
+    booleval::tree::flat_profile second{ expression };
+
+    EXPECT_TRUE( first .matches( expression, 0, accessor( { 1, 0 } ) ) );
+    EXPECT_TRUE( second.matches( expression, 0, accessor( { 0, 1 } ) ) );
+
+    first += second;
+    EXPECT_EQ( first[ 0 ].evaluations, 2U );
+    EXPECT_EQ( first[ 1 ].evaluations, 2U );
+    EXPECT_EQ( first[ 2 ].evaluations, 1U );
+    EXPECT_EQ( first[ 2 ].matches    , 1U );
+
+    first.reset();
+    EXPECT_EQ( first.size(), 3U );
+    EXPECT_EQ( first[ 0 ].evaluations, 0U );
+}
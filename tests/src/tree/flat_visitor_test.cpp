@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <gtest/gtest.h>
+#include <booleval/tree/flat_visitor.hpp>
+
+namespace
+{
+
+    struct record
+    {
+        std::vector< int > values;
+        mutable std::size_t reads{ 0 };
+    };
+
+    auto accessor( record const & obj )
+    {
+        return [ &obj ]( std::uint32_t const slot, auto && compare ) noexcept
+        {
+            ++obj.reads;
+            return compare( obj.values[ slot ] );
+        };
+    }
+
+    auto accessor( std::vector< record > const & block )
+    {
+        return [ &block ]( std::uint32_t const slot, std::uint32_t const row, auto && compare ) noexcept
+        {
+            ++block[ row ].reads;
+            return compare( block[ row ].values[ slot ] );
+        };
+    }
+
+    booleval::compiled_expression compile( std::string_view const expression )
+    {
+        auto compiled{ booleval::compile( expression ) };
+        compiled.bind
+        (
+            []( std::string_view const name ) -> std::optional< std::size_t >
+            {
+                if ( name == "field_a" ) { return 0U; }
+                if ( name == "field_b" ) { return 1U; }
+                return std::nullopt;
+            }
+        );
+        return compiled;
+    }
+
+    booleval::compiled_expression compile_unknown_token()
+    {
+        using booleval::token::token_type;
+
+        booleval::tree::node root{ token_type::field };
+        root.left  = std::make_unique< booleval::tree::node >( booleval::token::token{ token_type::field, "field_a" } );
+        root.right = std::make_unique< booleval::tree::node >( booleval::token::token{ token_type::field, "1"       } );
+
+        booleval::compiled_expression compiled{ root };
+        compiled.bind( []( std::string_view ) -> std::optional< std::size_t > { return 0U; } );
+        return compiled;
+    }
+
+} // namespace
+
+TEST( FlatVisitorTest, Visit )
+{
+    using booleval::tree::flat_visitor;
+
+    record const obj{ { 1, 2 } };
+
+    EXPECT_TRUE ( flat_visitor::visit( compile( "field_a == 1"                  ), 0, accessor( obj ) ).success );
+    EXPECT_FALSE( flat_visitor::visit( compile( "field_a == 2"                  ), 0, accessor( obj ) ).success );
+    EXPECT_TRUE ( flat_visitor::visit( compile( "field_a == 1 and field_b > 1"  ), 0, accessor( obj ) ).success );
+    EXPECT_FALSE( flat_visitor::visit( compile( "field_a == 1 and field_b > 2"  ), 0, accessor( obj ) ).success );
+    EXPECT_TRUE ( flat_visitor::visit( compile( "field_a == 2 or field_b <= 2"  ), 0, accessor( obj ) ).success );
+    EXPECT_FALSE( flat_visitor::visit( compile( "field_a != 1 or field_b >= 3"  ), 0, accessor( obj ) ).success );
+}
+
+TEST( FlatVisitorTest, VisitErrors )
+{
+    using booleval::tree::flat_visitor;
+
+    record const obj{ { 1, 2 } };
+
+    auto const unknown_field{ flat_visitor::visit( compile( "field_c == 1" ), 0, accessor( obj ) ) };
+    EXPECT_FALSE( unknown_field.success );
+    EXPECT_EQ   ( unknown_field.message, "Unknown field" );
+
+    auto const unknown_token{ flat_visitor::visit( compile_unknown_token(), 0, accessor( obj ) ) };
+    EXPECT_FALSE( unknown_token.success );
+    EXPECT_EQ   ( unknown_token.message, "Unknown token type" );
+}
+
+TEST( FlatVisitorTest, Matches )
+{
+    using booleval::tree::flat_visitor;
+
+    record const obj{ { 1, 2 } };
+
+    EXPECT_TRUE ( flat_visitor::matches( compile( "field_a == 1 and field_b > 1"  ), 0, accessor( obj ) ) );
+    EXPECT_FALSE( flat_visitor::matches( compile( "field_a == 1 and field_b > 2"  ), 0, accessor( obj ) ) );
+    EXPECT_FALSE( flat_visitor::matches( compile( "field_c == 1 or field_b > 2"   ), 0, accessor( obj ) ) );
+}
+
+TEST( FlatVisitorTest, ShortCircuit )
+{
+    using booleval::tree::flat_visitor;
+
+    record const obj{ { 1, 2 } };
+
+    EXPECT_FALSE( flat_visitor::matches( compile( "field_a == 2 and field_b == 2" ), 0, accessor( obj ) ) );
+    EXPECT_EQ   ( obj.reads, 1U );
+
+    EXPECT_TRUE ( flat_visitor::matches( compile( "field_a == 1 or field_b == 2"  ), 0, accessor( obj ) ) );
+    EXPECT_EQ   ( obj.reads, 2U );
+}
+
+TEST( FlatVisitorTest, Select )
+{
+    using booleval::tree::flat_visitor;
+
+    std::vector< record > const block{ { { 1, 2 } }, { { 1, 3 } }, { { 2, 2 } }, { { 2, 3 } } };
+    booleval::parameter_frame const parameters{};
+
+    EXPECT_EQ( flat_visitor::select( compile( "field_a == 1"                 ), 0, accessor( block ), parameters, 0b1111 ), 0b0011U );
+    EXPECT_EQ( flat_visitor::select( compile( "field_a == 1"                 ), 0, accessor( block ), parameters, 0b1110 ), 0b0010U );
+    EXPECT_EQ( flat_visitor::select( compile( "field_a == 1 and field_b > 2" ), 0, accessor( block ), parameters, 0b1111 ), 0b0010U );
+    EXPECT_EQ( flat_visitor::select( compile( "field_a == 1 or field_b > 2"  ), 0, accessor( block ), parameters, 0b1111 ), 0b1011U );
+    EXPECT_EQ( flat_visitor::select( compile( "field_c == 1 or field_b > 2"  ), 0, accessor( block ), parameters, 0b1111 ), 0b1010U );
+    EXPECT_EQ( flat_visitor::select( compile( "field_a == 1"                 ), 0, accessor( block ), parameters, 0      ), 0U      );
+    EXPECT_EQ( flat_visitor::select( compile_unknown_token()                   , 0, accessor( block ), parameters, 0b1111 ), 0U      );
+}
+
+TEST( FlatVisitorTest, SelectOnlyUndecidedRows )
+{
+    using booleval::tree::flat_visitor;
+
+    std::vector< record > const block{ { { 1, 2 } }, { { 1, 3 } }, { { 2, 2 } }, { { 2, 3 } } };
+    booleval::parameter_frame const parameters{};
+
+    // the second operand of and is checked on the first two rows only
+    EXPECT_EQ( flat_visitor::select( compile( "field_a == 1 and field_b > 2" ), 0, accessor( block ), parameters, 0b1111 ), 0b0010U );
+    EXPECT_EQ( block[ 0 ].reads, 2U );
+    EXPECT_EQ( block[ 1 ].reads, 2U );
+    EXPECT_EQ( block[ 2 ].reads, 1U );
+    EXPECT_EQ( block[ 3 ].reads, 1U );
+
+    // the second operand of or is checked on the last two rows only
+    EXPECT_EQ( flat_visitor::select( compile( "field_a == 1 or field_b > 2" ), 0, accessor( block ), parameters, 0b1111 ), 0b1011U );
+    EXPECT_EQ( block[ 0 ].reads, 3U );
+    EXPECT_EQ( block[ 1 ].reads, 3U );
+    EXPECT_EQ( block[ 2 ].reads, 3U );
+    EXPECT_EQ( block[ 3 ].reads, 3U );
+}
+
+TEST( FlatVisitorTest, SelectRange )
+{
+    using booleval::tree::flat_visitor;
+
+    std::vector< record > records;
+    for ( int i{ 0 }; i < 150; ++i )
+    {
+        records.push_back( { { i % 3, i } } );
+    }
+
+    auto const expression{ compile( "field_a == 0 and field_b > 60 or field_b == 1" ) };
+
+    std::vector< std::size_t > selected( std::size( records ) );
+    auto const end
+    {
+        flat_visitor::select
+        (
+            expression,
+            std::cbegin( records ),
+            std::cend  ( records ),
+            std::begin ( selected ),
+            []( std::uint32_t const slot, record const & obj, auto && compare ) noexcept
+            {
+                return compare( obj.values[ slot ] );
+            },
+            booleval::parameter_frame{}
+        )
+    };
+    selected.erase( end, std::end( selected ) );
+
+    std::vector< std::size_t > expected;
+    for ( std::size_t i{ 0 }; i < std::size( records ); ++i )
+    {
+        if ( flat_visitor::matches( expression, 0, accessor( records[ i ] ) ) ) { expected.push_back( i ); }
+    }
+
+    EXPECT_EQ( selected, expected );
+    EXPECT_EQ( std::size( selected ), 30U );
+}
+
+TEST( FlatVisitorTest, Validate )
+{
+    using booleval::tree::flat_visitor;
+
+    EXPECT_TRUE( flat_visitor::validate( compile( "field_a == 1 and field_b > 1" ) ).success );
+
+    EXPECT_EQ( flat_visitor::validate( booleval::compiled_expression{}          ).message, "Missing operand"    );
+    EXPECT_EQ( flat_visitor::validate( compile( "field_a == 1 or field_c > 1" ) ).message, "Unknown field"      );
+    EXPECT_EQ( flat_visitor::validate( compile_unknown_token()                     ).message, "Unknown token type" );
+}
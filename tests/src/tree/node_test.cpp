@@ -67,3 +67,32 @@ TEST( NodeTest, ConstructorFromToken )
         ASSERT_EQ( node.right, nullptr );
     }
 }
+
+TEST( NodeTest, MemoryUsage )
+{
+    booleval::tree::node node{ booleval::token::token_type::eq };
+    ASSERT_EQ( booleval::tree::memory_usage( node ).total(), 0U );
+
+    node.left  = std::make_unique< booleval::tree::node >( booleval::token::token{ "foo" } );
+    node.right = std::make_unique< booleval::tree::node >( booleval::token::token{ "bar" } );
+
+    auto const usage{ booleval::tree::memory_usage( node ) };
+    ASSERT_EQ( usage.nodes  , 2 * sizeof( booleval::tree::node ) );
+    ASSERT_EQ( usage.total(), 2 * sizeof( booleval::tree::node ) );
+}
+
+TEST( NodeTest, DeepTreeDestructor )
+{
+    // destroying the nodes recursively would overflow the stack
+    auto root{ std::make_unique< booleval::tree::node >( booleval::token::token_type::logical_or ) };
+    auto * last{ root.get() };
+    for ( std::size_t i{ 0 }; i < 1000000; ++i )
+    {
+        last->left  = std::make_unique< booleval::tree::node >( booleval::token::token_type::logical_or );
+        last->right = std::make_unique< booleval::tree::node >( booleval::token::token_type::logical_and );
+        last = last->left.get();
+    }
+
+    root.reset();
+    ASSERT_EQ( root, nullptr );
+}
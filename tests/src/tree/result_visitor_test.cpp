@@ -331,3 +331,81 @@ TEST( ResultVisitorTest, UnknownTreeNode )
         ASSERT_EQ   ( result.message, "Unknown field" );
     }
 }
+
+TEST( ResultVisitorTest, Matches )
+{
+    using namespace booleval;
+
+    bar< unsigned, unsigned > x{ 1, 2 };
+    bar< unsigned, unsigned > y{ 2, 3 };
+
+    tree::result_visitor visitor;
+    visitor.fields
+    (
+        {
+            make_field( "field_1", &bar< unsigned, unsigned >::value_1 ),
+            make_field( "field_2", &bar< unsigned, unsigned >::value_2 )
+        }
+    );
+
+    auto or_op{ make_tree_node( token::token_type::logical_or ) };
+
+    or_op->left  = make_tree_node( token::token_type::eq );
+    or_op->right = make_tree_node( token::token_type::gt );
+
+    or_op->left->left  = make_tree_node( token::token_type::field, "field_1" );
+    or_op->left->right = make_tree_node( token::token_type::field, "1"       );
+
+    or_op->right->left  = make_tree_node( token::token_type::field, "unknown_field" );
+    or_op->right->right = make_tree_node( token::token_type::field, "2"             );
+
+    ASSERT_TRUE ( visitor.matches( *or_op, x ) );
+    ASSERT_FALSE( visitor.matches( *or_op, y ) );
+
+    ASSERT_EQ( visitor.matches( *or_op, x ), visitor.visit( *or_op, x ).success );
+    ASSERT_EQ( visitor.matches( *or_op, y ), visitor.visit( *or_op, y ).success );
+}
+
+TEST( ResultVisitorTest, Validate )
+{
+    using namespace booleval;
+
+    tree::result_visitor visitor;
+    visitor.fields
+    (
+        {
+            make_field( "field", &foo< unsigned >::value )
+        }
+    );
+
+    auto and_op{ make_tree_node( token::token_type::logical_and ) };
+
+    and_op->left  = make_tree_node( token::token_type::eq );
+    and_op->right = make_tree_node( token::token_type::eq );
+
+    and_op->left->left  = make_tree_node( token::token_type::field, "field" );
+    and_op->left->right = make_tree_node( token::token_type::field, "1"     );
+
+    {
+        auto const result{ visitor.validate( *and_op ) };
+        ASSERT_FALSE( result.success                    );
+        ASSERT_EQ   ( result.message, "Missing operand" );
+    }
+
+    and_op->right->left  = make_tree_node( token::token_type::field, "unknown_field" );
+    and_op->right->right = make_tree_node( token::token_type::field, "1"             );
+
+    {
+        auto const result{ visitor.validate( *and_op ) };
+        ASSERT_FALSE( result.success                  );
+        ASSERT_EQ   ( result.message, "Unknown field" );
+    }
+
+    and_op->right->left = make_tree_node( token::token_type::field, "field" );
+
+    {
+        auto const result{ visitor.validate( *and_op ) };
+        ASSERT_TRUE( result.success         );
+        ASSERT_TRUE( result.message.empty() );
+    }
+}
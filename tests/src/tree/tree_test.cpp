@@ -27,8 +27,10 @@
  *
  */
 
+#include <string>
 #include <gtest/gtest.h>
 
+#include <booleval/limits.hpp>
 #include <booleval/tree/tree.hpp>
 
 TEST( TreeTest, RelationalOperation )
@@ -69,3 +71,84 @@ TEST( TreeTest, Parentheses )
     ASSERT_NE( booleval::tree::build( "(field_a foo or field_b bar)"   ), nullptr );
     ASSERT_NE( booleval::tree::build( "( field_a foo or field_b bar )" ), nullptr );
 }
+
+TEST( TreeTest, MalformedOperand )
+{
+    ASSERT_EQ( booleval::tree::build( "( gt foo ) or field_a foo"  ), nullptr );
+    ASSERT_EQ( booleval::tree::build( "and or field_a foo"         ), nullptr );
+    ASSERT_EQ( booleval::tree::build( "field_a foo or field_b == 1 == 2" ), nullptr );
+}
+
+TEST( TreeTest, BalancedChain )
+{
+    std::string expression{ "field_a 0" };
+    for ( std::size_t i{ 1 }; i < 1024; ++i )
+    {
+        expression += " or field_a " + std::to_string( i );
+    }
+
+    auto const root{ booleval::tree::build( expression ) };
+    ASSERT_NE( root, nullptr );
+
+    // 1024 operands are joined by 10 levels of logical operations
+    std::size_t depth{ 0 };
+    for ( auto const * node{ root.get() }; node->token.is( booleval::token::token_type::logical_or ); node = node->left.get() )
+    {
+        ++depth;
+    }
+    ASSERT_EQ( depth, 10U );
+
+    // the first operand is still the leftmost one
+    auto const * leftmost{ root.get() };
+    while ( leftmost->token.is( booleval::token::token_type::logical_or ) ) { leftmost = leftmost->left.get(); }
+    ASSERT_EQ( leftmost->right->token.value(), "0" );
+}
+
+TEST( TreeTest, DepthLimit )
+{
+    booleval::limits limits;
+    limits.max_depth = 2;
+
+    ASSERT_NE( booleval::tree::build( "((field_a foo))"  , limits ), nullptr );
+    ASSERT_EQ( booleval::tree::build( "(((field_a foo)))", limits ), nullptr );
+
+    // a pathological expression is rejected by the default limits
+    auto const nested{ std::string( 100000, '(' ) + "field_a foo" + std::string( 100000, ')' ) };
+    ASSERT_EQ( booleval::tree::build( nested ), nullptr );
+}
+
+TEST( TreeTest, NodeLimit )
+{
+    booleval::limits limits;
+    limits.max_nodes = 7;
+
+    ASSERT_NE( booleval::tree::build( "field_a foo or field_b bar"               , limits ), nullptr );
+    ASSERT_EQ( booleval::tree::build( "field_a foo or field_b bar or field_c baz", limits ), nullptr );
+}
+
+TEST( TreeTest, TokenLimits )
+{
+    booleval::limits limits;
+    limits.max_tokens        = 3;
+    limits.max_literal_bytes = 7;
+
+    ASSERT_NE( booleval::tree::build( "field_a foo"        , limits ), nullptr );
+    ASSERT_EQ( booleval::tree::build( "field_ab foo"       , limits ), nullptr );
+    ASSERT_EQ( booleval::tree::build( "(field_a foo)"      , limits ), nullptr );
+
+    limits.max_length = 10;
+    ASSERT_EQ( booleval::tree::build( "field_a foo", limits ), nullptr );
+}
+
+TEST( TreeTest, UnlimitedChain )
+{
+    // a million of operands are neither joined nor destroyed recursively
+    std::string expression{ "field_a 0" };
+    for ( std::size_t i{ 1 }; i < 1000000; ++i )
+    {
+        expression += " or field_a 1";
+    }
+
+    ASSERT_EQ( booleval::tree::build( expression ), nullptr );
+    ASSERT_NE( booleval::tree::build( expression, booleval::limits::unlimited() ), nullptr );
+}
@@ -28,9 +28,11 @@
  */
 
 #include <string>
+#include <functional>
 #include <string_view>
 #include <gtest/gtest.h>
 #include <booleval/utils/any_value.hpp>
+#include <booleval/utils/compare_utils.hpp>
 
 TEST( AnyValueTest, ArithmeticValue )
 {
@@ -60,6 +62,32 @@ TEST( AnyValueTest, StringValue )
     }
 }
 
+TEST( AnyValueTest, BorrowedStringValue )
+{
+    {
+        std::string const str{ "abc" };
+        booleval::utils::any_value value{ str };
+        ASSERT_TRUE( value.is_borrowed()                           );
+        ASSERT_EQ  ( std::data( value.value() ), std::data( str ) );
+        ASSERT_EQ  ( value, "abc"                                  );
+    }
+    {
+        std::string_view const strv{ "abc" };
+        booleval::utils::any_value value{ strv };
+        ASSERT_TRUE( value.is_borrowed()                            );
+        ASSERT_EQ  ( std::data( value.value() ), std::data( strv ) );
+    }
+    {
+        booleval::utils::any_value value{ std::string{ "abc" } };
+        ASSERT_FALSE( value.is_borrowed() );
+        ASSERT_EQ   ( value, "abc"        );
+    }
+    {
+        booleval::utils::any_value value{ 1 };
+        ASSERT_FALSE( value.is_borrowed() );
+    }
+}
+
 TEST( AnyValueTest, Comparisons )
 {
     {
@@ -93,3 +121,21 @@ TEST( AnyValueTest, Comparisons )
         ASSERT_TRUE( value <= "2.345678" );
     }
 }
+
+TEST( AnyValueTest, FloatPrecision )
+{
+    // 0.1f and 0.100000001 are the same float, but not the same double
+    booleval::utils::any_value const single{ 0.1F };
+    ASSERT_TRUE ( single.is_float() );
+    ASSERT_TRUE ( single == "0.1" );
+    ASSERT_TRUE ( single == "0.100000001" );
+    ASSERT_FALSE( single <  "0.100000001" );
+
+    // the same rule as compare applies to the float itself
+    ASSERT_TRUE( booleval::utils::compare( 0.1F, "0.100000001", std::equal_to<>{} ) );
+
+    booleval::utils::any_value const dual{ 0.1 };
+    ASSERT_FALSE( dual.is_float() );
+    ASSERT_TRUE ( dual == "0.1" );
+    ASSERT_FALSE( dual == "0.100000001" );
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <functional>
+#include <string_view>
+#include <gtest/gtest.h>
+#include <booleval/utils/compare_utils.hpp>
+
+TEST( CompareUtilsTest, ArithmeticValue )
+{
+    using namespace booleval::utils;
+
+    ASSERT_TRUE ( compare( 1U   , "1"     , std::equal_to<>{} ) );
+    ASSERT_TRUE ( compare( 1    , "1.0"   , std::equal_to<>{} ) );
+    ASSERT_TRUE ( compare( 2    , "1.5"   , std::greater<>{}  ) );
+    ASSERT_TRUE ( compare( 1.22F, "1.22"  , std::equal_to<>{} ) );
+    ASSERT_TRUE ( compare( 1.22 , "1.23"  , std::less<>{}     ) );
+    ASSERT_FALSE( compare( 1    , "one"   , std::equal_to<>{} ) );
+    ASSERT_FALSE( compare( 1    , "one"   , std::not_equal_to<>{} ) );
+    ASSERT_FALSE( compare( 1.0  , "nan"   , std::not_equal_to<>{} ) );
+    ASSERT_FALSE( compare( 1.0  , "inf"   , std::less<>{}         ) );
+}
+
+TEST( CompareUtilsTest, StringValue )
+{
+    using namespace booleval::utils;
+
+    ASSERT_TRUE ( compare( std::string{ "foo" }     , "foo", std::equal_to<>{} ) );
+    ASSERT_TRUE ( compare( std::string_view{ "foo" }, "bar", std::greater<>{}  ) );
+    ASSERT_TRUE ( compare( "1000"                   , "200", std::less<>{}     ) );
+    ASSERT_FALSE( compare( std::string{ "foo" }     , "bar", std::equal_to<>{} ) );
+
+    // non-finite values are strings, as they have always been
+    ASSERT_TRUE ( compare( std::string{ "nan" }     , "nan", std::equal_to<>{}     ) );
+    ASSERT_FALSE( compare( std::string{ "nan" }     , "nan", std::not_equal_to<>{} ) );
+    ASSERT_TRUE ( compare( std::string{ "inf" }     , "nan", std::not_equal_to<>{} ) );
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <booleval/utils/mapped_file.hpp>
+
+TEST( MappedFileTest, DefaultConstructor )
+{
+    booleval::utils::mapped_file file;
+
+    ASSERT_FALSE( file.is_mapped()       );
+    ASSERT_EQ   ( file.data(), nullptr   );
+    ASSERT_EQ   ( file.size(), 0U        );
+}
+
+TEST( MappedFileTest, Map )
+{
+    auto const path{ ( std::filesystem::temp_directory_path() / "booleval_mapped_file_test.bin" ).string() };
+    std::ofstream{ path, std::ios::binary } << "booleval";
+
+    booleval::utils::mapped_file file{ path };
+    std::remove( path.c_str() );
+
+    ASSERT_TRUE( file.is_mapped() );
+    ASSERT_EQ  ( file.size(), 8U  );
+    ASSERT_EQ  ( std::string( reinterpret_cast< char const * >( file.data() ), file.size() ), "booleval" );
+
+    auto moved{ std::move( file ) };
+    ASSERT_FALSE( file.is_mapped()  );
+    ASSERT_TRUE ( moved.is_mapped() );
+}
+
+TEST( MappedFileTest, MissingFile )
+{
+    booleval::utils::mapped_file file{ "booleval_missing_file.bin" };
+
+    ASSERT_FALSE( file.is_mapped() );
+}
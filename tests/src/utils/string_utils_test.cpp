@@ -27,6 +27,9 @@
  *
  */
 
+#include <cmath>
+#include <random>
+#include <string>
 #include <gtest/gtest.h>
 #include <booleval/utils/split_options.hpp>
 #include <booleval/utils/string_utils.hpp>
@@ -198,3 +201,88 @@ TEST( StringUtilsTest, ToString )
     ASSERT_EQ( to_chars< double       >( 1.234567  ), "1.234567" );
     ASSERT_EQ( to_chars< float        >( 1.234567F ), "1.234567" );
 }
+
+TEST( StringUtilsTest, ToStringBool )
+{
+    using namespace booleval::utils;
+
+    // std::to_chars has no bool overload, booleans are rendered the way they are compared
+    ASSERT_EQ( to_chars< bool >( true  ), "1" );
+    ASSERT_EQ( to_chars< bool >( false ), "0" );
+
+    ASSERT_EQ( from_chars< double >( to_chars< bool >( true  ) ), 1.0 );
+    ASSERT_EQ( from_chars< double >( to_chars< bool >( false ) ), 0.0 );
+}
+
+TEST( StringUtilsTest, FromStringLocaleIndependent )
+{
+    using namespace booleval::utils;
+
+    ASSERT_DOUBLE_EQ( from_chars< double >( "+1.5"    ).value(), 1.5     );
+    ASSERT_DOUBLE_EQ( from_chars< double >( "-1.5e3"  ).value(), -1500.0 );
+    ASSERT_DOUBLE_EQ( from_chars< double >( "1.5U"    ).value(), 1.5     );
+    ASSERT_DOUBLE_EQ( from_chars< double >( ".5"      ).value(), 0.5     );
+    ASSERT_DOUBLE_EQ( from_chars< double >( "1e-400"  ).value_or( 0.0 ), 0.0 );
+
+    ASSERT_DOUBLE_EQ( from_chars< double >( "1,5" ).value(), 1.0 );
+    ASSERT_FALSE( from_chars< double >( "."    ) );
+    ASSERT_FALSE( from_chars< double >( "-"    ) );
+    ASSERT_FALSE( from_chars< double >( ""     ) );
+}
+
+TEST( StringUtilsTest, FromStringNonFinite )
+{
+    using namespace booleval::utils;
+
+    for ( auto const * value : { "nan", "NAN", "-nan", "inf", "-inf", "+inf", "infinity", "INFINITY" } )
+    {
+        ASSERT_FALSE( from_chars< double >( value ) ) << value;
+        ASSERT_FALSE( from_chars< float  >( value ) ) << value;
+    }
+}
+
+TEST( StringUtilsTest, FloatingPointFallback )
+{
+    using namespace booleval::utils;
+
+    auto const values =
+    {
+        "0", "1", "-1", "0.1", "1.234567", "1.23456789", "123456789012345678901234567890",
+        "0.000000000000000000001", "1e22", "1e23", "16777217", "9007199254740993", "0.30000000000000004"
+    };
+
+    for ( auto const * value : values )
+    {
+        ASSERT_EQ( internal::parse_floating_point< double >( value ), std::stod( value ) ) << value;
+        ASSERT_EQ( internal::parse_floating_point< float  >( value ), std::stof( value ) ) << value;
+    }
+
+    ASSERT_EQ( internal::parse_floating_point< double >( "-2.2250738585072014e-308" ), -2.2250738585072014e-308 );
+    ASSERT_EQ( internal::parse_floating_point< double >( "1.7976931348623157e308"   ),  1.7976931348623157e308  );
+
+    ASSERT_EQ( internal::format_floating_point< double >( 1.234567  ), "1.234567" );
+    ASSERT_EQ( internal::format_floating_point< float  >( 1.234567F ), "1.234567" );
+    ASSERT_EQ( internal::format_floating_point< double >( 0.1 + 0.2 ), "0.30000000000000004" );
+}
+
+TEST( StringUtilsTest, FloatingPointRoundTrip )
+{
+    using namespace booleval::utils;
+
+    std::mt19937_64 generator{ 42 };
+    std::uniform_real_distribution< double > mantissa{ -1.0, 1.0 };
+    std::uniform_int_distribution < int    > exponent{ -300, 300 };
+
+    for ( auto i{ 0 }; i < 10000; ++i )
+    {
+        auto const value{ std::ldexp( mantissa( generator ), exponent( generator ) ) };
+
+        ASSERT_EQ( from_chars< double >( to_chars< double >( value ) ).value(), value );
+        ASSERT_EQ( internal::parse_floating_point< double >( internal::format_floating_point< double >( value ) ).value(), value );
+
+        auto const float_value{ static_cast< float >( mantissa( generator ) * 1e6 ) };
+
+        ASSERT_EQ( from_chars< float >( to_chars< float >( float_value ) ).value(), float_value );
+        ASSERT_EQ( internal::parse_floating_point< float >( internal::format_floating_point< float >( float_value ) ).value(), float_value );
+    }
+}
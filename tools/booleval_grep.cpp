@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2021, Marin Peko
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * booleval-grep filters CSV, TSV or newline-delimited JSON input by the
+ * expression and writes the matching records to the standard output:
+ *
+ *     booleval-grep [options] <expression> [file]
+ *
+ * With --bench, nothing but the filtering statistics and the per-node profile
+ * of the expression is written, which makes it the tool for reproducing the
+ * filtering performance of the production input offline.
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <iostream>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+
+#include <booleval/compiled_expression.hpp>
+#include <booleval/stream/csv_filter.hpp>
+#include <booleval/stream/ndjson_filter.hpp>
+#include <booleval/token/token_type_utils.hpp>
+#include <booleval/tree/flat_profile.hpp>
+#include <booleval/utils/mapped_file.hpp>
+
+namespace
+{
+
+    enum class input_format
+    {
+        unknown,
+        csv,
+        tsv,
+        ndjson
+    };
+
+    struct cli_options
+    {
+        std::string                expression{};
+        std::string                path      {};
+        std::vector< std::string > parameters{};
+        input_format               format    { input_format::unknown };
+        std::size_t                threads   { 1 };
+        bool                       bench     { false };
+    };
+
+    constexpr int exit_match   { 0 };
+    constexpr int exit_no_match{ 1 };
+    constexpr int exit_error   { 2 };
+
+    void usage( std::ostream & out )
+    {
+        out << "Usage: booleval-grep [options] <expression> [file]\n"
+               "\n"
+               "Writes the records of the file (or the standard input) satisfying the expression.\n"
+               "\n"
+               "Options:\n"
+               "  --format <csv|tsv|ndjson>  input format, by default deduced from the file extension\n"
+               "  --threads <N>              number of filtering threads, 1 by default\n"
+               "  --param <value>            value of the next parameter placeholder, $1 first\n"
+               "  --bench                    report the filtering performance instead of the records\n"
+               "  --help                     show this message\n";
+    }
+
+    [[ nodiscard ]] input_format to_format( std::string_view const name ) noexcept
+    {
+        if ( name == "csv"                                       ) { return input_format::csv;    }
+        if ( name == "tsv"                                       ) { return input_format::tsv;    }
+        if ( name == "ndjson" || name == "jsonl" || name == "json" ) { return input_format::ndjson; }
+        return input_format::unknown;
+    }
+
+    [[ nodiscard ]] input_format deduce_format( std::string_view const path ) noexcept
+    {
+        auto const dot{ path.rfind( '.' ) };
+        return dot == std::string_view::npos ? input_format::unknown : to_format( path.substr( dot + 1 ) );
+    }
+
+    [[ nodiscard ]] std::optional< cli_options > parse_options( int const argc, char const * const * const argv )
+    {
+        cli_options result{};
+        std::vector< std::string_view > positional;
+
+        for ( int i{ 1 }; i < argc; ++i )
+        {
+            std::string_view const arg{ argv[ i ] };
+            auto const has_value{ i + 1 < argc };
+
+            if ( arg == "--help" || arg == "-h" )
+            {
+                usage( std::cout );
+                std::exit( exit_match );
+            }
+            else if ( arg == "--bench" )
+            {
+                result.bench = true;
+            }
+            else if ( arg == "--format" && has_value )
+            {
+                result.format = to_format( argv[ ++i ] );
+                if ( result.format == input_format::unknown )
+                {
+                    std::cerr << "booleval-grep: unknown format " << argv[ i ] << std::endl;
+                    return std::nullopt;
+                }
+            }
+            else if ( arg == "--threads" && has_value )
+            {
+                auto const threads{ std::strtol( argv[ ++i ], nullptr, 10 ) };
+                if ( threads < 1 )
+                {
+                    std::cerr << "booleval-grep: invalid number of threads " << argv[ i ] << std::endl;
+                    return std::nullopt;
+                }
+                result.threads = static_cast< std::size_t >( threads );
+            }
+            else if ( arg == "--param" && has_value )
+            {
+                result.parameters.emplace_back( argv[ ++i ] );
+            }
+            else if ( arg.size() > 1 && arg.front() == '-' )
+            {
+                std::cerr << "booleval-grep: invalid option " << arg << std::endl;
+                return std::nullopt;
+            }
+            else
+            {
+                positional.push_back( arg );
+            }
+        }
+
+        if ( positional.empty() || std::size( positional ) > 2 )
+        {
+            usage( std::cerr );
+            return std::nullopt;
+        }
+
+        result.expression = positional[ 0 ];
+        result.path       = std::size( positional ) == 2 ? positional[ 1 ] : "-";
+
+        if ( result.format == input_format::unknown )
+        {
+            result.format = deduce_format( result.path );
+        }
+        if ( result.format == input_format::unknown )
+        {
+            std::cerr << "booleval-grep: input format not known, use --format" << std::endl;
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+    /**
+     * Reads the input to be filtered, either by mapping the file into memory
+     * or by reading the whole standard input.
+     */
+    class input
+    {
+    public:
+        [[ nodiscard ]] bool open( std::string const & path )
+        {
+            if ( path == "-" )
+            {
+                buffer_.assign( std::istreambuf_iterator< char >{ std::cin }, std::istreambuf_iterator< char >{} );
+                return true;
+            }
+
+            if ( !std::ifstream{ path } ) { return false; }
+
+            file_ = booleval::utils::mapped_file{ path };
+            return true;
+        }
+
+        [[ nodiscard ]] std::string_view contents() const noexcept
+        {
+            if ( file_.size() == 0 ) { return buffer_; }
+            return { reinterpret_cast< char const * >( file_.data() ), file_.size() };
+        }
+
+    private:
+        booleval::utils::mapped_file file_  {};
+        std::string                  buffer_{};
+    };
+
+    /**
+     * Describes the node of the compiled expression, e.g. "and" or "field_a > 1".
+     */
+    [[ nodiscard ]] std::string describe( booleval::compiled_expression const & expression, std::uint32_t const index )
+    {
+        auto const & node{ expression.node( index ) };
+        auto const   keyword{ booleval::token::to_token_keyword( node.type ) };
+
+        switch ( node.type )
+        {
+            case booleval::token::token_type::logical_and:
+            case booleval::token::token_type::logical_or :
+                return std::string{ keyword };
+
+            default:
+                break;
+        }
+
+        auto const operand
+        {
+            booleval::compiled_expression::is_parameter( node.right )
+                ? booleval::token::parameter_symbol + std::to_string( booleval::compiled_expression::parameter_index( node.right ) + 1 )
+                : std::string{ expression.constant( node.right ) }
+        };
+
+        return std::string{ expression.field( node.left ) } + " " + std::string{ keyword } + " " + operand;
+    }
+
+    void print_profile
+    (
+        booleval::compiled_expression const & expression,
+        booleval::tree::flat_profile  const & profile,
+        std::uint32_t                 const   index,
+        std::size_t                   const   depth
+    )
+    {
+        auto const & node{ profile[ index ] };
+
+        std::cout << std::setw( 6 ) << index << "  "
+                  << std::setw( 12 ) << node.evaluations << "  "
+                  << std::setw( 12 ) << node.matches << "  "
+                  << std::setw( 10 ) << std::fixed << std::setprecision( 4 ) << node.selectivity() << "  "
+                  << std::string( depth * 2, ' ' ) << describe( expression, index ) << '\n';
+
+        auto const & flat{ expression.node( index ) };
+        if ( flat.type == booleval::token::token_type::logical_and ||
+             flat.type == booleval::token::token_type::logical_or )
+        {
+            print_profile( expression, profile, flat.left , depth + 1 );
+            print_profile( expression, profile, flat.right, depth + 1 );
+        }
+    }
+
+    /**
+     * Filters the input, timing the filtering, and then profiles the evaluation
+     * of the expression nodes in a separate single-threaded pass.
+     */
+    template< typename Filter >
+    int bench( Filter filter, std::string_view const contents, std::size_t const threads )
+    {
+        auto profiler{ filter };
+
+        auto const start{ std::chrono::steady_clock::now() };
+        auto const stats{ filter.filter( contents, []( std::string_view ) noexcept {}, threads ) };
+        auto const stop { std::chrono::steady_clock::now() };
+
+        auto const seconds{ std::chrono::duration< double >( stop - start ).count() };
+        auto const rate   { [ seconds ]( std::uint64_t const count ) { return seconds > 0 ? static_cast< double >( count ) / seconds : 0.0; } };
+
+        std::cout << std::fixed << std::setprecision( 3 )
+                  << "threads      " << threads                              << '\n'
+                  << "records      " << stats.records                        << '\n'
+                  << "matches      " << stats.matches                        << '\n'
+                  << "bytes        " << stats.bytes                          << '\n'
+                  << "time         " << seconds                              << " s\n"
+                  << "records/sec  " << rate( stats.records )                << '\n'
+                  << "bytes/sec    " << rate( stats.bytes )                  << '\n'
+                  << "selectivity  " << stats.selectivity()                  << "\n\n";
+
+        booleval::tree::flat_profile profile{ profiler.compiled() };
+        static_cast< void >( profiler.profile( contents, profile ) );
+
+        std::cout << std::setw( 6 ) << "node" << "  "
+                  << std::setw( 12 ) << "evaluations" << "  "
+                  << std::setw( 12 ) << "matches" << "  "
+                  << std::setw( 10 ) << "selectivity" << "  "
+                  << "expression\n";
+
+        print_profile( profiler.compiled(), profile, 0, 0 );
+
+        return stats.matches > 0 ? exit_match : exit_no_match;
+    }
+
+    template< typename Filter >
+    int grep( Filter & filter, std::string_view const contents, std::size_t const threads )
+    {
+        auto const stats
+        {
+            filter.filter
+            (
+                contents,
+                []( std::string_view const record )
+                {
+                    std::cout.write( std::data( record ), static_cast< std::streamsize >( std::size( record ) ) );
+                    std::cout.put( '\n' );
+                },
+                threads
+            )
+        };
+
+        std::cout.flush();
+        return stats.matches > 0 ? exit_match : exit_no_match;
+    }
+
+    [[ nodiscard ]] booleval::compiled_expression compile( cli_options const & options )
+    {
+        auto expression{ booleval::compile( options.expression ) };
+        expression.bind_parameters( options.parameters );
+        return expression;
+    }
+
+    [[ nodiscard ]] bool parameters_bound( booleval::compiled_expression const & expression, cli_options const & options )
+    {
+        if ( expression.parameter_count() <= std::size( options.parameters ) ) { return true; }
+
+        std::cerr << "booleval-grep: missing value of parameter $" << std::size( options.parameters ) + 1 << ", use --param" << std::endl;
+        return false;
+    }
+
+    int run_ndjson( cli_options const & options, std::string_view const contents )
+    {
+        booleval::stream::ndjson_filter filter;
+        if ( !filter.expression( compile( options ) ) )
+        {
+            std::cerr << "booleval-grep: invalid expression" << std::endl;
+            return exit_error;
+        }
+        if ( !parameters_bound( filter.compiled(), options ) )
+        {
+            return exit_error;
+        }
+
+        return options.bench ? bench( filter, contents, options.threads ) : grep( filter, contents, options.threads );
+    }
+
+    int run_csv( cli_options const & options, std::string_view contents )
+    {
+        booleval::stream::csv_filter filter{ options.format == input_format::tsv ? '\t' : ',' };
+        if ( !filter.expression( compile( options ) ) )
+        {
+            std::cerr << "booleval-grep: invalid expression" << std::endl;
+            return exit_error;
+        }
+        if ( !parameters_bound( filter.compiled(), options ) )
+        {
+            return exit_error;
+        }
+
+        // the header is read here, so that it can be written before the matching records
+        auto const end   { booleval::stream::csv_record::record_end( contents, 0 ) };
+        auto       header{ contents.substr( 0, end ) };
+        contents.remove_prefix( std::min( end + 1, std::size( contents ) ) );
+        if ( !header.empty() && header.back() == '\r' ) { header.remove_suffix( 1 ); }
+
+        if ( !filter.header( header ) )
+        {
+            std::cerr << "booleval-grep: " << filter.validation().message << std::endl;
+            return exit_error;
+        }
+
+        if ( options.bench )
+        {
+            return bench( filter, contents, options.threads );
+        }
+
+        std::cout.write( std::data( header ), static_cast< std::streamsize >( std::size( header ) ) );
+        std::cout.put( '\n' );
+
+        return grep( filter, contents, options.threads );
+    }
+
+} // namespace
+
+int main( int argc, char * argv[] )
+{
+    std::ios::sync_with_stdio( false );
+
+    auto const options{ parse_options( argc, argv ) };
+    if ( !options )
+    {
+        return exit_error;
+    }
+
+    input in;
+    if ( !in.open( options->path ) )
+    {
+        std::cerr << "booleval-grep: cannot open " << options->path << std::endl;
+        return exit_error;
+    }
+
+    switch ( options->format )
+    {
+        case input_format::ndjson: return run_ndjson( *options, in.contents() );
+        case input_format::csv   :
+        case input_format::tsv   : return run_csv   ( *options, in.contents() );
+
+        default:
+            return exit_error;
+    }
+}
@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021, Marin Peko
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+# * Redistributions of source code must retain the above copyright
+#   notice, this list of conditions and the following disclaimer.
+#
+# * Redistributions in binary form must reproduce the above
+#   copyright notice, this list of conditions and the following disclaimer
+#   in the documentation and/or other materials provided with the
+#   distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+"""
+Compares the benchmark results of two git revisions and fails if any of the
+benchmarks regresses significantly.
+
+Each revision is checked out into its own git worktree, built and its
+benchmark binary run alternately with the other one, pinned to a single CPU,
+for the given number of rounds and repetitions. The samples of each benchmark
+are compared by the Mann-Whitney U test, and a benchmark regresses if the
+difference is statistically significant and the median time grows by more
+than the threshold:
+
+    tools/compare_benchmarks.py revisions v1.1 HEAD --cpu 2 --threshold 5
+
+Results exported as JSON (--benchmark_out=<file> --benchmark_out_format=json)
+can be compared directly as well:
+
+    tools/compare_benchmarks.py files base.json head.json
+
+Exit status is 0 if nothing regresses, 1 if anything does and 2 on error.
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+
+def mann_whitney_u(x, y):
+    """
+    Two-sided Mann-Whitney U test by the normal approximation, corrected for
+    ties and continuity. It is accurate enough from about 8 samples per side.
+
+    Returns the U statistic of x and the p-value.
+    """
+    n1, n2 = len(x), len(y)
+    if n1 == 0 or n2 == 0:
+        return 0.0, 1.0
+
+    values = sorted([(v, 0) for v in x] + [(v, 1) for v in y])
+    ranks = [0.0] * len(values)
+    ties = 0.0
+
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        # tied values share the average rank
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1.0
+        count = j - i + 1
+        ties += count ** 3 - count
+        i = j + 1
+
+    rank_sum = sum(r for r, (_, side) in zip(ranks, values) if side == 0)
+    u = rank_sum - n1 * (n1 + 1) / 2.0
+
+    n = n1 + n2
+    mean = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)))
+    if variance <= 0:
+        return u, 1.0
+
+    z = (abs(u - mean) - 0.5) / math.sqrt(variance)
+    return u, min(1.0, math.erfc(max(z, 0.0) / math.sqrt(2.0)))
+
+
+def median(values):
+    ordered = sorted(values)
+    middle = len(ordered) // 2
+    if len(ordered) % 2 == 1:
+        return ordered[middle]
+    return (ordered[middle - 1] + ordered[middle]) / 2.0
+
+
+def load_samples(path, metric, samples=None):
+    """
+    Collects the samples of each benchmark from the JSON results, leaving out
+    the aggregates (mean, median, ...) computed by the benchmark library.
+    """
+    samples = {} if samples is None else samples
+    with open(path) as f:
+        results = json.load(f)
+    for benchmark in results.get('benchmarks', []):
+        if benchmark.get('run_type', 'iteration') != 'iteration' or benchmark.get('error_occurred'):
+            continue
+        name = benchmark.get('run_name', benchmark['name'])
+        samples.setdefault(name, []).append(float(benchmark[metric]))
+    return samples
+
+
+def compare(base, head, threshold, alpha, gate):
+    """
+    Compares the samples of the benchmarks found in both results and prints
+    the report. Returns True if any of the gated benchmarks regresses.
+    """
+    names = [name for name in base if name in head]
+    if not names:
+        print('No common benchmarks to compare', file=sys.stderr)
+        return False
+
+    width = max(len(name) for name in names)
+    print('{:<{w}}  {:>12}  {:>12}  {:>8}  {:>8}  {}'.format(
+        'Benchmark', 'Base', 'Head', 'Delta', 'p-value', 'Verdict', w=width))
+
+    regressed = False
+    for name in names:
+        base_median = median(base[name])
+        head_median = median(head[name])
+        delta = (head_median / base_median - 1.0) * 100.0 if base_median > 0 else 0.0
+        _, p = mann_whitney_u(base[name], head[name])
+
+        verdict = ''
+        if p < alpha:
+            if delta > threshold:
+                verdict = 'REGRESSION' if gate.search(name) else 'slower'
+                regressed = regressed or verdict == 'REGRESSION'
+            elif delta < -threshold:
+                verdict = 'faster'
+
+        print('{:<{w}}  {:>12.2f}  {:>12.2f}  {:>+7.2f}%  {:>8.4f}  {}'.format(
+            name, base_median, head_median, delta, p, verdict, w=width))
+
+    return regressed
+
+
+def run(command, **kwargs):
+    # the output of the commands is kept apart from the report
+    kwargs.setdefault('stdout', sys.stderr)
+    print('+ ' + ' '.join(command), file=sys.stderr)
+    subprocess.run(command, check=True, **kwargs)
+
+
+def build(source, revision, directory, target, cmake_args):
+    """
+    Checks the revision out into its own worktree and builds the benchmark binary.
+    """
+    worktree = os.path.join(directory, 'worktree')
+    run(['git', '-C', source, 'worktree', 'add', '--detach', worktree, revision])
+
+    # the benchmark library of the current checkout is reused, if already fetched
+    googlebench = os.path.join(source, 'googlebench')
+    if os.path.isfile(os.path.join(googlebench, 'CMakeLists.txt')):
+        shutil.rmtree(os.path.join(worktree, 'googlebench'), ignore_errors=True)
+        os.symlink(googlebench, os.path.join(worktree, 'googlebench'))
+    else:
+        run(['git', '-C', worktree, 'submodule', 'update', '--init', '--recursive', 'googlebench'])
+
+    build_directory = os.path.join(directory, 'build')
+    run(['cmake', '-S', worktree, '-B', build_directory,
+         '-DCMAKE_BUILD_TYPE=Release',
+         '-DBOOLEVAL_BUILD_BENCHMARK=ON',
+         '-DBOOLEVAL_BUILD_TESTS=OFF',
+         '-DBOOLEVAL_BUILD_EXAMPLES=OFF',
+         '-DBOOLEVAL_BUILD_TOOLS=OFF'] + cmake_args)
+    run(['cmake', '--build', build_directory, '--target', target, '-j', str(os.cpu_count() or 1)])
+
+    for root, _, files in os.walk(build_directory):
+        if target in files:
+            return os.path.join(root, target)
+    raise RuntimeError('benchmark binary {} not found for {}'.format(target, revision))
+
+
+def pin(cpu):
+    """
+    Makes the child process run on the given CPU only, if supported.
+    """
+    if cpu is None:
+        return None
+    if not hasattr(os, 'sched_setaffinity'):
+        print('CPU pinning is not supported on this platform', file=sys.stderr)
+        return None
+    return lambda: os.sched_setaffinity(0, {cpu})
+
+
+def compare_revisions(args):
+    source = subprocess.run(['git', 'rev-parse', '--show-toplevel'],
+                            check=True, capture_output=True, text=True).stdout.strip()
+
+    directory = tempfile.mkdtemp(prefix='booleval-compare-')
+    worktrees = []
+    try:
+        binaries = {}
+        for side, revision in (('base', args.base), ('head', args.head)):
+            side_directory = os.path.join(directory, side)
+            worktrees.append(os.path.join(side_directory, 'worktree'))
+            binaries[side] = build(source, revision, side_directory, args.target, args.cmake_arg)
+
+        samples = {'base': {}, 'head': {}}
+        for round_index in range(args.rounds):
+            # the revisions are run alternately, so that a drift of the machine affects both the same way
+            for side in ('base', 'head'):
+                output = os.path.join(directory, '{}-{}.json'.format(side, round_index))
+                command = [binaries[side],
+                           '--benchmark_repetitions={}'.format(args.repetitions),
+                           '--benchmark_out={}'.format(output),
+                           '--benchmark_out_format=json']
+                if args.filter:
+                    command.append('--benchmark_filter={}'.format(args.filter))
+                run(command, preexec_fn=pin(args.cpu), stdout=subprocess.DEVNULL)
+                load_samples(output, args.metric, samples[side])
+
+        return compare(samples['base'], samples['head'], args.threshold, args.alpha, re.compile(args.gate))
+    finally:
+        for worktree in worktrees:
+            if os.path.isdir(worktree):
+                subprocess.run(['git', '-C', source, 'worktree', 'remove', '--force', worktree])
+        shutil.rmtree(directory, ignore_errors=True)
+
+
+def compare_files(args):
+    return compare(load_samples(args.base, args.metric), load_samples(args.head, args.metric),
+                   args.threshold, args.alpha, re.compile(args.gate))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__.strip().splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='regression threshold of the median time, in percent (default: 5)')
+    parser.add_argument('--alpha', type=float, default=0.05,
+                        help='significance level of the Mann-Whitney U test (default: 0.05)')
+    parser.add_argument('--metric', choices=('cpu_time', 'real_time'), default='cpu_time',
+                        help='time compared (default: cpu_time)')
+    parser.add_argument('--gate', default='.',
+                        help='regex of the benchmarks failing the comparison on regression (default: all)')
+
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    revisions = commands.add_parser('revisions', help='build and compare two git revisions')
+    revisions.add_argument('base', help='base revision, e.g. the last release')
+    revisions.add_argument('head', help='revision to be compared to the base one')
+    revisions.add_argument('--target', default='booleval_benchmark',
+                           help='benchmark binary (default: booleval_benchmark)')
+    revisions.add_argument('--filter', help='regex of the benchmarks to run')
+    revisions.add_argument('--repetitions', type=int, default=10,
+                           help='repetitions of each benchmark per round (default: 10)')
+    revisions.add_argument('--rounds', type=int, default=2,
+                           help='rounds of running the revisions alternately (default: 2)')
+    revisions.add_argument('--cpu', type=int, help='CPU the benchmarks are pinned to')
+    revisions.add_argument('--cmake-arg', action='append', default=[],
+                           help='additional CMake argument, may be repeated')
+
+    files = commands.add_parser('files', help='compare two exported JSON results')
+    files.add_argument('base', help='JSON results of the base revision')
+    files.add_argument('head', help='JSON results of the revision to be compared')
+
+    args = parser.parse_args()
+
+    try:
+        regressed = compare_revisions(args) if args.command == 'revisions' else compare_files(args)
+    except (OSError, ValueError, RuntimeError, subprocess.CalledProcessError) as error:
+        print('compare_benchmarks: {}'.format(error), file=sys.stderr)
+        return 2
+
+    return 1 if regressed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())